@@ -61,6 +61,7 @@
 #include <InterruptSensor.h> //Generic Interrupt "Sensor" Class, waits for change of state on digital input 
 #include <PollingSensor.h>   //Generic Polling "Sensor" Class, polls Arduino pins periodically
 #include <Everything.h>      //Master Brain of ST_Anything library that ties everything together and performs ST Shield communications
+#include <Registry.h>        //Optional - compile-time list of the devices, sized exactly (see setup())
 
 #include <PS_Illuminance.h>  //Implements a Polling Sensor (PS) to measure light levels via a photo resistor on an analog input pin 
 #include <PS_Voltage.h>      //Implements a Polling Sensor (PS) to measure voltage on an analog input pin 
@@ -266,6 +267,16 @@ void setup()
     //DHCP IP Assigment - Must set your router's DHCP server to provice a static IP address for this device's MAC address
     //st::Everything::SmartThing = new st::SmartThingsEthernetW5x00(mac, serverPort, hubIp, hubPort, st::receiveSmartString);
 
+  //Optional - retry messages that could not be sent to the hub (the buffer costs its size in SRAM)
+  //static byte retryBuffer[128];
+  //((st::SmartThingsEthernetW5x00*)st::Everything::SmartThing)->setRetryQueue(retryBuffer, sizeof(retryBuffer));
+
+  //Optional - instead of st::Everything::init() and the addSensor()/addExecutor() calls below, an st::Registry holds
+  //storage for exactly these devices, rather than Constants.h's 10 + 10 (saves about 56 bytes of SRAM on an UNO)
+  //static st::Registry<st::IS_Contact, st::IS_Contact, st::S_TimedRelay, st::S_TimedRelay, st::EX_Switch, st::EX_Switch>
+  //  registry(sensor11, sensor12, sensor21, sensor22, executor1, executor2);
+  //registry.init();
+
   //Run the Everything class' init() routine which establishes Ethernet communications with the SmartThings Hub
   st::Everything::init();
   
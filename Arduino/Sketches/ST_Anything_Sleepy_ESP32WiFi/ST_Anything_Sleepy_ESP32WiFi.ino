@@ -21,6 +21,7 @@
 //    2018-02-09  Dan Ogorchock  Added support for Hubitat Elevation Hub
 //    2020-08-06  Allan (vseven) Added support for BlueTooth logging
 //    2020-08-10  Allan (vseven) Added support for deep sleep on the ESP32
+//    2026-10-16  a00889920      Enabled fast reconnect after deep sleep, sleep through st::Everything::deepSleep() so RunTime is reported
 //
 //   Special thanks to Joshua Spain for his contributions in porting ST_Anything to the ESP32!
 //
@@ -235,6 +236,9 @@ void setup()
     //DHCP IP Assigment - Must set your router's DHCP server to provice a static IP address for this device's MAC address
     //st::Everything::SmartThing = new st::SmartThingsESP32WiFi(str_ssid, str_password, serverPort, hubIp, hubPort, st::receiveSmartString);
 
+  //Rejoin the same access point (and with DHCP, reuse the same address) after deep sleep, without scanning
+  static_cast<st::SmartThingsESP32WiFi*>(st::Everything::SmartThing)->setFastReconnect(true);
+
   //Run the Everything class' init() routine which establishes WiFi communications with SmartThings Hub
   st::Everything::init();
   
@@ -293,7 +297,7 @@ void loop()
   Serial.println("Going to sleep now");
   delay(1000);
   Serial.flush(); 
-  esp_deep_sleep_start();
+  st::Everything::deepSleep(TIME_TO_SLEEP * uS_TO_S_FACTOR);  //reports RunTime and WakeToSend, then sleeps
 }
 
 // Callback routine for BlueTooth.  Uncomment to enable
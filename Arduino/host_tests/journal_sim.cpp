@@ -0,0 +1,555 @@
+//******************************************************************************************
+//  File: journal_sim.cpp
+//
+//  Summary:  Simulates the event journal on the host.
+//
+//			  flash:  st::FlashJournal on an in-memory fs::FS - event order across segment
+//					  rotation, a reboot in the middle of a replay, a torn write, overflow, and
+//					  the bytes written to flash per byte of event (write amplification).
+//
+//			  outage: a SmartThingsEthernet transport that posts to an in-memory hub, which goes
+//					  down for 20 s while the sketch sends one event a second.  Checks that the
+//					  hub gets every event once and in order, and that the age= of each replayed
+//					  event matches how long ago the sketch sent it.  Run with and without a
+//					  retry queue (setRetryQueue).
+//
+//			  no storage: the same outage with neither a journal nor a retry queue - every
+//					  failed event is tried once more straight away and then reported, and
+//					  the hub is tried again as soon as it is back.  Also a hub that refuses
+//					  one connection, which the immediate resend covers.
+//
+//			  esp32:  SmartThingsESP32WiFi's background send with the journal, while WiFi is down
+//					  and while a burst of events outruns its send queue (shim/WiFi.h).
+//
+//			  See README.md for how to build and run it.
+//
+//******************************************************************************************
+#include <Arduino.h>
+#include <FS.h>
+#include <FlashJournal.h>
+#include <SmartThingsEthernet.h>
+#include <SmartThingsESP32WiFi.h>
+#include <string>
+#include <vector>
+
+namespace fs
+{
+	std::map<std::string, std::vector<uint8_t> > files;
+	Stats stats;
+	long failAfter = -1;
+}
+fs::FS LittleFS;
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+	if (!ok)
+	{
+		printf("FAIL: %s\n", what);
+		++failures;
+	}
+}
+
+static std::string frontOf(st::EventJournal &journal, bool *thisBoot = 0)
+{
+	const char *message;
+	unsigned int length;
+	unsigned long capturedMillis;
+	bool boot;
+
+	if (!journal.front(message, length, capturedMillis, boot))
+	{
+		return "<empty>";
+	}
+	if (thisBoot)
+	{
+		*thisBoot = boot;
+	}
+	return std::string(message, length);
+}
+
+static void flash()
+{
+	char b[64];
+
+	//order across segment rotation; sent segments are deleted
+	fs::files.clear();
+	{
+		st::FlashJournal journal(LittleFS, "/stj", 4, 512);
+		journal.begin();
+		for (int i = 0; i < 40; i++)
+		{
+			int n = sprintf(b, "temperature1 %d.5", i);
+			host_millis += 100;
+			check(journal.append(b, n), "append");
+		}
+		size_t segments = fs::files.size();
+		bool ordered = true;
+		for (int i = 0; i < 40; i++)
+		{
+			bool thisBoot = false;
+			sprintf(b, "temperature1 %d.5", i);
+			ordered = ordered && (frontOf(journal, &thisBoot) == b) && thisBoot;
+			journal.pop();
+		}
+		check(ordered && journal.isEmpty(), "40 events replayed in order");
+		printf("flash: 40 events used %zu files, %zu left after replay\n", segments, fs::files.size());
+	}
+
+	//a reboot in the middle of a replay resumes after the last event sent
+	fs::files.clear();
+	{
+		st::FlashJournal journal(LittleFS, "/stj", 4, 512);
+		journal.begin();
+		for (int i = 0; i < 30; i++)
+		{
+			int n = sprintf(b, "contact1 %d", i);
+			journal.append(b, n);
+		}
+		for (int i = 0; i < 12; i++)
+		{
+			journal.pop();
+		}
+	}
+	{
+		st::FlashJournal journal(LittleFS, "/stj", 4, 512);
+		journal.begin();
+		bool thisBoot = true;
+		std::string front = frontOf(journal, &thisBoot);
+		journal.append("new 1", 5);
+		int left = 0;
+		std::string last;
+		while (!journal.isEmpty())
+		{
+			last = frontOf(journal);
+			journal.pop();
+			left++;
+		}
+		printf("flash: after a reboot with 12 of 30 sent, replay resumes at \"%s\", %d left\n", front.c_str(), left);
+		check(front == "contact1 12" && !thisBoot && left == 19 && last == "new 1", "resume after reboot");
+	}
+
+	//a torn write loses only the torn event
+	fs::files.clear();
+	{
+		st::FlashJournal journal(LittleFS, "/stj", 4, 512);
+		journal.begin();
+		journal.append("a 1", 3);
+		journal.append("a 2", 3);
+		fs::failAfter = 5;
+		check(!journal.append("a 3", 3), "torn append fails");
+		fs::failAfter = -1;
+		journal.append("a 4", 3);
+	}
+	{
+		st::FlashJournal journal(LittleFS, "/stj", 4, 512);
+		journal.begin();
+		std::string got;
+		while (!journal.isEmpty())
+		{
+			got += frontOf(journal) + ",";
+			journal.pop();
+		}
+		printf("flash: after a torn write and a reboot: %s\n", got.c_str());
+		check(got == "a 1,a 2,a 4,", "torn write");
+	}
+
+	//overflow drops the oldest segment
+	fs::files.clear();
+	{
+		st::FlashJournal journal(LittleFS, "/stj", 3, 256);
+		journal.begin();
+		for (int i = 0; i < 100; i++)
+		{
+			int n = sprintf(b, "power1 %d", i);
+			journal.append(b, n);
+		}
+		std::string front = frontOf(journal);
+		unsigned long kept = 0;
+		while (!journal.isEmpty())
+		{
+			journal.pop();
+			kept++;
+		}
+		printf("flash: 100 events into 3 x 256 B: kept %lu from \"%s\", dropped %lu\n", kept, front.c_str(), journal.getDroppedCount());
+		check(kept + journal.getDroppedCount() == 100, "overflow accounting");
+	}
+
+	//write amplification with the default segments: 1000 events captured, then replayed
+	fs::files.clear();
+	fs::stats = fs::Stats();
+	{
+		st::FlashJournal journal(LittleFS);
+		journal.begin();
+		unsigned long payload = 0;
+		for (int i = 0; i < 1000; i++)
+		{
+			int n = sprintf(b, "temperature%d %d.%d", i % 4 + 1, 60 + i % 30, i % 10);
+			payload += n;
+			journal.append(b, n);
+		}
+		fs::Stats captured = fs::stats;
+		while (!journal.isEmpty())
+		{
+			journal.pop();
+		}
+		printf("flash: 1000 events, %lu B (%lu dropped as the segments filled): capture wrote %lu B in %lu writes, replay wrote %lu B in %lu writes, %.2fx write amplification\n",
+			payload, journal.getDroppedCount(), captured.bytes, captured.writes, fs::stats.bytes - captured.bytes, fs::stats.writes - captured.writes, (double)fs::stats.bytes / payload);
+	}
+}
+
+//the hub: a Client that takes the messages out of each POST it is sent
+struct Delivery
+{
+	std::string message;
+	unsigned long millis;
+};
+static std::vector<Delivery> delivered;
+static bool hubUp = true;
+static int refuseConnects = 0;		//connections to refuse while the hub is up
+static unsigned long connects = 0;	//connection attempts
+static unsigned long replyDelay = 0;	//ms before the hub's reply to a POST can be read
+
+class HubClient: public Client
+{
+	public:
+		HubClient(): m_bOpen(false), m_lReceivedMillis(0) {}
+
+		virtual int connect(IPAddress ip, uint16_t port)
+		{
+			++connects;
+			m_bOpen = hubUp && (refuseConnects == 0);
+			if (hubUp && refuseConnects > 0)
+			{
+				--refuseConnects;
+			}
+			m_Request.clear();
+			return m_bOpen;
+		}
+		virtual int connect(const char *host, uint16_t port) { return connect(IPAddress(), port); }
+		virtual size_t write(uint8_t c) { return write(&c, 1); }
+		virtual size_t write(const uint8_t *buf, size_t size)
+		{
+			if (!m_bOpen)
+			{
+				return 0;
+			}
+			m_Request.append((const char *)buf, size);
+			receive();
+			return size;
+		}
+		using Print::write;
+		virtual int available() { return (millis() - m_lReceivedMillis >= replyDelay) ? m_Reply.size() : 0; }
+		virtual int read()
+		{
+			if (available() == 0)
+			{
+				return -1;
+			}
+			int c = (uint8_t)m_Reply[0];
+			m_Reply.erase(0, 1);
+			return c;
+		}
+		virtual int read(uint8_t *buf, size_t size) { return -1; }
+		virtual int peek() { return (available() == 0) ? -1 : (uint8_t)m_Reply[0]; }
+		virtual void flush() {}
+		virtual void stop() { m_bOpen = false; m_Reply.clear(); }
+		virtual uint8_t connected() { return m_bOpen; }
+		virtual operator bool() { return m_bOpen; }
+
+	private:
+		bool m_bOpen;
+		std::string m_Request;
+		std::string m_Reply;
+		unsigned long m_lReceivedMillis;
+
+		//once the whole body has arrived, one message per line
+		void receive()
+		{
+			size_t headerEnd = m_Request.find("\r\n\r\n");
+			size_t lengthAt = m_Request.find("CONTENT-LENGTH: ");
+			if (headerEnd == std::string::npos || lengthAt == std::string::npos)
+			{
+				return;
+			}
+			size_t length = atoi(m_Request.c_str() + lengthAt + 16);
+			if (m_Request.size() < headerEnd + 4 + length)
+			{
+				return;
+			}
+			std::string body = m_Request.substr(headerEnd + 4, length);
+			m_Request.erase(0, headerEnd + 4 + length);
+			m_Reply += "HTTP/1.1 202 Accepted\r\n\r\n";
+			m_lReceivedMillis = millis();
+			size_t start = 0;
+			while (start <= body.size())
+			{
+				size_t end = body.find('\n', start);
+				if (end == std::string::npos)
+				{
+					end = body.size();
+				}
+				Delivery d = {body.substr(start, end - start), millis()};
+				delivered.push_back(d);
+				start = end + 1;
+			}
+		}
+};
+
+//a transport shaped like SmartThingsEthernetW5x00, without the Ethernet library
+class HostTransport: public st::SmartThingsEthernet
+{
+	public:
+		HubClient client;
+
+		HostTransport(): st::SmartThingsEthernet(39500, IPAddress(192, 168, 1, 149), 39500, 0, "Host", false, 100, false) {}
+
+		virtual void init(void) {}
+		virtual void run(void)
+		{
+			checkConnection(client);
+			serviceRetries();
+		}
+		virtual void send(String message) { send(message.c_str(), message.length()); }
+		virtual void send(const char *message, unsigned int length) { sendBatch(&message, &length, 1); }
+		virtual void sendBatch(const char * const *messages, const unsigned int *lengths, byte count)
+		{
+			if (holdMessages(messages, lengths, count))
+			{
+				return;
+			}
+			if (!postToHub(client, messages, lengths, count))
+			{
+				client.stop();
+				retryLater(messages, lengths, count);
+			}
+			releaseConnection(client);
+		}
+		virtual void deepSleep(uint64_t time) {}
+};
+
+static const unsigned long EVENT_INTERVAL = 1000;
+static const int EVENT_COUNT = 60;
+static const unsigned long OUTAGE_START = 10000;
+static const unsigned long OUTAGE_END = 30000;
+
+static void outage(const char *name, bool retryQueue)
+{
+	static byte journalBuffer[1024];
+	static byte retryBuffer[128];
+	unsigned long sentAt[EVENT_COUNT];
+	char b[32];
+
+	delivered.clear();
+	hubUp = true;
+	host_millis = 0;
+
+	HostTransport transport;
+	st::RamJournal journal(journalBuffer, sizeof(journalBuffer));
+	transport.setJournal(&journal);
+	if (retryQueue)
+	{
+		transport.setRetryQueue(retryBuffer, sizeof(retryBuffer));
+	}
+
+	//one event a second for a minute, then run until everything has been sent (or 5 minutes)
+	int next = 0;
+	while (host_millis < 300000)
+	{
+		hubUp = (host_millis < OUTAGE_START) || (host_millis >= OUTAGE_END);
+		if ((next < EVENT_COUNT) && (host_millis >= next * EVENT_INTERVAL))
+		{
+			sentAt[next] = host_millis;
+			int n = sprintf(b, "temperature1 %d", next);
+			transport.send(b, n);
+			++next;
+		}
+		transport.run();
+		if ((next == EVENT_COUNT) && journal.isEmpty() && (delivered.size() >= EVENT_COUNT))
+		{
+			break;
+		}
+		host_millis += 10;
+	}
+
+	//every event once, in order; replayed events carry an age= within 1 s of how long ago they were sent
+	bool ordered = delivered.size() == EVENT_COUNT;
+	int aged = 0;
+	int badAges = 0;
+	unsigned long firstAfter = 0;
+	unsigned long lastBacklog = 0;
+	int backlog = 0;
+	for (size_t i = 0; i < delivered.size(); ++i)
+	{
+		int event = -1;
+		long age = -1;
+		sscanf(delivered[i].message.c_str(), "temperature1 %d age=%ld", &event, &age);
+		ordered = ordered && (event == (int)i);
+		if (event < 0 || event >= EVENT_COUNT)
+		{
+			continue;
+		}
+		if (age >= 0)
+		{
+			++aged;
+			long actual = (delivered[i].millis - sentAt[event]) / 1000;
+			if (labs(age - actual) > 1)
+			{
+				++badAges;
+				printf("  %s - sent %ld s before it arrived\n", delivered[i].message.c_str(), actual);
+			}
+		}
+		if (sentAt[event] >= OUTAGE_START && sentAt[event] < OUTAGE_END)
+		{
+			++backlog;
+			lastBacklog = delivered[i].millis;
+		}
+		if (delivered[i].millis >= OUTAGE_END && firstAfter == 0)
+		{
+			firstAfter = delivered[i].millis;
+		}
+	}
+
+	const st::SmartThingsEthernet::RetryStats &stats = transport.getRetryStats();
+	printf("outage, %s: %zu of %d events delivered%s; first delivery %.1f s after the hub came back, %d events sent during the outage delivered by %.1f s (%.1f/s from the first)\n",
+		name, delivered.size(), EVENT_COUNT, ordered ? " once each, in order" : " OUT OF ORDER OR DUPLICATED",
+		(firstAfter - OUTAGE_END) / 1000.0, backlog, (lastBacklog - OUTAGE_END) / 1000.0,
+		lastBacklog > firstAfter ? (backlog - 1) * 1000.0 / (lastBacklog - firstAfter) : 0.0);
+	printf("outage, %s: %d replayed with age=, %d more than 1 s off; journalled %lu, resends %lu, breaker trips %lu, dropped %lu\n",
+		name, aged, badAges, journal.getAppendedCount(), stats.resent, stats.breakerTrips, stats.dropped + journal.getDroppedCount());
+	check(ordered, "every event delivered once, in order");
+	check(aged > 0 && badAges == 0, "replayed ages");
+}
+
+static unsigned long timeouts = 0;
+static unsigned long overflows = 0;
+
+static void onSendResult(const char *message, unsigned int length, SmartThingsSendResult_t result)
+{
+	timeouts += (result == STSEND_TIMEOUT) ? 1 : 0;
+	overflows += (result == STSEND_OVERFLOW) ? 1 : 0;
+}
+
+static void noStorage()
+{
+	char b[32];
+
+	delivered.clear();
+	hubUp = true;
+	host_millis = 0;
+	connects = 0;
+	timeouts = 0;
+	overflows = 0;
+
+	HostTransport transport;
+	transport.setSendCallout(onSendResult);
+
+	//a hub that refuses one connection - the immediate resend delivers the event
+	refuseConnects = 1;
+	transport.send("contact1 open", 13);
+	printf("no storage: one refused connection: %zu of 1 delivered after %lu connects\n", delivered.size(), connects);
+	check(delivered.size() == 1 && timeouts == 0, "immediate resend");
+
+	//the outage - events sent while the hub is down are tried twice and reported; the rest go straight through
+	delivered.clear();
+	connects = 0;
+	unsigned long firstAfter = 0;
+	for (int next = 0; next < EVENT_COUNT; ++next)
+	{
+		unsigned long now = next * EVENT_INTERVAL;
+		host_millis = now;
+		hubUp = (now < OUTAGE_START) || (now >= OUTAGE_END);
+		int n = sprintf(b, "temperature1 %d", next);
+		size_t before = delivered.size();
+		transport.send(b, n);
+		transport.run();
+		if ((now >= OUTAGE_END) && (firstAfter == 0) && (delivered.size() > before))
+		{
+			firstAfter = now;	//the time it was sent - the transport's delay()s move host_millis on
+		}
+	}
+	int outageEvents = (OUTAGE_END - OUTAGE_START) / EVENT_INTERVAL;
+	printf("no storage, outage: %zu of %d events delivered, %lu reported STSEND_TIMEOUT, %lu STSEND_OVERFLOW, %lu connects; first event after the hub came back delivered %.1f s after it\n",
+		delivered.size(), EVENT_COUNT, timeouts, overflows, connects, (firstAfter - OUTAGE_END) / 1000.0);
+	check(delivered.size() == (size_t)(EVENT_COUNT - outageEvents) && timeouts == (unsigned long)outageEvents && overflows == 0, "no storage: events sent during the outage reported, the rest delivered");
+	check(firstAfter == OUTAGE_END, "no storage: the hub is tried as soon as it is back");
+}
+
+WiFiClass WiFi;
+EspClass ESP;
+Client *WiFiClient::host = 0;
+
+//SmartThingsESP32WiFi's background send, with the journal.  "WiFi down": WiFi drops for two
+//minutes while the sketch sends one event a second, more than its 1 KB send queue holds.
+//"burst": 100 events at once with WiFi up, more than the send queue holds while the hub takes
+//50 ms to answer each POST.
+static void esp32(const char *name, bool burst)
+{
+	static byte journalBuffer[4096];
+	const int COUNT = burst ? 100 : 180;
+	static const unsigned long WIFI_DOWN = 10000;
+	static const unsigned long WIFI_UP = 130000;
+	char b[32];
+
+	delivered.clear();
+	hubUp = true;
+	host_millis = 0;
+	overflows = 0;
+	replyDelay = burst ? 50 : 0;
+
+	HubClient hub;
+	WiFiClient::host = &hub;	//becomes the transport's st_client
+	st::SmartThingsESP32WiFi transport(39500, IPAddress(192, 168, 1, 149), 39500, 0, "Host", false, 100);
+	st::RamJournal journal(journalBuffer, sizeof(journalBuffer));
+	transport.setJournal(&journal);
+	transport.setSendCallout(onSendResult);
+
+	int next = 0;
+	while (host_millis < 600000)
+	{
+		WiFi.connected = burst || (host_millis < WIFI_DOWN) || (host_millis >= WIFI_UP);
+		while ((next < COUNT) && (burst || (host_millis >= next * EVENT_INTERVAL)))
+		{
+			int n = sprintf(b, "temperature1 %d", next);
+			transport.send(b, n);
+			++next;
+		}
+		transport.run();
+		if ((next == COUNT) && journal.isEmpty() && !transport.isSending())
+		{
+			break;
+		}
+		host_millis += 10;
+	}
+	WiFi.connected = true;
+	replyDelay = 0;
+
+	//the transport's own "rssi" messages are not counted
+	int events = 0;
+	bool ordered = true;
+	for (size_t i = 0; i < delivered.size(); ++i)
+	{
+		int event = -1;
+		if (sscanf(delivered[i].message.c_str(), "temperature1 %d", &event) == 1)
+		{
+			ordered = ordered && (event == events);
+			++events;
+		}
+	}
+	printf("esp32, %s: %d of %d events delivered%s; journalled %lu, %lu reported STSEND_OVERFLOW\n",
+		name, events, COUNT, ordered ? " once each, in order" : " OUT OF ORDER OR DUPLICATED", journal.getAppendedCount(), overflows);
+	check(ordered && (events == COUNT) && (overflows == 0), "esp32: every event delivered once, in order");
+}
+
+int main()
+{
+	flash();
+	outage("journal", false);
+	outage("journal + retry queue", true);
+	noStorage();
+	esp32("WiFi down", false);
+	esp32("burst", true);
+	printf(failures ? "%d FAILED\n" : "ok\n", failures);
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,175 @@
+//******************************************************************************************
+//  File: message_queue_bench.cpp
+//
+//  Summary:  Counts the String heap operations (malloc/realloc) Everything makes per outbound
+//			  message, before and after Return_String was replaced by st::MessageQueue.
+//
+//			  "Return_String" is the old sendSmartString()/sendStrings() code, copied here
+//			  unchanged apart from the debug output and transmit delay.  "MessageQueue" is the
+//			  library's own Everything.cpp, sending to a host st::SmartThings that only counts.
+//			  Building the caller's message String is not counted - both versions get the same
+//			  String.  "+callOnMsgSend" shows the one copy made for a sketch that sets it.  See README.md for how to build and run it.
+//
+//			  "full queue" queues readings faster than transmit pacing lets them out, and checks
+//			  that sendSmartString() never waits (the fake clock must not move) and keeps the newest.
+//
+//******************************************************************************************
+#include <Arduino.h>
+#include <Everything.h>
+#include <stdio.h>
+
+//a transport that only counts what it is given
+class CountingHub: public st::SmartThings
+{
+	public:
+		unsigned long messages;
+		unsigned long bytes;
+
+		CountingHub(): st::SmartThings(0, "Host", false, 100), messages(0), bytes(0) {}
+
+		virtual void init(void) {}
+		virtual void run(void) {}
+		virtual void send(String message) { send(message.c_str(), message.length()); }
+		virtual void send(const char *message, unsigned int length) { ++messages; bytes += length; }
+		virtual void deepSleep(uint64_t time) {}
+};
+
+//Everything's queue before st::MessageQueue
+namespace legacy
+{
+	String Return_String;
+	st::SmartThings *SmartThing;
+
+	void sendStrings()
+	{
+		unsigned int index;
+		//Loop through the Return_String buffer and send each "|" delimited string to ST Shield
+		while(Return_String.length()>=1 && Return_String[0]!='|')
+		{
+			index=Return_String.indexOf("|");
+			SmartThing->send(Return_String.substring(0, index));
+			Return_String=Return_String.substring(index+1);
+		}
+		Return_String.remove(0);	//clear the Return_String buffer
+	}
+
+	bool sendSmartString(String &str)
+	{
+		while(str.length()>1 && str[0]=='|') //get rid of leading pipes (messes up sendStrings()'s parsing technique)
+		{
+			str=str.substring(1);
+		}
+		if((str.length()==1 && str[0]=='|') || str.length()==0)
+		{
+			return false;
+		}
+
+		if(Return_String.length()+str.length()>=st::Constants::RETURN_STRING_RESERVE)
+		{
+			return false;
+		}
+		else
+		{
+			Return_String+=str+"|";		//add the new message to the queue to be sent to ST Shield with a "|" delimiter
+			return true;
+		}
+	}
+
+	void init()
+	{
+		Return_String.reserve(st::Constants::RETURN_STRING_RESERVE);
+	}
+}
+
+static void onMsgSend(const String &msg)
+{
+}
+
+static const unsigned int ROUNDS = 10000;
+static const char * const READINGS[] = {"temperature1 72.50", "humidity1 41", "contact2 open", "power1 1523.25"};
+static const byte READING_COUNT = sizeof(READINGS) / sizeof(READINGS[0]);
+
+//queue "burst" readings, then send them - the way several sensors reporting in one pass of loop() would
+template <class Queue, class Send>
+static void bench(const char *name, Queue queue, Send send, CountingHub &hub, byte burst)
+{
+	unsigned long ops = 0;
+	unsigned long queued = 0;
+
+	for (unsigned int round = 0; round < ROUNDS; ++round)
+	{
+		for (byte i = 0; i < burst; ++i)
+		{
+			String reading(READINGS[(round + i) % READING_COUNT]);
+			unsigned long before = String::heapOps;
+			queued += queue(reading) ? 1 : 0;
+			ops += String::heapOps - before;
+		}
+		host_millis += 1000;	//transmit pacing always has a slot free
+		unsigned long before = String::heapOps;
+		send();
+		ops += String::heapOps - before;
+	}
+
+	printf("%-14s burst %u: %lu messages sent, %lu heap operations, %.2f per message\n", name, burst, hub.messages, ops, (double)ops / hub.messages);
+	if (hub.messages != queued)
+	{
+		printf("FAIL: %lu queued but %lu sent\n", queued, hub.messages);
+	}
+}
+
+//readings arrive with the clock stopped, so transmit pacing never frees a slot after the first
+static bool fullQueue()
+{
+	CountingHub hub;
+	st::Everything::SmartThing = &hub;
+	st::Everything::resetQueueStats();
+	host_millis = 1000000;
+	unsigned long start = host_millis;
+
+	char b[24];
+	unsigned int sent = 0;
+	unsigned int queued = 0;
+	for (unsigned int i = 0; i < 100; ++i)
+	{
+		String reading;
+		sprintf(b, "temperature%u 72.50", i);
+		reading = b;
+		queued += st::Everything::sendSmartString(reading) ? 1 : 0;
+		++sent;
+	}
+	unsigned int waiting = st::Everything::getQueueDepth();
+	printf("full queue: %u readings into %u B, %lu sent, %u waiting, %u dropped, %lu ms spent waiting for pacing\n",
+		sent, st::Constants::RETURN_STRING_RESERVE, hub.messages, waiting, st::Everything::getDroppedCount(), host_millis - start);
+
+	bool ok = (host_millis == start) && (queued == sent) && (hub.messages + waiting + st::Everything::getDroppedCount() == sent);
+	if (!ok)
+	{
+		printf("FAIL: full queue\n");
+	}
+	return ok;
+}
+
+int main()
+{
+	for (byte burst = 1; burst <= 3; burst += 2)
+	{
+		CountingHub before;
+		legacy::SmartThing = &before;
+		legacy::init();
+		bench("Return_String", legacy::sendSmartString, legacy::sendStrings, before, burst);
+
+		CountingHub after;
+		after.setTransmitBurst(burst);
+		st::Everything::SmartThing = &after;
+		bench("MessageQueue", st::Everything::sendSmartString, st::Everything::run, after, burst);
+
+		CountingHub callback;
+		callback.setTransmitBurst(burst);
+		st::Everything::SmartThing = &callback;
+		st::Everything::callOnMsgSend = onMsgSend;
+		bench("+callOnMsgSend", st::Everything::sendSmartString, st::Everything::run, callback, burst);
+		st::Everything::callOnMsgSend = 0;
+	}
+	return fullQueue() ? 0 : 1;
+}
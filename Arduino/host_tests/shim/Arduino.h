@@ -0,0 +1,320 @@
+//******************************************************************************************
+//  File: Arduino.h (host_tests/shim)
+//
+//  Summary:  Just enough of the Arduino core to build ST_Anything and SmartThings library code
+//			  with the host's g++ for the programs in host_tests.  Not used by the Arduino IDE.
+//
+//			  String keeps its characters in a malloc()/realloc() buffer exactly as the AVR
+//			  core's WString does (no small string optimisation), and counts every call to the
+//			  allocator in String::heapOps, so the benchmarks see the heap traffic a board would.
+//			  millis() is a fake clock the programs advance themselves (host_millis).
+//
+//******************************************************************************************
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include <strings.h>
+#include <map>		//before the min()/max() macros below, which would break them
+#include <string>
+#include <vector>
+typedef uint8_t byte;
+typedef bool boolean;
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define CHANGE 1
+#define RISING 3
+#define FALLING 2
+#define A0 14
+#define NOT_AN_INTERRUPT -1
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(PSTR(s)))
+inline char *strcpy_P(char *d, const char *s) { return strcpy(d, s); }
+inline int strcmp_P(const char *a, const char *b) { return strcmp(a, b); }
+inline int strncmp_P(const char *a, const char *b, size_t n) { return strncmp(a, b, n); }
+inline size_t strlen_P(const char *a) { return strlen(a); }
+inline void *memcpy_P(void *d, const void *s, size_t n) { return memcpy(d, s, n); }
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+inline uint16_t word(uint8_t h, uint8_t l) { return (uint16_t)((h << 8) | l); }
+#define pgm_read_ptr(p) (*(void * const *)(p))
+#define DEC 10
+#define HEX 16
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long);
+void delayMicroseconds(unsigned int);
+int digitalRead(uint8_t);
+void digitalWrite(uint8_t, uint8_t);
+void pinMode(uint8_t, uint8_t);
+int analogRead(uint8_t);
+void analogWrite(uint8_t, int);
+void yield();
+int digitalPinToInterrupt(uint8_t);
+void attachInterrupt(uint8_t, void (*)(void), int);
+void detachInterrupt(uint8_t);
+#define NOT_AN_INTERRUPT -1
+
+void noInterrupts();
+void interrupts();
+long random(long);
+long random(long, long);
+unsigned long pulseIn(uint8_t, uint8_t, unsigned long timeout = 1000000L);
+long map(long, long, long, long, long);
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+template<class T> T min_(T a, T b){return a<b?a:b;}
+#ifndef min
+#define min(a,b) ((a)<(b)?(a):(b))
+#define max(a,b) ((a)>(b)?(a):(b))
+#endif
+
+class StringSumHelper;
+class String {
+public:
+  static unsigned long heapOps;   //malloc()/realloc() calls made by every String so far
+  String(const char *c = "") { init(); if (c) copy(c, strlen(c)); }
+  String(const __FlashStringHelper *f) { init(); copy((const char *)f, strlen((const char *)f)); }
+  String(const String &o) { init(); *this = o; }
+  String(String &&o) { init(); move(o); }
+  explicit String(char c) { init(); char b[2] = {c, 0}; *this = b; }
+  explicit String(unsigned char v, unsigned char base = 10) { init(); fmt(base == 16 ? "%x" : "%u", (unsigned)v); }
+  explicit String(int v, unsigned char base = 10) { init(); fmt(base == 16 ? "%x" : "%d", v); }
+  explicit String(unsigned int v, unsigned char base = 10) { init(); fmt(base == 16 ? "%x" : "%u", v); }
+  explicit String(long v, unsigned char base = 10) { init(); fmt(base == 16 ? "%lx" : "%ld", v); }
+  explicit String(unsigned long v, unsigned char base = 10) { init(); fmt(base == 16 ? "%lx" : "%lu", v); }
+  explicit String(float v, unsigned char d = 2) { init(); fmt("%.*f", (int)d, (double)v); }
+  explicit String(double v, unsigned char d = 2) { init(); fmt("%.*f", (int)d, v); }
+  ~String() { free(buffer); }
+
+  String &operator=(const String &o) { if (this != &o) { if (o.buffer) copy(o.buffer, o.len); else invalidate(); } return *this; }
+  String &operator=(String &&o) { if (this != &o) move(o); return *this; }
+  String &operator=(const char *c) { if (c) copy(c, strlen(c)); else invalidate(); return *this; }
+
+  unsigned char reserve(unsigned int size) {
+    if (buffer && capacity >= size) return 1;
+    if (changeBuffer(size)) { if (len == 0) buffer[0] = 0; return 1; }
+    return 0;
+  }
+  unsigned int length() const { return len; }
+  const char *c_str() const { return buffer ? buffer : ""; }
+  typedef void (String::*StringIfHelperType)() const;	//as WString - an implicit bool would turn s + "|" into pointer arithmetic
+  void StringIfHelper() const {}
+  operator StringIfHelperType() const { return buffer ? &String::StringIfHelper : 0; }
+
+  unsigned char concat(const char *c, unsigned int n) {
+    if (!c) return 0;
+    if (n == 0) return 1;
+    if (!reserve(len + n)) return 0;
+    memcpy(buffer + len, c, n); len += n; buffer[len] = 0;
+    return 1;
+  }
+  unsigned char concat(const String &o) { return concat(o.c_str(), o.len); }
+  unsigned char concat(const char *c) { return c ? concat(c, strlen(c)) : 0; }
+  unsigned char concat(const __FlashStringHelper *f) { return concat((const char *)f); }
+  unsigned char concat(char c) { return concat(&c, 1); }
+  unsigned char concat(unsigned char v) { char b[8]; snprintf(b, 8, "%u", (unsigned)v); return concat(b); }
+  unsigned char concat(int v) { char b[16]; snprintf(b, 16, "%d", v); return concat(b); }
+  unsigned char concat(unsigned int v) { char b[16]; snprintf(b, 16, "%u", v); return concat(b); }
+  unsigned char concat(long v) { char b[24]; snprintf(b, 24, "%ld", v); return concat(b); }
+  unsigned char concat(unsigned long v) { char b[24]; snprintf(b, 24, "%lu", v); return concat(b); }
+  unsigned char concat(float v) { char b[40]; snprintf(b, 40, "%.2f", (double)v); return concat(b); }
+  unsigned char concat(double v) { char b[40]; snprintf(b, 40, "%.2f", v); return concat(b); }
+  template <class T> String &operator+=(const T &v) { concat(v); return *this; }
+
+  char charAt(unsigned int i) const { return (*this)[i]; }
+  char operator[](unsigned int i) const { return (i < len && buffer) ? buffer[i] : 0; }
+  char &operator[](unsigned int i) { static char dummy; if (i >= len || !buffer) { dummy = 0; return dummy; } return buffer[i]; }
+
+  int compareTo(const String &o) const { return strcmp(c_str(), o.c_str()); }
+  unsigned char equals(const String &o) const { return len == o.len && compareTo(o) == 0; }
+  unsigned char equals(const char *c) const { return strcmp(c_str(), c ? c : "") == 0; }
+  unsigned char operator==(const String &o) const { return equals(o); }
+  unsigned char operator==(const char *c) const { return equals(c); }
+  unsigned char operator!=(const String &o) const { return !equals(o); }
+  unsigned char operator!=(const char *c) const { return !equals(c); }
+  unsigned char operator<(const String &o) const { return compareTo(o) < 0; }
+  unsigned char equalsIgnoreCase(const String &o) const { return len == o.len && strcasecmp(c_str(), o.c_str()) == 0; }
+  unsigned char startsWith(const String &p) const { return p.len <= len && strncmp(c_str(), p.c_str(), p.len) == 0; }
+  unsigned char endsWith(const String &p) const { return p.len <= len && strcmp(c_str() + len - p.len, p.c_str()) == 0; }
+
+  int indexOf(char c, unsigned int from = 0) const { if (from >= len) return -1; const char *p = strchr(buffer + from, c); return p ? p - buffer : -1; }
+  int indexOf(const String &s, unsigned int from = 0) const { if (from >= len) return -1; const char *p = strstr(buffer + from, s.c_str()); return p ? p - buffer : -1; }
+  int lastIndexOf(char c) const { if (!len) return -1; const char *p = strrchr(buffer, c); return p ? p - buffer : -1; }
+  String substring(unsigned int left) const { return substring(left, len); }
+  String substring(unsigned int left, unsigned int right) const {
+    if (left > right) { unsigned int t = right; right = left; left = t; }
+    String out;
+    if (left >= len) return out;
+    if (right > len) right = len;
+    char t = buffer[right]; buffer[right] = 0; out = buffer + left; buffer[right] = t;
+    return out;
+  }
+  void remove(unsigned int i) { if (i < len) { len = i; buffer[len] = 0; } }
+  void remove(unsigned int i, unsigned int n) { if (i >= len) return; if (n > len - i) n = len - i; memmove(buffer + i, buffer + i + n, len - i - n + 1); len -= n; }
+  void replace(const String &a, const String &b) {
+    String r; int from = 0, at;
+    while (a.len && (at = indexOf(a, from)) >= 0) { r.concat(buffer + from, at - from); r.concat(b); from = at + a.len; }
+    if (from) { r.concat(buffer + from, len - from); *this = r; }
+  }
+  void trim() {
+    if (!buffer || !len) return;
+    char *b = buffer; while (isspace(*b)) b++;
+    char *e = buffer + len - 1; while (e >= b && isspace(*e)) e--;
+    len = e + 1 - b; if (b > buffer) memmove(buffer, b, len); buffer[len] = 0;
+  }
+  void toLowerCase() { for (unsigned int i = 0; i < len; i++) buffer[i] = tolower(buffer[i]); }
+  void toCharArray(char *buf, unsigned int n) const { if (!n || !buf) return; unsigned int c = len < n - 1 ? len : n - 1; memcpy(buf, c_str(), c); buf[c] = 0; }
+  long toInt() const { return atol(c_str()); }
+  float toFloat() const { return atof(c_str()); }
+
+private:
+  char *buffer;
+  unsigned int capacity;
+  unsigned int len;
+  void init() { buffer = 0; capacity = 0; len = 0; }
+  void invalidate() { free(buffer); init(); }
+  unsigned char changeBuffer(unsigned int maxLen) {
+    char *b = (char *)realloc(buffer, maxLen + 1);
+    heapOps++;
+    if (!b) return 0;
+    buffer = b; capacity = maxLen;
+    return 1;
+  }
+  String &copy(const char *c, unsigned int n) {
+    if (!reserve(n)) { invalidate(); return *this; }
+    len = n; memcpy(buffer, c, n); buffer[n] = 0;
+    return *this;
+  }
+  void move(String &o) {
+    if (buffer) {
+      if (o.buffer && capacity >= o.len) { memcpy(buffer, o.buffer, o.len); len = o.len; buffer[len] = 0; o.len = 0; return; }
+      free(buffer);
+    }
+    buffer = o.buffer; capacity = o.capacity; len = o.len;
+    o.init();
+  }
+  void fmt(const char *f, ...) { char b[48]; va_list ap; va_start(ap, f); vsnprintf(b, sizeof(b), f, ap); va_end(ap); copy(b, strlen(b)); }
+};
+class StringSumHelper : public String {
+public:
+  StringSumHelper(const String &s) : String(s) {}
+  StringSumHelper(const char *p) : String(p) {}
+  StringSumHelper(char c) : String(c) {}
+  StringSumHelper(unsigned char n) : String(n) {}
+  StringSumHelper(int n) : String(n) {}
+  StringSumHelper(unsigned int n) : String(n) {}
+  StringSumHelper(long n) : String(n) {}
+  StringSumHelper(unsigned long n) : String(n) {}
+  StringSumHelper(float n) : String(n) {}
+  StringSumHelper(double n) : String(n) {}
+};
+template <class T> inline StringSumHelper &operator+(const StringSumHelper &lhs, const T &v) { StringSumHelper &a = const_cast<StringSumHelper &>(lhs); a.concat(v); return a; }
+template <size_t N> inline StringSumHelper &operator+(const StringSumHelper &lhs, const char (&v)[N]) { StringSumHelper &a = const_cast<StringSumHelper &>(lhs); a.concat((const char *)v); return a; }
+
+class Printable;
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *b, size_t n) { size_t r = 0; while (n--) r += write(*b++); return r; }
+  size_t write(const char *str) { return write((const uint8_t *)str, strlen(str)); }
+  size_t write(const char *b, size_t n) { return write((const uint8_t *)b, n); }
+  size_t print(const String &s) { return write((const uint8_t *)s.c_str(), s.length()); }
+  size_t print(const char *s) { return write(s); }
+  size_t print(const __FlashStringHelper *s) { return write((const char *)s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v, int b = DEC) { return print((long)v, b); }
+  size_t print(unsigned int v, int b = DEC) { return print((unsigned long)v, b); }
+  size_t print(long v, int b = DEC) { char s[24]; snprintf(s, 24, b == HEX ? "%lx" : "%ld", v); return write(s); }
+  size_t print(unsigned long v, int b = DEC) { char s[24]; snprintf(s, 24, b == HEX ? "%lx" : "%lu", v); return write(s); }
+  size_t print(unsigned char v, int b = DEC) { return print((unsigned long)v, b); }
+  size_t print(double v, int d = 2) { char s[48]; snprintf(s, 48, "%.*f", d, v); return write(s); }
+  size_t print(const Printable &p);
+  size_t println() { return write("\r\n"); }
+  template <class T> size_t println(const T &v) { size_t n = print(v); return n + println(); }
+  template <class T> size_t println(const T &v, int b) { size_t n = print(v, b); return n + println(); }
+  size_t printf(const char *fmt, ...) { return 0; }
+};
+class Printable { public: virtual ~Printable() {} virtual size_t printTo(Print &p) const = 0; };
+inline size_t Print::print(const Printable &p) { return p.printTo(*this); }
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual void flush() {}
+  size_t readBytes(char *b, size_t n) { size_t i = 0; while (i < n && available()) b[i++] = read(); return i; }
+};
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long) {}
+  size_t write(uint8_t c) override { fputc(c, stdout); return 1; }
+  using Print::write;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  operator bool() { return true; }
+};
+extern HardwareSerial Serial;
+extern unsigned long host_millis;	//the fake clock behind millis()
+class IPAddress : public Printable {
+public:
+  uint8_t a[4];
+  IPAddress() { a[0]=a[1]=a[2]=a[3]=0; }
+  IPAddress(uint8_t x, uint8_t y, uint8_t z, uint8_t w) { a[0]=x; a[1]=y; a[2]=z; a[3]=w; }
+  IPAddress(uint32_t v) { memcpy(a, &v, 4); }
+  operator uint32_t() const { uint32_t v; memcpy(&v, a, 4); return v; }
+  uint8_t operator[](int i) const { return a[i]; }
+  bool operator==(const IPAddress &o) const { return memcmp(a, o.a, 4) == 0; }
+  size_t printTo(Print &p) const override { return 0; }
+};
+class Client : public Stream {
+public:
+  virtual int connect(IPAddress ip, uint16_t port) = 0;
+  virtual int connect(const char *host, uint16_t port) = 0;
+  virtual size_t write(uint8_t) = 0;
+  virtual size_t write(const uint8_t *buf, size_t size) = 0;
+  using Print::write;
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int read(uint8_t *buf, size_t size) = 0;
+  virtual int peek() = 0;
+  virtual void flush() = 0;
+  virtual void stop() = 0;
+  virtual uint8_t connected() = 0;
+  virtual operator bool() = 0;
+};
+class UDP : public Stream {
+public:
+  virtual uint8_t begin(uint16_t) = 0;
+  virtual void stop() = 0;
+  virtual int beginPacket(IPAddress ip, uint16_t port) = 0;
+  virtual int beginPacket(const char *host, uint16_t port) = 0;
+  virtual int endPacket() = 0;
+  virtual size_t write(uint8_t) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size) = 0;
+  using Print::write;
+  virtual int parsePacket() = 0;
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int read(unsigned char *buffer, size_t len) = 0;
+  virtual int read(char *buffer, size_t len) = 0;
+  virtual int peek() = 0;
+  virtual void flush() = 0;
+  virtual IPAddress remoteIP() = 0;
+  virtual uint16_t remotePort() = 0;
+};
+#endif
@@ -0,0 +1,91 @@
+//******************************************************************************************
+//  File: FS.h (host_tests/shim)
+//
+//  Summary:  The part of the ESP8266/ESP32 fs::FS API st::FlashJournal uses, kept in memory.
+//			  Counts the bytes and write calls that reach "flash", and can tear a write
+//			  (failAfter = bytes written before writes start to come up short).
+//
+//******************************************************************************************
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fs
+{
+	struct Stats { unsigned long bytes = 0, writes = 0, opens = 0, removes = 0; };
+
+	extern std::map<std::string, std::vector<uint8_t> > files;
+	extern Stats stats;
+	extern long failAfter;	//-1 = never
+
+	class File
+	{
+	public:
+		File() {}
+		File(const std::string &path, bool append): p(path), ok(true) { if (append) pos = files[p].size(); }
+		explicit operator bool() const { return ok; }
+		size_t read(uint8_t *b, size_t n)
+		{
+			std::vector<uint8_t> &f = files[p];
+			size_t k = pos >= f.size() ? 0 : (n < f.size() - pos ? n : f.size() - pos);
+			memcpy(b, f.data() + pos, k);
+			pos += k;
+			return k;
+		}
+		size_t write(const uint8_t *b, size_t n)
+		{
+			std::vector<uint8_t> &f = files[p];
+			size_t k = n;
+			if (failAfter >= 0)
+			{
+				if ((long)k > failAfter) k = failAfter;
+				failAfter -= k;
+			}
+			f.insert(f.end(), b, b + k);
+			pos = f.size();
+			stats.bytes += k;
+			stats.writes++;
+			return k;
+		}
+		bool seek(uint32_t o) { pos = o; return o <= files[p].size(); }
+		size_t size() { return files[p].size(); }
+		void close() { ok = false; }
+
+	private:
+		std::string p;
+		size_t pos = 0;
+		bool ok = false;
+	};
+
+	class FS
+	{
+	public:
+		File open(const char *path, const char *mode)
+		{
+			stats.opens++;
+			std::string s(path);
+			if (mode[0] == 'r')
+			{
+				return files.count(s) ? File(s, false) : File();
+			}
+			if (mode[0] == 'w')
+			{
+				files[s].clear();
+			}
+			else
+			{
+				files[s];
+			}
+			return File(s, mode[0] == 'a');
+		}
+		bool exists(const char *path) { return files.count(path) > 0; }
+		bool remove(const char *path) { stats.removes++; return files.erase(path) > 0; }
+	};
+}
+using fs::File;
+
+#endif
@@ -0,0 +1,2 @@
+//host_tests shim - the Arduino core classes live in Arduino.h
+#include <Arduino.h>
@@ -0,0 +1,95 @@
+//******************************************************************************************
+//  File: WiFi.h (host_tests/shim)
+//
+//  Summary:  The part of the ESP32 WiFi library SmartThingsESP32WiFi uses.  WiFi.connected
+//			  says whether WiFi is up.  The next WiFiClient made (the transport's st_client)
+//			  takes the Client in WiFiClient::host and passes everything to it.  The others
+//			  (the server's, and the slots they are kept in) have nothing to talk to.
+//
+//******************************************************************************************
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include <Arduino.h>
+
+#define RTC_DATA_ATTR
+#define INADDR_NONE IPAddress(0, 0, 0, 0)
+
+enum { WL_CONNECTED = 3 };
+enum { WIFI_STA = 1 };
+typedef enum { SYSTEM_EVENT_STA_START, SYSTEM_EVENT_STA_CONNECTED, SYSTEM_EVENT_STA_GOT_IP, SYSTEM_EVENT_STA_DISCONNECTED } WiFiEvent_t;
+
+class WiFiClient: public Client
+{
+	public:
+		static Client *host;
+
+		WiFiClient(): c(host) { host = 0; }
+		explicit WiFiClient(Client *client): c(client) {}
+
+		virtual int connect(IPAddress ip, uint16_t port) { return c ? c->connect(ip, port) : 0; }
+		virtual int connect(const char *name, uint16_t port) { return c ? c->connect(name, port) : 0; }
+		virtual size_t write(uint8_t b) { return c ? c->write(b) : 0; }
+		virtual size_t write(const uint8_t *buf, size_t size) { return c ? c->write(buf, size) : 0; }
+		using Print::write;
+		virtual int available() { return c ? c->available() : 0; }
+		virtual int read() { return c ? c->read() : -1; }
+		virtual int read(uint8_t *buf, size_t size) { return c ? c->read(buf, size) : -1; }
+		virtual int peek() { return c ? c->peek() : -1; }
+		virtual void flush() { if (c) c->flush(); }
+		virtual void stop() { if (c) c->stop(); }
+		virtual uint8_t connected() { return c ? c->connected() : 0; }
+		virtual operator bool() { return c && (bool)*c; }
+		IPAddress remoteIP() { return IPAddress(0, 0, 0, 0); }
+		uint16_t remotePort() { return 0; }
+
+	private:
+		Client *c;
+};
+
+class WiFiServer
+{
+	public:
+		WiFiServer(uint16_t port) {}
+		void begin() {}
+		WiFiClient available() { return WiFiClient(0); }
+};
+
+class WiFiClass
+{
+	public:
+		bool connected = true;
+
+		bool isConnected() { return connected; }
+		int status() { return connected ? WL_CONNECTED : 0; }
+		long RSSI() { return -60; }
+		void mode(int m) {}
+		void begin(const char *ssid, const char *password, int32_t channel = 0, const uint8_t *bssid = 0) {}
+		bool config(IPAddress local, IPAddress gateway, IPAddress subnet, IPAddress dns = IPAddress(0, 0, 0, 0)) { return true; }
+		bool disconnect(bool wifiOff = false, bool eraseAp = false) { return true; }
+		bool reconnect() { return true; }
+		void onEvent(void (*handler)(WiFiEvent_t)) {}
+		void setAutoConnect(bool on) {}
+		void setAutoReconnect(bool on) {}
+		bool setHostname(const char *name) { return true; }
+		void setSleep(bool on) {}
+		String macAddress() { return String("00:00:00:00:00:00"); }
+		IPAddress localIP() { return IPAddress(192, 168, 1, 50); }
+		IPAddress gatewayIP() { return IPAddress(192, 168, 1, 1); }
+		IPAddress subnetMask() { return IPAddress(255, 255, 255, 0); }
+		IPAddress dnsIP() { return IPAddress(192, 168, 1, 1); }
+		int32_t channel() { return 1; }
+		uint8_t *BSSID() { static uint8_t b[6]; return b; }
+};
+extern WiFiClass WiFi;
+
+class EspClass
+{
+	public:
+		void restart() {}
+};
+extern EspClass ESP;
+
+inline void esp_deep_sleep(uint64_t time) {}
+
+#endif
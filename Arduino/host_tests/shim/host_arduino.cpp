@@ -0,0 +1,32 @@
+//******************************************************************************************
+//  File: host_arduino.cpp (host_tests/shim)
+//
+//  Summary:  The Arduino core functions declared in shim/Arduino.h.  millis() returns
+//			  host_millis, which each program advances itself; delay() and yield() advance it.
+//
+//******************************************************************************************
+#include <Arduino.h>
+
+HardwareSerial Serial;
+unsigned long String::heapOps = 0;
+unsigned long host_millis = 0;
+
+unsigned long millis() { return host_millis; }
+unsigned long micros() { return host_millis * 1000; }
+void delay(unsigned long ms) { host_millis += ms; }
+void delayMicroseconds(unsigned int) {}
+void yield() { host_millis++; }
+int digitalRead(uint8_t) { return LOW; }
+void digitalWrite(uint8_t, uint8_t) {}
+void pinMode(uint8_t, uint8_t) {}
+int analogRead(uint8_t) { return 0; }
+void analogWrite(uint8_t, int) {}
+int digitalPinToInterrupt(uint8_t p) { return p; }
+void attachInterrupt(uint8_t, void (*)(void), int) {}
+void detachInterrupt(uint8_t) {}
+void noInterrupts() {}
+void interrupts() {}
+long random(long m) { return rand() % m; }
+long random(long a, long b) { return a + rand() % (b - a); }
+unsigned long pulseIn(uint8_t, uint8_t, unsigned long) { return 0; }
+long map(long x, long a, long b, long c, long d) { return (x - a) * (d - c) / (b - a) + c; }
@@ -40,6 +40,11 @@
 //    2016-06-04  Dan Ogorchock  Added improved support for Arduino Leonardo
 //    2017-02-07  Dan Ogorchock  Added support for new SmartThings v2.0 library (ThingShield, W5100, ESP8266)
 //    2017-08-14  Dan Ogorchock  Added support for ESP32
+//    2026-10-16  a00889920      RETURN_STRING_RESERVE now sizes Everything's fixed message queue buffer
+//    2026-10-16  a00889920      Added ENABLE_INTERRUPT_ISR, INTERRUPT_QUEUE_SIZE and INTERRUPT_DEBOUNCE_MS
+//    2026-10-16  a00889920      Added MAX_BATCH_COUNT
+//    2026-10-16  a00889920      Added ENABLE_PROFILER
+//    2026-10-16  a00889920      Added ST_ISR_ATTR for interrupt handlers
 //
 //******************************************************************************************
 
@@ -52,6 +57,8 @@
 //#define ENABLE_SERIAL			//If uncommented, will allow you to type in commands via the Arduino Serial Console Window (useful for debugging)
 //#define DISABLE_SMARTTHINGS	//If uncommented, will disable all ST Shield Library calls (e.g. you want to use this library without SmartThings for a different application)
 //#define DISABLE_REFRESH		//If uncommented, will disable periodic refresh of the sensors and executors states to the ST Cloud - improves performance, but may reduce data integrity
+//#define ENABLE_PROFILER		//If uncommented, Everything times every device's update() and each phase of run() - send "stats" from the hub or Serial Monitor to print the results
+//#define ENABLE_INTERRUPT_ISR	//If uncommented, InterruptSensors on pins that support attachInterrupt() are driven by a hardware interrupt and debounced by time instead of loop counts
 
 #if defined(__AVR_ATmega168__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega328P__) || defined(ARDUINO_AVR_UNO)
 #define BOARD_UNO
@@ -69,6 +76,15 @@
 #define BOARD_UNO	//assume user is using an UNO for the unknown case
 #endif
 
+//interrupt handlers must live in RAM on the ESP boards - put ST_ISR_ATTR in front of every function passed to attachInterrupt()
+#if defined(ARDUINO_ARCH_ESP8266)
+#define ST_ISR_ATTR ICACHE_RAM_ATTR
+#elif defined(ARDUINO_ARCH_ESP32)
+#define ST_ISR_ATTR IRAM_ATTR
+#else
+#define ST_ISR_ATTR
+#endif
+
 namespace st
 {
 	class Constants
@@ -91,11 +107,22 @@ namespace st
 				//Maximum number of EXECUTOR objects
 				static const byte MAX_EXECUTOR_COUNT = 10;				//Used to limit the number of executor devices allowed.  Be careful on Arduino UNO due to 2K SRAM limitation 
 			#endif
-			//Size of reserved return string
+			//Size of the outbound message queue buffer (bytes) - each queued message uses its length plus 4 bytes
 			static const byte RETURN_STRING_RESERVE = (MAX_SENSOR_COUNT + MAX_EXECUTOR_COUNT) * 5;	//Do not make too large due to UNO's 2K SRAM limitation
+			static const byte MAX_BATCH_COUNT = 10;					//Most queued messages combined into one transmission - only used if batching is enabled with SmartThings::setMaxBatchSize()
 			//Interval on which Device's refresh methods are called (in seconds) - most useful for Executors and InterruptSensors - only works if DISABLE_REFRESH is not defined above
 			static const int DEV_REFRESH_INTERVAL=300;				//seconds - Used to make sure the ST Cloud is kept current with device status (in case of missed updates to the ST Cloud) - primarily for Executors and InterruptSensors - only works if DISABLE_REFRESH is not defined above
 
+			//--- only used if ENABLE_INTERRUPT_ISR is defined above
+			#if defined(BOARD_UNO)
+				static const byte INTERRUPT_QUEUE_SIZE = 8;				//Number of pin changes that can be held between passes through loop() - must be a power of 2
+			#else
+				static const byte INTERRUPT_QUEUE_SIZE = 32;			//Number of pin changes that can be held between passes through loop() - must be a power of 2
+			#endif
+			//If more changes arrive than the queue holds (e.g. a bouncing switch while loop() is stalled), the rest are dropped and
+			//the pin is re-read.  A press and release dropped that way is still reported, but several are reported as one.
+			static const unsigned int INTERRUPT_DEBOUNCE_MS = 20;		//Default time (ms) an InterruptSensor's pin must be stable before the change is believed
+
 			//NOTE:  The following constant was removed and replaced by a user defineable interval in the SmartThings library constaructors to permit different values for each communication method (i.e. ThingShield requires 1000ms, whereas Ethernet is ~100ms) 
 			//Minumum interval between sending packets of data to ThingShield (in milliseconds) - noticed issue where ST Hub/Cloud could not keep up with rapid data transfer
 			//static const int SENDSTRINGS_INTERVAL = 100;
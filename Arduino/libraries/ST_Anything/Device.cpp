@@ -12,6 +12,8 @@
 //    ----        ---            ----
 //    2015-01-03  Dan & Daniel   Original Creation
 //    2018-08-15  Dan Ogorchock  Workaround for strcpy_P() ESP32 crash bug
+//    2026-10-16  a00889920      Added compareName() to compare names in place, without building Strings
+//    2026-10-16  a00889920      Added scheduler support - devices may ask Everything to call update() only when a wake time arrives
 //
 //******************************************************************************************
 
@@ -26,7 +28,10 @@ namespace st
 //public
 	//constructor
 	Device::Device(const __FlashStringHelper *name):
-		m_pName(name)
+		m_pName(name),
+		m_nWakeTime(0),
+		m_nScheduleIndex(NOT_SCHEDULED),
+		m_bScheduled(false)
 	{
 		if(debug)
 		{
@@ -49,6 +54,20 @@ namespace st
 	{
 		
 	}
+
+	void Device::scheduleUpdate(unsigned long wakeTime)
+	{
+		if (!m_bScheduled)
+		{
+			return;		//update() is already called on every pass through loop()
+		}
+		Everything::scheduleDevice(this, wakeTime);
+	}
+
+	void Device::cancelUpdate()
+	{
+		Everything::unscheduleDevice(this);
+	}
 	
 	const String Device::getName() const
 	{
@@ -62,6 +81,32 @@ namespace st
 
 	}
 	
+	int Device::compareName(const char *str, unsigned int length) const
+	{
+		const char *name = (const char*)m_pName;
+		for (unsigned int i = 0; i < length; ++i)
+		{
+			char c = pgm_read_byte(name + i);
+			if (c != str[i])
+			{
+				return (c == 0 || (unsigned char)c < (unsigned char)str[i]) ? -1 : 1;
+			}
+		}
+		return (pgm_read_byte(name + length) == 0) ? 0 : 1;	//name is longer than str
+	}
+
+	int Device::compareName(const Device &other) const
+	{
+		const char *a = (const char*)m_pName;
+		const char *b = (const char*)other.m_pName;
+		char ca, cb;
+		do
+		{
+			ca = pgm_read_byte(a++);
+			cb = pgm_read_byte(b++);
+		} while (ca != 0 && ca == cb);
+		return (unsigned char)ca - (unsigned char)cb;
+	}
 
 	//debug flag to determine if debug print statements are executed (set value in your sketch)
 	bool Device::debug=false;
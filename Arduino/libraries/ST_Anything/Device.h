@@ -12,6 +12,10 @@
 //    ----        ---            ----
 //    2015-01-03  Dan & Daniel   Original Creation
 //    2019-02-09  Dan Ogorchock  Moved update() from Sensor to Device
+//    2026-10-16  a00889920      Added compareName() to compare names in place, without building Strings
+//    2026-10-16  a00889920      Added scheduler support - devices may ask Everything to call update() only when a wake time arrives
+//    2026-10-16  a00889920      Added per device update() timings when ENABLE_PROFILER is defined
+//    2026-10-16  a00889920      st::Registry (RegistryAccess) may call update() and record its timings, as Everything does
 //
 //
 //******************************************************************************************
@@ -21,15 +25,36 @@
 
 #include <Arduino.h>
 //#include <avr/pgmspace.h>
+#include "ProfileStats.h"
 
 namespace st
 {
+	class Everything;
+	class RegistryAccess;
+
 	class Device
 	{
 		private:
 			const __FlashStringHelper *m_pName;
+			unsigned long m_nWakeTime;	//millis() value at which Everything should next call update() - only used if m_bScheduled
+			byte m_nScheduleIndex;		//position of this device in Everything's schedule (NOT_SCHEDULED if no wake time is pending)
+			bool m_bScheduled;			//true if update() is only called when requested via scheduleUpdate(), false to call it on every pass through loop()
+#if defined(ENABLE_PROFILER)
+			ProfileStats m_UpdateStats;	//time spent in update() - collected by Everything::updateDevices()
+#endif
+
+			friend class Everything;
+			friend class RegistryAccess;
+
+		protected:
+			//scheduler support - derived classes whose update() only has work to do at known times call setScheduled(true) in their constructor
+			void setScheduled(bool scheduled) {m_bScheduled = scheduled;}
+			void scheduleUpdate(unsigned long wakeTime);	//asks Everything to call update() once millis() reaches wakeTime (replaces any earlier request) - ignored unless setScheduled(true)
+			void cancelUpdate();							//cancels any pending scheduleUpdate() request
 			
 		public:
+			static const byte NOT_SCHEDULED = 0xFF;
+
 			//constructor
 			Device(const __FlashStringHelper *name);
 			
@@ -48,6 +73,13 @@ namespace st
 
 			//gets
 			const String getName() const;
+			const __FlashStringHelper* getNamePtr() const {return m_pName;}
+
+			//compares this device's name with str (length characters, need not be null terminated) - no copies are made
+			//returns <0, 0, or >0 if the name sorts before, equal to, or after str
+			int compareName(const char *str, unsigned int length) const;
+			int compareName(const Device &other) const;
+			bool isScheduled() const {return m_bScheduled;}
 				
 			//debug flag to determine if debug print statements are executed (set value in your sketch)
 			static bool debug;
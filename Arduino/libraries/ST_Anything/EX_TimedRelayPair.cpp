@@ -24,6 +24,8 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2019-10-30  Dan Ogorchock  Original Creation
+//    2026-10-16  a00889920      Ported onto the Everything scheduler - update() only runs when the output timer expires.
+//                               The timer is now cleared when it expires, so it no longer blocks the periodic refresh forever.
 //
 //
 //******************************************************************************************
@@ -61,9 +63,11 @@ namespace st
 			//update the digital outputs
 			if (((m_bCurrentState == HIGH) && (m_lOutput1Time > 0)) || ((m_bCurrentState == LOW) && (m_lOutput2Time > 0)))
 			{
+				st::Everything::bTimersPending++;	//balanced by update() when the timer expires
 				m_bTimerPending = true;
 			}
 			m_lTimeChanged = millis();
+			setScheduled(true);	//update() only has work to do when the output timer expires
 			writeStateToPin(m_nOutputPin1, m_bCurrentState);
 			writeStateToPin(m_nOutputPin2, !m_bCurrentState);
 		}
@@ -84,13 +88,20 @@ namespace st
 
 		if (m_bTimerPending)
 		{
-			if ((m_bCurrentState == HIGH) && (millis() - m_lTimeChanged >= m_lOutput1Time))
+			unsigned long duration = (m_bCurrentState == HIGH) ? m_lOutput1Time : m_lOutput2Time;
+
+			if (millis() - m_lTimeChanged >= duration)
 			{
-				writeStateToPin(m_nOutputPin1, LOW);
+				writeStateToPin((m_bCurrentState == HIGH) ? m_nOutputPin1 : m_nOutputPin2, LOW);
+
+				//Decrement number of active timers
+				if (st::Everything::bTimersPending > 0) st::Everything::bTimersPending--;
+				m_bTimerPending = false;
 			}
-			else if ((m_bCurrentState == LOW) && (millis() - m_lTimeChanged >= m_lOutput2Time))
+			else
 			{
-				writeStateToPin(m_nOutputPin2, LOW);
+				//wake up again when the output timer expires
+				scheduleUpdate(m_lTimeChanged + duration);
 			}
 		}
 
@@ -130,6 +141,10 @@ namespace st
 			//update the digital outputs
 			writeStateToPin(m_nOutputPin2, !m_bCurrentState);
 			writeStateToPin(m_nOutputPin1, m_bCurrentState);
+
+			//wake up when the output timer expires
+			if (m_bTimerPending) scheduleUpdate(m_lTimeChanged + m_lOutput1Time);
+			else cancelUpdate();
 		}
 		//else if ((s == F("close")) && (m_bCurrentState == HIGH))
 		else if (s == F("close"))
@@ -158,6 +173,10 @@ namespace st
 			//update the digital outputs
 			writeStateToPin(m_nOutputPin1, m_bCurrentState);
 			writeStateToPin(m_nOutputPin2, !m_bCurrentState);
+
+			//wake up when the output timer expires
+			if (m_bTimerPending) scheduleUpdate(m_lTimeChanged + m_lOutput2Time);
+			else cancelUpdate();
 		}
 		
 	}
@@ -24,6 +24,8 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2019-10-30  Dan Ogorchock  Original Creation
+//    2026-10-16  a00889920      Ported onto the Everything scheduler - update() only runs when the output timer expires.
+//                               The timer is now cleared when it expires, so it no longer blocks the periodic refresh forever.
 //
 //
 //******************************************************************************************
@@ -28,12 +28,31 @@
 //    2020-08-22  a00889920      Added deepSleep() function
 //    
 //    2021-01-31  Marcus van Ierssel Improved the automatic refresh to prevent it from blocking other updates.
+//    2026-10-16  a00889920      Replaced Return_String with a fixed-size st::MessageQueue.  Messages are sent straight from the
+//                               queue's buffer, so sendSmartString()/sendStrings() no longer allocate any temporary Strings.
+//    2026-10-16  a00889920      sendStrings() no longer calls delay() to throttle transmissions.  Messages stay queued until the
+//                               SmartThings token bucket allows the next one, so run() always returns promptly.
+//    2026-10-16  a00889920      getDeviceByName() now does a binary search of a name index built at the end of initDevices(),
+//                               comparing directly against the names in flash, so looking up a device no longer allocates Strings.
+//    2026-10-16  a00889920      Added a min-heap scheduler.  Devices that call setScheduled(true) (PollingSensor, PollingSensorExtended,
+//                               S_TimedRelay, EX_TimedRelayPair) are only updated when their requested wake time arrives, so loop()
+//                               cost no longer grows with the number of polling sensors.
+//    2026-10-16  a00889920      Added optional coalescing of queued numeric readings (coalesceReadings) and coalesced/dropped message counters
+//    2026-10-16  a00889920      sendStrings() sends up to MAX_BATCH_COUNT queued messages in one transmission when SmartThings::setMaxBatchSize() is set
+//    2026-10-16  a00889920      Added optional profiler (ENABLE_PROFILER) - per device and per phase timings, "stats" command and periodic stats report
+//    2026-10-16  a00889920      Added receiveSendResult() - counts failed background sends and passes each result to callOnSendResult
+//    2026-10-16  a00889920      sendStrings() leaves messages queued until SmartThing->isReady() (e.g. WiFiEsp still joining WiFi)
+//    2026-10-16  a00889920      sendSmartString() no longer waits for transmit pacing to drain a full Return_Queue.  It sends what
+//                               pacing allows, then drops the oldest queued messages (counted in m_nDroppedCount) until the new one fits.
+//    2026-10-16  a00889920      The device arrays are given to Everything by init() (Constants.h sized) or by an st::Registry (sized for
+//                               the sketch's devices, see Registry.h).  A Registry also updates its devices without virtual calls.
 //
 //******************************************************************************************
 
 //#include <Arduino.h>
 //#include <avr/pgmspace.h>
 #include "Everything.h"
+#include "Registry.h"
 
 long freeRam();	//freeRam() function prototype - useful in determining how much SRAM is available on Arduino
 #if defined(ARDUINO_ARCH_SAMD)
@@ -45,16 +64,135 @@ namespace st
 //private
 	void Everything::updateDevices()
 	{
-		for(unsigned int index=0; index<m_nSensorCount; ++index)
+		//devices that are not scheduled still need update() called on every pass (e.g. InterruptSensors polling their pin)
+		if (m_pRegistry)
+		{
+			m_pRegistry->updateAll();	//the same, each device called as its own type
+		}
+		else
 		{
-			m_Sensors[index]->update();
+			for(unsigned int index=0; index<m_nSensorCount; ++index)
+			{
+				if (!m_Sensors[index]->m_bScheduled)
+				{
+					ST_PROFILE_START(start);
+					m_Sensors[index]->update();
+					ST_PROFILE_END(m_Sensors[index]->m_UpdateStats, start);
+					sendStrings();
+				}
+			}
+
+			for (unsigned int i = 0; i<m_nExecutorCount; ++i)
+			{
+				if (!m_Executors[i]->m_bScheduled)
+				{
+					ST_PROFILE_START(start);
+					m_Executors[i]->update();
+					ST_PROFILE_END(m_Executors[i]->m_UpdateStats, start);
+					sendStrings();
+				}
+			}
+		}
+
+		//scheduled devices whose wake time has arrived - each is removed from the schedule before update() is called, and
+		//update() schedules the device again if it needs to.  Limit the pass to the devices scheduled on entry so a device
+		//that keeps asking to be woken immediately cannot stall loop().
+		unsigned long now = millis();
+		for (byte n = m_nScheduleCount; (n > 0) && (m_nScheduleCount > 0) && ((long)(now - m_Schedule[0]->m_nWakeTime) >= 0); --n)
+		{
+			Device *p = m_Schedule[0];
+			unscheduleDevice(p);
+			ST_PROFILE_START(start);
+			p->update();
+			ST_PROFILE_END(p->m_UpdateStats, start);
 			sendStrings();
 		}
+	}
 
-		for (unsigned int i = 0; i<m_nExecutorCount; ++i)
+	bool Everything::wakesBefore(const Device *a, const Device *b)
+	{
+		return (long)(a->m_nWakeTime - b->m_nWakeTime) < 0;
+	}
+
+	void Everything::placeInSchedule(Device *device, byte index)
+	{
+		m_Schedule[index] = device;
+		device->m_nScheduleIndex = index;
+	}
+
+	void Everything::siftUp(byte index)
+	{
+		Device *p = m_Schedule[index];
+		while (index > 0)
 		{
-			m_Executors[i]->update();
-			sendStrings();
+			byte parent = (index - 1) / 2;
+			if (!wakesBefore(p, m_Schedule[parent]))
+			{
+				break;
+			}
+			placeInSchedule(m_Schedule[parent], index);
+			index = parent;
+		}
+		placeInSchedule(p, index);
+	}
+
+	void Everything::siftDown(byte index)
+	{
+		Device *p = m_Schedule[index];
+		while (true)
+		{
+			unsigned int child = 2 * (unsigned int)index + 1;
+			if (child >= m_nScheduleCount)
+			{
+				break;
+			}
+			if ((child + 1 < m_nScheduleCount) && wakesBefore(m_Schedule[child + 1], m_Schedule[child]))
+			{
+				++child;
+			}
+			if (!wakesBefore(m_Schedule[child], p))
+			{
+				break;
+			}
+			placeInSchedule(m_Schedule[child], index);
+			index = child;
+		}
+		placeInSchedule(p, index);
+	}
+
+	void Everything::scheduleDevice(Device *device, unsigned long wakeTime)
+	{
+		device->m_nWakeTime = wakeTime;
+
+		if (device->m_nScheduleIndex == Device::NOT_SCHEDULED)
+		{
+			if (m_nScheduleCount >= m_nMaxSensors + m_nMaxExecutors)
+			{
+				return;	//only possible for a Device that was never added to st::Everything
+			}
+			placeInSchedule(device, m_nScheduleCount++);
+		}
+
+		siftUp(device->m_nScheduleIndex);
+		siftDown(device->m_nScheduleIndex);
+	}
+
+	void Everything::unscheduleDevice(Device *device)
+	{
+		byte index = device->m_nScheduleIndex;
+		if (index == Device::NOT_SCHEDULED)
+		{
+			return;
+		}
+
+		device->m_nScheduleIndex = Device::NOT_SCHEDULED;
+		--m_nScheduleCount;
+		if (index < m_nScheduleCount)
+		{
+			Device *moved = m_Schedule[m_nScheduleCount];
+			placeInSchedule(moved, index);	//move the last entry into the hole, then restore the heap order
+			siftUp(index);
+			siftDown(moved->m_nScheduleIndex);
 		}
 	}
 	
@@ -77,42 +215,138 @@ namespace st
 	
 	void Everything::sendStrings()
 	{
-		unsigned int index;
-		//Loop through the Return_String buffer and send each "|" delimited string to ST Shield
-		while(Return_String.length()>=1 && Return_String[0]!='|')
+		const char *msgs[Constants::MAX_BATCH_COUNT];
+		unsigned int lengths[Constants::MAX_BATCH_COUNT];
+		byte count;
+
+		if (m_bSending)
 		{
-			index=Return_String.indexOf("|");
+			return;		//re-entry (e.g. sendSmartStringNow() called from a callback) would send a message twice
+		}
+		m_bSending = true;
+
+		#if defined(ENABLE_PROFILER)
+			unsigned long start = micros();
+			unsigned int queued = Return_Queue.count();
+		#endif
+
+		//Loop through the Return_Queue and send each message (or batch of messages) to ST Shield, directly from the queue's buffer
+		while(!Return_Queue.isEmpty())
+		{
+			#ifndef DISABLE_SMARTTHINGS
+			if (!SmartThing->isReady())
+			{
+				break;	//the network is still coming up - the queue goes out on a later pass through run()
+			}
+			if (!SmartThing->acquireTransmitSlot())
+			{
+				break;	//not time to send yet - the rest of the queue will go out on later passes through run()
+			}
+			#endif
+
+			unsigned int wait = Return_Queue.frontAge();
+			if (wait > m_nQueueWaitMax)
+			{
+				m_nQueueWaitMax = wait;
+			}
+
+			byte maxCount = 1;
+			unsigned int maxBytes = 0;
+			#ifndef DISABLE_SMARTTHINGS
+				if (SmartThing->getMaxBatchSize() > 0)
+				{
+					maxCount = Constants::MAX_BATCH_COUNT;
+					maxBytes = SmartThing->getMaxBatchSize();
+				}
+			#endif
+			count = Return_Queue.frontBatch(msgs, lengths, maxCount, maxBytes);
+
 			if(debug)
 			{
-				Serial.print(F("Everything: Sending: "));
-				Serial.println(Return_String.substring(0, index));
+				for (byte i = 0; i < count; ++i)
+				{
+					Serial.print(F("Everything: Sending: "));
+					Serial.write(msgs[i], lengths[i]);
+					Serial.println();
+				}
 				//Serial.print(F("Everything: getTransmitInterval() = "));
 				//Serial.println(SmartThing->getTransmitInterval());
 			}
 			#ifndef DISABLE_SMARTTHINGS
-//			if (millis() - sendstringsLastMillis < Constants::SENDSTRINGS_INTERVAL)
-			if (millis() - sendstringsLastMillis < SmartThing->getTransmitInterval())
+				if (count > 1)
 				{
-//					delay(Constants::SENDSTRINGS_INTERVAL - (millis() - sendstringsLastMillis)); //Added due to slow ST Hub/Cloud Processing.  Events were being missed.  DGO 2015-03-28
-					delay(SmartThing->getTransmitInterval() - (millis() - sendstringsLastMillis)); //modified to allow different values for each method of communicating to ST cloud.  DGO 2017-04-26
-			}
-				SmartThing->send(Return_String.substring(0, index));
-				sendstringsLastMillis = millis();
+					SmartThing->sendBatch(msgs, lengths, count);
+				}
+				else
+				{
+					SmartThing->send(msgs[0], lengths[0]);
+				}
 			#endif
 			#if defined(ENABLE_SERIAL) && defined(DISABLE_SMARTTHINGS)
-				Serial.println(Return_String.substring(0, index));
+				for (byte i = 0; i < count; ++i)
+				{
+					Serial.write(msgs[i], lengths[i]);
+					Serial.println();
+				}
 			#endif
 			
-			if(callOnMsgSend!=0)
+			for (byte i = 0; i < count; ++i)
 			{
-				callOnMsgSend(Return_String.substring(0, index));
+				if(callOnMsgSend!=0)
+				{
+					String str;		//only build a String copy when the sketch has asked for one
+					str.reserve(lengths[i]);
+					for (unsigned int j = 0; j < lengths[i]; ++j)
+					{
+						str += msgs[i][j];
+					}
+					Return_Queue.pop();
+					callOnMsgSend(str);
+				}
+				else
+				{
+					Return_Queue.pop();
+				}
 			}
-
-			Return_String=Return_String.substring(index+1);
 		}
-		Return_String.remove(0);	//clear the Return_String buffer
+
+		m_bSending = false;
+
+		#if defined(ENABLE_PROFILER)
+			if (Return_Queue.count() != queued)
+			{
+				m_PhaseStats[PHASE_SEND].record(micros() - start);	//only calls that sent something - most calls have nothing to send
+			}
+		#endif
 	}
 	
+	Device* Everything::getIndexedDevice(byte index)
+	{
+		if (index < m_nSensorCount)
+		{
+			return m_Sensors[index];
+		}
+		return m_Executors[index - m_nSensorCount];
+	}
+
+	void Everything::buildDeviceIndex()
+	{
+		//insertion sort - stable, so a Sensor still wins over an Executor with the same name, as with the old linear search
+		m_nDeviceIndexCount = 0;
+		for (byte i = 0; i < m_nSensorCount + m_nExecutorCount; ++i)
+		{
+			Device *p = getIndexedDevice(i);
+			byte j = m_nDeviceIndexCount;
+			while (j > 0 && getIndexedDevice(m_DeviceIndex[j - 1])->compareName(*p) > 0)
+			{
+				m_DeviceIndex[j] = m_DeviceIndex[j - 1];
+				--j;
+			}
+			m_DeviceIndex[j] = i;
+			++m_nDeviceIndexCount;
+		}
+	}
+
 	void Everything::refreshDevices()
 	{
 		static int refresh_Executor = 0;
@@ -149,11 +383,19 @@ namespace st
 		}
 	}
 
-//public
-	void Everything::init()
+	void Everything::useStorage(Sensor **sensors, byte maxSensors, Executor **executors, byte maxExecutors, byte *deviceIndex, Device **schedule)
+	{
+		m_Sensors = sensors;
+		m_nMaxSensors = maxSensors;
+		m_Executors = executors;
+		m_nMaxExecutors = maxExecutors;
+		m_DeviceIndex = deviceIndex;
+		m_Schedule = schedule;
+	}
+
+	void Everything::start()
 	{
 		Serial.begin(Constants::SERIAL_BAUDRATE);
-		Return_String.reserve(st::Constants::RETURN_STRING_RESERVE);	//allocate Return_String buffer one time to prevent Heap Fragmentation.  RETURN_STRING_RESERVE is set in Constants.h
 		
 		if(debug)
 		{
@@ -163,6 +405,7 @@ namespace st
 		}
 		
 		#ifndef DISABLE_SMARTTHINGS
+			SmartThing->setSendCallout(receiveSendResult);
 			SmartThing->init();
 		#endif
 		
@@ -175,6 +418,19 @@ namespace st
 		}
 	}
 
+//public
+	void Everything::init()
+	{
+		//only referenced from here, so a sketch that uses an st::Registry instead does not link these arrays
+		static Sensor* sensors[Constants::MAX_SENSOR_COUNT];
+		static Executor* executors[Constants::MAX_EXECUTOR_COUNT];
+		static byte deviceIndex[Constants::MAX_SENSOR_COUNT + Constants::MAX_EXECUTOR_COUNT];
+		static Device* schedule[Constants::MAX_SENSOR_COUNT + Constants::MAX_EXECUTOR_COUNT];
+
+		useStorage(sensors, Constants::MAX_SENSOR_COUNT, executors, Constants::MAX_EXECUTOR_COUNT, deviceIndex, schedule);
+		start();
+	}
+
 	void Everything::deepSleep(uint64_t time)
 	{
 		if(debug)
@@ -209,6 +465,18 @@ namespace st
 			m_Executors[index]->init();
 			sendStrings();
 		}
+
+		buildDeviceIndex();
+
+		//give every scheduled device a first update() on the next run() - just like before, that is when it starts its timing
+		for (byte index = 0; index < m_nSensorCount + m_nExecutorCount; ++index)
+		{
+			Device *p = getIndexedDevice(index);
+			if (p->m_bScheduled && (p->m_nScheduleIndex == Device::NOT_SCHEDULED))
+			{
+				scheduleDevice(p, millis());
+			}
+		}
 		
 		if(debug)
 		{
@@ -222,10 +490,14 @@ namespace st
 	
 	void Everything::run()
 	{
+		ST_PROFILE_START(updateStart);
 		updateDevices();			//call each st::Sensor object to refresh data
+		ST_PROFILE_END(m_PhaseStats[PHASE_UPDATE], updateStart);
 
 		#ifndef DISABLE_SMARTTHINGS
+			ST_PROFILE_START(runStart);
 			SmartThing->run();		//call the ST Shield Library to receive any data from the ST Hub
+			ST_PROFILE_END(m_PhaseStats[PHASE_RUN], runStart);
 		#endif
 		
 		#if defined(ENABLE_SERIAL)
@@ -238,7 +510,17 @@ namespace st
 		if ((bTimersPending == 0) && ((millis() - refLastMillis) >= long(Constants::DEV_REFRESH_INTERVAL) * 1000))  //DEV_REFRESH_INTERVAL is set in Constants.h
 		{
 			//refLastMillis = millis();
+			ST_PROFILE_START(refreshStart);
 			refreshDevices();	//call each st::Device object to refresh data (this is just a safeguard to ensure the state of the Arduino and the ST Cloud stay in synch should an event be missed)
+			ST_PROFILE_END(m_PhaseStats[PHASE_REFRESH], refreshStart);
+		}
+		#endif
+
+		#if defined(ENABLE_PROFILER)
+		if ((statsReportInterval > 0) && ((millis() - statsLastMillis) >= statsReportInterval * 1000UL))
+		{
+			statsLastMillis = millis();
+			sendStats();
 		}
 		#endif
 		
@@ -247,54 +529,276 @@ namespace st
 			lastmillis = millis();
 			Serial.print(F("Everything: Free Ram = "));  
 			Serial.println(freeRam());
+			Serial.print(F("Everything: Queue depth = "));
+			Serial.print(Return_Queue.count());
+			Serial.print(F(", max depth = "));
+			Serial.print(m_nQueueDepthMax);
+			Serial.print(F(", max wait (ms) = "));
+			Serial.print(m_nQueueWaitMax);
+			Serial.print(F(", coalesced = "));
+			Serial.print(m_nCoalescedCount);
+			Serial.print(F(", dropped = "));
+			Serial.print(m_nDroppedCount);
+			Serial.print(F(", send failed = "));
+			Serial.println(m_nSendFailedCount);
 		}
 	}
+
+	unsigned int Everything::getCoalesceKeyLength(const char *msg, unsigned int length)
+	{
+		//only plain numeric values are coalesced - text values such as "pushed", "held" or "active" are events,
+		//and the hub must see every one of them in order
+		unsigned int space = 0;
+		while (space < length && msg[space] != ' ')
+		{
+			++space;
+		}
+
+		unsigned int index = space + 1;
+		bool digits = false;
+		bool point = false;
+
+		if (index < length && (msg[index] == '-' || msg[index] == '+'))
+		{
+			++index;
+		}
+		for (; index < length; ++index)
+		{
+			if (msg[index] >= '0' && msg[index] <= '9')
+			{
+				digits = true;
+			}
+			else if (msg[index] == '.' && !point)
+			{
+				point = true;
+			}
+			else
+			{
+				return 0;
+			}
+		}
+
+		return (space > 0 && digits) ? space + 1 : 0;
+	}
 	
-	bool Everything::sendSmartString(String &str)
+#if defined(ENABLE_PROFILER)
+	void Everything::printStats()
 	{
-		while(str.length()>1 && str[0]=='|') //get rid of leading pipes (messes up sendStrings()'s parsing technique)
+		const __FlashStringHelper *phases[PHASE_COUNT] = {F("update"), F("send"), F("refresh"), F("run")};
+
+		Serial.println(F("Everything: stats (us)"));
+		for (byte i = 0; i < PHASE_COUNT; ++i)
 		{
-			str=str.substring(1);
+			Serial.print(F("  "));
+			Serial.print(phases[i]);
+			Serial.print(' ');
+			m_PhaseStats[i].print(Serial);
+			Serial.println();
 		}
-		if((str.length()==1 && str[0]=='|') || str.length()==0)
+		for (byte i = 0; i < m_nSensorCount; ++i)
 		{
-			return false;
+			Serial.print(F("  "));
+			Serial.print(m_Sensors[i]->getNamePtr());
+			Serial.print(' ');
+			m_Sensors[i]->m_UpdateStats.print(Serial);
+			Serial.println();
 		}
-		
-		if(Return_String.length()+str.length()>=Constants::RETURN_STRING_RESERVE)
+		for (byte i = 0; i < m_nExecutorCount; ++i)
+		{
+			Serial.print(F("  "));
+			Serial.print(m_Executors[i]->getNamePtr());
+			Serial.print(' ');
+			m_Executors[i]->m_UpdateStats.print(Serial);
+			Serial.println();
+		}
+
+		//the profiler's own cost per sample - a pair of micros() calls plus ProfileStats::record()
+		ProfileStats scratch;
+		unsigned long begin = micros();
+		for (byte i = 0; i < 100; ++i)
+		{
+			ST_PROFILE_START(start);
+			ST_PROFILE_END(scratch, start);
+		}
+		Serial.print(F("  profiler overhead per 100 samples = "));
+		Serial.println(micros() - begin);
+	}
+
+	void Everything::resetStats()
+	{
+		for (byte i = 0; i < PHASE_COUNT; ++i)
 		{
-			if (debug)
+			m_PhaseStats[i].reset();
+		}
+		for (byte i = 0; i < m_nSensorCount; ++i)
+		{
+			m_Sensors[i]->m_UpdateStats.reset();
+		}
+		for (byte i = 0; i < m_nExecutorCount; ++i)
+		{
+			m_Executors[i]->m_UpdateStats.reset();
+		}
+	}
+
+	void Everything::sendStats()
+	{
+		//one token, so the hub parent stores it as a single "stats" attribute - e.g. "stats update=63/412,send=...,worst=power1:255/2040"
+		const __FlashStringHelper *phases[PHASE_COUNT] = {F("update"), F("send"), F("refresh"), F("run")};
+		String str(F("stats "));
+
+		for (byte i = 0; i < PHASE_COUNT; ++i)
+		{
+			str += phases[i];
+			str += '=';
+			str += m_PhaseStats[i].getPercentile(99);
+			str += '/';
+			str += m_PhaseStats[i].getMax();
+			str += ',';
+		}
+
+		Device *worst = 0;
+		unsigned long worstP99 = 0;
+		for (byte i = 0; i < m_nSensorCount + m_nExecutorCount; ++i)
+		{
+			Device *p = (i < m_nSensorCount) ? (Device *)m_Sensors[i] : (Device *)m_Executors[i - m_nSensorCount];
+			unsigned long p99 = p->m_UpdateStats.getPercentile(99);
+			if (!worst || p99 > worstP99)
 			{
-				Serial.print(F("Everything: ERROR: \""));
-				Serial.print(str);
-				Serial.println(F("\" would overflow the Return_String 'buffer'"));
+				worst = p;
+				worstP99 = p99;
 			}
-			return false;
 		}
-		else
+		str += F("worst=");
+		if (worst)
 		{
-			Return_String+=str+"|";		//add the new message to the queue to be sent to ST Shield with a "|" delimiter
-			return true;
+			str += worst->getName();
+			str += ':';
+			str += worstP99;
+			str += '/';
+			str += worst->m_UpdateStats.getMax();
 		}
+		sendSmartString(str);
+	}
+#endif
+
+	bool Everything::sendSmartString(String &str)
+	{
+		const char *msg = str.c_str();
+		unsigned int length = str.length();
+		unsigned int start = 0;
+		bool queued = false;
+
+		//"|" still delimits multiple messages within one string - queue each non-empty piece as its own message
+		for (unsigned int index = 0; index <= length; ++index)
+		{
+			if (index < length && msg[index] != '|')
+			{
+				continue;
+			}
+
+			if (index > start)
+			{
+				//no coalescing while sendStrings() is running - the message being replaced might already be on its way
+				unsigned int keyLength = (coalesceReadings && !m_bSending) ? getCoalesceKeyLength(msg + start, index - start) : 0;
+				bool pushed = (keyLength > 0) && Return_Queue.coalesce(msg + start, index - start, keyLength);
+				if (pushed)
+				{
+					++m_nCoalescedCount;
+				}
+				else
+				{
+					pushed = Return_Queue.push(msg + start, index - start);
+				}
+				if (!pushed)
+				{
+					sendStrings();	//queue is full - send whatever transmit pacing allows right now, without waiting
+					pushed = Return_Queue.push(msg + start, index - start);
+				}
+				//still full - the oldest messages make room for the newest reading.  Not while sendStrings() is running,
+				//as the messages it is sending are still in the queue.
+				while (!pushed && !m_bSending && !Return_Queue.isEmpty())
+				{
+					if (debug)
+					{
+						const char *oldest;
+						unsigned int oldestLength;
+						Return_Queue.front(oldest, oldestLength);
+						Serial.print(F("Everything: ERROR: Return_Queue full - dropped \""));
+						Serial.write(oldest, oldestLength);
+						Serial.println(F("\""));
+					}
+					Return_Queue.pop();
+					++m_nDroppedCount;
+					pushed = Return_Queue.push(msg + start, index - start);
+				}
+				if (!pushed)
+				{
+					if (debug)
+					{
+						Serial.print(F("Everything: ERROR: \""));
+						Serial.write(msg + start, index - start);
+						Serial.println(F("\" would overflow the Return_Queue 'buffer'"));
+					}
+					++m_nDroppedCount;
+					return false;
+				}
+				queued = true;
+				if (Return_Queue.count() > m_nQueueDepthMax)
+				{
+					m_nQueueDepthMax = Return_Queue.count();
+				}
+			}
+			start = index + 1;
+		}
+
+		return queued;
 	}
 
 	bool Everything::sendSmartStringNow(String &str)
 	{
-		if (sendSmartString(str)) sendStrings(); //send any pending updates to ST Cloud immediately
+		if (sendSmartString(str))
+		{
+			sendStrings(); //send any pending updates to ST Cloud immediately, as far as transmit pacing allows
+			return true;
+		}
+		return false;
 	}
 
 	Device* Everything::getDeviceByName(const String &str)
 	{
-		for(unsigned int index=0; index<m_nSensorCount; ++index)
+		return getDeviceByName(str.c_str(), str.length());
+	}
+
+	Device* Everything::getDeviceByName(const char *str, unsigned int length)
+	{
+		if (m_nDeviceIndexCount != m_nSensorCount + m_nExecutorCount)
 		{
-			if(m_Sensors[index]->getName()==str)
-				return (Device*)m_Sensors[index];
+			buildDeviceIndex();	//devices were added after initDevices()
 		}
-		
-		for(unsigned int index=0; index<m_nExecutorCount; ++index)
+
+		//binary search for the first device whose name is not less than str
+		byte low = 0;
+		byte high = m_nDeviceIndexCount;
+		while (low < high)
+		{
+			byte mid = (low + high) / 2;
+			if (getIndexedDevice(m_DeviceIndex[mid])->compareName(str, length) < 0)
+			{
+				low = mid + 1;
+			}
+			else
+			{
+				high = mid;
+			}
+		}
+
+		if (low < m_nDeviceIndexCount)
 		{
-			if(m_Executors[index]->getName()==str)
-				return (Device*)m_Executors[index];
+			Device *p = getIndexedDevice(m_DeviceIndex[low]);
+			if (p->compareName(str, length) == 0)
+			{
+				return p;
+			}
 		}
 		
 		return 0; //null if no such device present
@@ -302,7 +806,7 @@ namespace st
 	
 	bool Everything::addSensor(Sensor *sensor)
 	{
-		if(m_nSensorCount>=Constants::MAX_SENSOR_COUNT)
+		if(m_nSensorCount>=m_nMaxSensors)
 		{
 			if(debug)
 			{
@@ -330,7 +834,7 @@ namespace st
 	
 	bool Everything::addExecutor(Executor *executor)
 	{
-		if(m_nExecutorCount>=Constants::MAX_EXECUTOR_COUNT)
+		if(m_nExecutorCount>=m_nMaxExecutors)
 		{
 			if(debug)
 			{
@@ -375,9 +879,20 @@ namespace st
 		{
 			Everything::refreshDevices();
 		}
+		#if defined(ENABLE_PROFILER)
+		else if (message == "stats")
+		{
+			Everything::printStats();
+		}
+		else if (message == "stats reset")
+		{
+			Everything::resetStats();
+		}
+		#endif
 		else if (message.length() > 1)		//ignore empty string messages from the ST Hub
 		{
-			Device *p = Everything::getDeviceByName(message.substring(0, message.indexOf(' ')));
+			int space = message.indexOf(' ');
+			Device *p = Everything::getDeviceByName(message.c_str(), (space < 0) ? message.length() : space);
 			if (p != 0)
 			{
 				p->beSmart(message);	//pass the incoming SmartThings Shield message to the correct Device's beSmart() routine
@@ -390,22 +905,63 @@ namespace st
 		}
 
 	}
+
+	void receiveSendResult(const char *message, unsigned int length, SmartThingsSendResult_t result)
+	{
+		if (result != STSEND_OK)
+		{
+			++Everything::m_nSendFailedCount;
+			if (Everything::debug)
+			{
+				Serial.print(F("Everything: Send failed ("));
+				Serial.print(result);
+				Serial.print(F("): "));
+				Serial.write((const uint8_t *)message, length);
+				Serial.println();
+			}
+		}
+
+		if (Everything::callOnSendResult != 0)
+		{
+			Everything::callOnSendResult(message, length, result);
+		}
+	}
 	
 	//initialize static members
 	st::SmartThings* Everything::SmartThing=0; //initialize pointer to null
-	String Everything::Return_String;
-	Sensor* Everything::m_Sensors[Constants::MAX_SENSOR_COUNT];
-	Executor* Everything::m_Executors[Constants::MAX_EXECUTOR_COUNT];
+	byte Everything::Return_Buffer[Constants::RETURN_STRING_RESERVE];
+	MessageQueue Everything::Return_Queue(Everything::Return_Buffer, Constants::RETURN_STRING_RESERVE);
+	Sensor** Everything::m_Sensors=0;	//set by init() or st::Registry::init()
+	Executor** Everything::m_Executors=0;
 	byte Everything::m_nSensorCount=0;
 	byte Everything::m_nExecutorCount=0;
+	byte Everything::m_nMaxSensors=0;
+	byte Everything::m_nMaxExecutors=0;
+	RegistryBase* Everything::m_pRegistry=0;
+	byte* Everything::m_DeviceIndex=0;
+	byte Everything::m_nDeviceIndexCount=0;
+	Device** Everything::m_Schedule=0;
+	byte Everything::m_nScheduleCount=0;
 	unsigned long Everything::lastmillis=0;
 	unsigned long Everything::refLastMillis=0;
-	unsigned long Everything::sendstringsLastMillis=0;
+	unsigned int Everything::m_nQueueDepthMax=0;
+	unsigned int Everything::m_nQueueWaitMax=0;
+	unsigned int Everything::m_nCoalescedCount=0;
+	unsigned int Everything::m_nDroppedCount=0;
+	unsigned int Everything::m_nSendFailedCount=0;
+	bool Everything::m_bSending=false;
+	#if defined(ENABLE_PROFILER)
+		ProfileStats Everything::m_PhaseStats[Everything::PHASE_COUNT];
+		unsigned long Everything::statsLastMillis=0;
+		unsigned int Everything::statsReportInterval=0;
+	#endif
 	bool Everything::debug=false;
+	bool Everything::coalesceReadings=false;
 	byte Everything::bTimersPending=0;	//initialize variable
 	void (*Everything::callOnMsgSend)(const String &msg)=0; //initialize this callback function to null
 	void (*Everything::callOnMsgRcvd)(const String &msg)=0; //initialize this callback function to null
 	void(*Everything::callOnMsgRcvd2)(String &msg) = 0; //initialize this callback function to null
+	void (*Everything::callOnSendResult)(const char *msg, unsigned int length, SmartThingsSendResult_t result) = 0; //initialize this callback function to null
 
 	//SmartThings static members
 	//#ifndef DISABLE_SMARTTHINGS
@@ -26,6 +26,16 @@
 //    2019-02-09  Dan Ogorchock  Add update() call to Executors in support of devices like EX_Servo that need a non-blocking mechanism
 //    2019-02-24  Dan Ogorchock  Added new special callOnMsgRcvd2 callback capability. Allows recvd string to be manipulated in the sketch before being processed by Everything.
 //    2020-08-22  a00889920      Added deepSleep() function
+//    2026-10-16  a00889920      Replaced Return_String with a fixed-size st::MessageQueue to eliminate heap fragmentation
+//    2026-10-16  a00889920      Non-blocking transmit pacing using the SmartThings token bucket, plus queue statistics
+//    2026-10-16  a00889920      getDeviceByName() uses a sorted name index and binary search instead of a linear String compare
+//    2026-10-16  a00889920      Added a min-heap scheduler so scheduled devices are only updated when their wake time arrives
+//    2026-10-16  a00889920      Added optional coalescing of queued numeric readings (coalesceReadings) and coalesced/dropped message counters
+//    2026-10-16  a00889920      sendStrings() sends up to MAX_BATCH_COUNT queued messages in one transmission when SmartThings::setMaxBatchSize() is set
+//    2026-10-16  a00889920      Added optional profiler (ENABLE_PROFILER) - per device and per phase timings, "stats" command and periodic stats report
+//    2026-10-16  a00889920      Added receiveSendResult() - counts failed background sends and passes each result to callOnSendResult
+//    2026-10-16  a00889920      A full Return_Queue drops its oldest messages to make room instead of waiting for transmit pacing
+//    2026-10-16  a00889920      Device storage is given to Everything by init() (Constants.h sized) or by an st::Registry (exactly sized)
 //
 //******************************************************************************************
 
@@ -38,27 +48,62 @@
 #include "Executor.h"
 
 #include "SmartThings.h"
+#include "MessageQueue.h"
+#include "ProfileStats.h"
 
 namespace st
 {
 	SmartThingsCallout_t receiveSmartString;	//function prototype for ST Library callback function
+	SmartThingsSendCallout_t receiveSendResult;	//function prototype for ST Library send result callback function
+
+	class RegistryBase;
+	class RegistryAccess;
 
 	class Everything
 	{
 		private:
-			static Sensor* m_Sensors[Constants::MAX_SENSOR_COUNT];		//array of Sensor objects that st::Everything will keep track of
+			//device storage - Constants.h sized arrays from init(), or sized for exactly the sketch's devices by an st::Registry (see Registry.h)
+			static Sensor** m_Sensors;		//array of Sensor objects that st::Everything will keep track of
 			static byte m_nSensorCount;	//number of st::Sensor objects added to st::Everything in your sketch Setup() routine
+			static byte m_nMaxSensors;		//number of Sensors m_Sensors has room for
 			
-			static Executor* m_Executors[Constants::MAX_EXECUTOR_COUNT]; //array of Executor objects that st::Everything will keep track of
+			static Executor** m_Executors; //array of Executor objects that st::Everything will keep track of
 			static byte m_nExecutorCount;//number of st::Executor objects added to st::Everything in your sketch Setup() routine
+			static byte m_nMaxExecutors;	//number of Executors m_Executors has room for
+			
+			static RegistryBase* m_pRegistry;	//the st::Registry holding the storage, which also updates its devices - null after init()
+			static void useStorage(Sensor **sensors, byte maxSensors, Executor **executors, byte maxExecutors, byte *deviceIndex, Device **schedule);
+			static void start();				//initialization shared by init() and st::Registry::init()
+			friend class RegistryAccess;
 			
+			static byte* m_DeviceIndex;		//all devices sorted by name (values < m_nSensorCount are Sensors, the rest Executors) - room for every device
+			static byte m_nDeviceIndexCount;	//number of entries in m_DeviceIndex - rebuilt if it no longer matches the number of devices
+			static Device* getIndexedDevice(byte index);	//returns the Device an m_DeviceIndex entry refers to
+			static void buildDeviceIndex();		//sorts all devices by name into m_DeviceIndex - called at the end of initDevices()
+
+			//scheduler - min-heap of the scheduled Devices that are waiting for their wake time (see Device::scheduleUpdate())
+			static Device** m_Schedule;		//room for every device
+			static byte m_nScheduleCount;		//number of Devices in m_Schedule
+			static bool wakesBefore(const Device *a, const Device *b);	//millis() rollover safe comparison of wake times
+			static void placeInSchedule(Device *device, byte index);
+			static void siftUp(byte index);
+			static void siftDown(byte index);
+			static void scheduleDevice(Device *device, unsigned long wakeTime);
+			static void unscheduleDevice(Device *device);
+			friend class Device;
 			
 			//static SmartThingsNetworkState_t stNetworkState;
 		
 			//static void updateNetworkState();	//keeps track of the current ST Shield to Hub network status
 			static void updateDevices();		//simply calls update on all the sensors
-			static void sendStrings();			//sends all updates from the devices in Return_String
-			static unsigned long sendstringsLastMillis;	//keep track of how long since last time we sent data to ST Cloud, to enable throttling
+			static void sendStrings();			//sends queued updates as fast as transmit pacing allows - never waits for it
+			static unsigned int m_nQueueDepthMax;	//largest number of messages seen waiting in Return_Queue
+			static unsigned int m_nQueueWaitMax;	//longest time (ms) a message has waited in Return_Queue before being sent
+			static unsigned int m_nCoalescedCount;	//number of messages that replaced an older reading still waiting in Return_Queue
+			static unsigned int m_nDroppedCount;	//number of messages lost because Return_Queue was full (the oldest, to make room for a new one)
+			static unsigned int m_nSendFailedCount;	//number of messages a background send reported as not delivered to the hub
+			static bool m_bSending;				//true while sendStrings() is sending - prevents re-entry from a callback
+			static unsigned int getCoalesceKeyLength(const char *msg, unsigned int length);	//length of the "name " key if msg is a numeric reading, else 0
 
 			static unsigned long lastmillis;	//used to keep track of last time run() has output freeRam() info
 			
@@ -66,14 +111,26 @@ namespace st
 			static unsigned long refLastMillis;	//used to keep track of last time run() has called refreshDevices()
 			static void refreshDevices();		//simply calls refresh on all the Devices
 
+			#if defined(ENABLE_PROFILER)
+				static const byte PHASE_UPDATE = 0;		//updateDevices()
+				static const byte PHASE_SEND = 1;		//sendStrings() calls that sent something
+				static const byte PHASE_REFRESH = 2;	//refreshDevices()
+				static const byte PHASE_RUN = 3;		//SmartThing->run()
+				static const byte PHASE_COUNT = 4;
+				static ProfileStats m_PhaseStats[PHASE_COUNT];	//time spent in each phase of run()
+				static unsigned long statsLastMillis;	//used to keep track of the last time run() sent a stats report
+				static void sendStats();			//queues a compact one line stats report for the hub
+			#endif
+
 			#ifdef ENABLE_SERIAL
 				static void readSerial();		//reads data from Arduino IDE Serial Monitor, if enabled in Constants.h
 			#endif
 		
-			static String Return_String;		//static buffer for string data queued for transfer to SmartThings Shield - prevents dynamic memory allocation heap fragmentation
+			static byte Return_Buffer[Constants::RETURN_STRING_RESERVE];	//static storage for Return_Queue - prevents dynamic memory allocation heap fragmentation
+			static MessageQueue Return_Queue;	//queue of messages waiting to be transferred to SmartThings
 		
 		public:
-			static void init();					//st::Everything initialization routine called in your sketch setup() routine 
+			static void init();					//st::Everything initialization routine called in your sketch setup() routine (or st::Registry::init() instead)
 			static void initDevices();			//calls the init() routine of every object added to st::Everything in your sketch setup() routine 
 			static void run();					//st::Everything initialization routine called in your sketch loop() routine 
 			static void deepSleep(uint64_t time);	//Puts device into Deepsleep 
@@ -82,6 +139,15 @@ namespace st
 			static bool sendSmartStringNow(String &str); //sendSmartStringNow() may edit the string reference passed to it - sends messages immediate - only for special circumstances
 
 			static Device* getDeviceByName(const String &str);	//returns pointer to Device object by name
+			static Device* getDeviceByName(const char *str, unsigned int length);	//returns pointer to Device object by name (str need not be null terminated)
+
+			static unsigned int getQueueDepth() {return Return_Queue.count();}	//number of messages currently waiting to be sent
+			static unsigned int getQueueDepthMax() {return m_nQueueDepthMax;}	//largest number of messages seen waiting to be sent
+			static unsigned int getQueueWaitMax() {return m_nQueueWaitMax;}	//longest time (ms) a message has waited to be sent
+			static unsigned int getCoalescedCount() {return m_nCoalescedCount;}	//number of queued readings replaced by a newer value
+			static unsigned int getDroppedCount() {return m_nDroppedCount;}	//number of messages lost because the queue was full
+			static unsigned int getSendFailedCount() {return m_nSendFailedCount;}	//number of messages the transport could not deliver (background sends only)
+			static void resetQueueStats() {m_nQueueDepthMax = 0; m_nQueueWaitMax = 0; m_nCoalescedCount = 0; m_nDroppedCount = 0; m_nSendFailedCount = 0;}
 			
 			static bool addSensor(Sensor *sensor);		//adds a Sensor object to st::Everything's m_Sensors[] array - called in your sketch setup() routine
 			static bool addExecutor(Executor *executor);//adds a Executor object to st::Everything's m_Executors[] array - called in your sketch setup() routine
@@ -89,10 +155,19 @@ namespace st
 			static byte bTimersPending;	//number of time critical events in progress - if > 0, do NOT perform refreshDevices() routine 
 
 			static bool debug;	//debug flag to determine if debug print statements are executed - set value in your sketch's setup() routine
+
+			#if defined(ENABLE_PROFILER)
+				static void printStats();		//prints the time spent in each phase of run() and in each device's update() - also done on receipt of "stats"
+				static void resetStats();		//forgets all timings collected so far - also done on receipt of "stats reset"
+				static unsigned int statsReportInterval;	//seconds between compact "stats" reports sent to the hub (0 = never) - set value in your sketch's setup() routine
+			#endif
+
+			static bool coalesceReadings;	//if true, a new numeric reading (e.g. "power1 123") replaces one for the same device that has not been sent yet - set value in your sketch's setup() routine
 			
 			static void (*callOnMsgSend)(const String &msg); //If this function pointer is assigned, the function it points to will be called upon every time a string is sent to the cloud.		
 			static void (*callOnMsgRcvd)(const String &msg); //If this function pointer is assigned, the function it points to will be called upon every time a string is received from the cloud.
 			static void(*callOnMsgRcvd2)(String &msg); //If this function pointer is assigned, the function it points to will be called upon every time a string is received from the cloud.
+			static void (*callOnSendResult)(const char *msg, unsigned int length, SmartThingsSendResult_t result); //If this function pointer is assigned, it is called with the result of every message a transport sends in the background (e.g. ESP32).
 
 			//SmartThings Object
 			#ifndef DISABLE_SMARTTHINGS
@@ -100,6 +175,7 @@ namespace st
 			#endif
 
 			friend SmartThingsCallout_t receiveSmartString; //callback function to act on data received from SmartThings Shield - called from SmartThings Shield Library
+			friend SmartThingsSendCallout_t receiveSendResult; //callback function told how each background send ended - called from SmartThings Shield Library
 			
 			//SmartThings Object
 			//#ifndef DISABLE_SMARTTHINGS
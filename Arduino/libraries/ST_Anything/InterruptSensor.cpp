@@ -13,6 +13,8 @@
 //    2015-01-03  Dan & Daniel   Original Creation
 //	  2015-03-17  Dan			 Added optional "numReqCounts" constructor argument/capability
 //    2019-09-22  Dan Ogorchock  ESP8266 support for using A0 pin as a digital input
+//    2026-10-16  a00889920      Optional hardware interrupt mode with a lock-free pin change queue (ENABLE_INTERRUPT_ISR)
+//    2026-10-16  a00889920      A press and release lost to a full queue is still reported - the lost count is read with interrupts off
 //
 //
 //******************************************************************************************
@@ -24,12 +26,216 @@
 
 namespace st
 {
+#if defined(ENABLE_INTERRUPT_ISR)
+	static const byte EDGE_QUEUE_MASK = Constants::INTERRUPT_QUEUE_SIZE - 1;
+	static const byte EDGE_LEVEL_HIGH = 0x80;	//set in s_EdgeSlot[] when the pin read HIGH after the change
+	static const byte EDGE_SLOT_MASK = 0x7F;
+
+	//Pin changes recorded by the interrupt handlers.  The handlers are the only writer of s_nEdgeHead and
+	//loop() is the only writer of s_nEdgeTail, so single byte index updates are all the locking required.
+	static volatile unsigned long s_EdgeMicros[Constants::INTERRUPT_QUEUE_SIZE];
+	static volatile byte s_EdgeSlot[Constants::INTERRUPT_QUEUE_SIZE];
+	static volatile byte s_nEdgeHead = 0;
+	static volatile byte s_nEdgeTail = 0;
+	static volatile unsigned int s_nLostEdges = 0;
+	static volatile byte s_nLostSlots = 0;		//bit per slot that had a change dropped since loop() last looked
+	static unsigned int s_nLostEdgesHandled = 0;
+
+	static InterruptSensor* s_IsrSensors[8];
+	static volatile byte s_IsrPins[8];
+
+	static void ST_ISR_ATTR queueEdge(byte slot)
+	{
+		byte head = s_nEdgeHead;
+		byte next = (head + 1) & EDGE_QUEUE_MASK;
+
+		if (next == s_nEdgeTail)
+		{
+			s_nLostEdges++;		//queue full - loop() will re-read the pin
+			s_nLostSlots |= (1 << slot);
+			return;
+		}
+		s_EdgeMicros[head] = micros();
+		s_EdgeSlot[head] = slot | (digitalRead(s_IsrPins[slot]) ? EDGE_LEVEL_HIGH : 0);
+		s_nEdgeHead = next;
+	}
+
+	//attachInterrupt() handlers take no arguments, so each slot gets its own small handler
+	template <byte slot> static void ST_ISR_ATTR isrHandler()
+	{
+		queueEdge(slot);
+	}
+
+	static void (* const s_IsrHandlers[8])() = { isrHandler<0>, isrHandler<1>, isrHandler<2>, isrHandler<3>, isrHandler<4>, isrHandler<5>, isrHandler<6>, isrHandler<7> };
+	static const byte MAX_ISR_SENSORS = sizeof(s_IsrHandlers) / sizeof(s_IsrHandlers[0]);
+#endif
+
 //private
 
+#if defined(ENABLE_INTERRUPT_ISR)
+	//Hooks the pin to a free interrupt handler, if the board supports an interrupt on this pin.  Otherwise the pin stays polled.
+	void InterruptSensor::attachIsr()
+	{
+		if (m_nIsrSlot != NO_ISR_SLOT)
+		{
+			return;
+		}
+#if defined(ARDUINO_ARCH_ESP8266)
+		if (m_nInterruptPin == A0)
+		{
+			return;
+		}
+#endif
+#if defined(NOT_AN_INTERRUPT)
+		if (digitalPinToInterrupt(m_nInterruptPin) == NOT_AN_INTERRUPT)
+		{
+			return;
+		}
+#endif
+		for (byte slot = 0; slot < MAX_ISR_SENSORS; slot++)
+		{
+			if (s_IsrSensors[slot] == 0)
+			{
+				s_IsrSensors[slot] = this;
+				s_IsrPins[slot] = m_nInterruptPin;
+				m_nIsrSlot = slot;
+				m_bEdgePending = false;
+				attachInterrupt(digitalPinToInterrupt(m_nInterruptPin), s_IsrHandlers[slot], CHANGE);
+				return;
+			}
+		}
+	}
+
+	void InterruptSensor::detachIsr()
+	{
+		if (m_nIsrSlot == NO_ISR_SLOT)
+		{
+			return;
+		}
+		detachInterrupt(digitalPinToInterrupt(m_nInterruptPin));
+		processEdges();		//hand off anything already queued for this slot before it can be reused
+		s_IsrSensors[m_nIsrSlot] = 0;
+		m_nIsrSlot = NO_ISR_SLOT;
+		m_bEdgePending = false;
+	}
+
+	//Debounces in the time domain - an earlier change that stayed put for the debounce time is real, so act on it
+	//before moving on to the next one.  Changes are handled in order, so a press and release are both seen even if
+	//loop() was busy while they happened.
+	void InterruptSensor::queueState(bool inputState, unsigned long time)
+	{
+		if (m_bEdgePending && (time - m_lPendingMicros >= m_lDebounceMicros))
+		{
+			m_bEdgePending = false;
+			setState(m_bPendingState);
+		}
+		m_bPendingState = inputState;
+		m_lPendingMicros = time;
+		m_bEdgePending = true;
+	}
+
+	//Some of this pin's changes were dropped.  If the pin is back where the sensor last saw it, an even number of changes
+	//was lost - at least a press and a release (or a release and a press), so report that pair rather than nothing.
+	//Several lost pairs still count as one.  Otherwise the lost changes add up to one, which is debounced as usual.
+	void InterruptSensor::resyncState(bool inputState, unsigned long time)
+	{
+		bool lastState = m_bStatus ? m_bInterruptState : !m_bInterruptState;
+		if (m_bEdgePending)
+		{
+			//the pin was left there when the changes were lost, so it did not bounce straight back
+			m_bEdgePending = false;
+			setState(m_bPendingState);
+			lastState = m_bPendingState;
+		}
+
+		if (inputState == lastState)
+		{
+			setState(!inputState);
+			setState(inputState);
+		}
+		else
+		{
+			queueState(inputState, time);
+		}
+	}
+
+	void InterruptSensor::processEdges()
+	{
+		byte tail = s_nEdgeTail;
+
+		while (tail != s_nEdgeHead)
+		{
+			unsigned long time = s_EdgeMicros[tail];
+			byte slot = s_EdgeSlot[tail];
+			tail = (tail + 1) & EDGE_QUEUE_MASK;
+			s_nEdgeTail = tail;		//free the entry before calling out to the sensor
+
+			InterruptSensor *sensor = s_IsrSensors[slot & EDGE_SLOT_MASK];
+			if (sensor)
+			{
+				sensor->queueState((slot & EDGE_LEVEL_HIGH) != 0, time);
+			}
+		}
+
+		//if changes were dropped the order is unknown, so resynchronize each sensor that lost one with its pin as it is right now
+		noInterrupts();		//the count is two bytes on AVR, so an interrupt could tear the read
+		unsigned int lost = s_nLostEdges;
+		byte lostSlots = s_nLostSlots;
+		s_nLostSlots = 0;
+		interrupts();
+
+		if (lost != s_nLostEdgesHandled)
+		{
+			s_nLostEdgesHandled = lost;
+			for (byte slot = 0; slot < MAX_ISR_SENSORS; slot++)
+			{
+				if (s_IsrSensors[slot] && (lostSlots & (1 << slot)))
+				{
+					s_IsrSensors[slot]->resyncState(digitalRead(s_IsrPins[slot]), micros());
+				}
+			}
+			if (debug)
+			{
+				Serial.print(F("InterruptSensor: pin change queue overflowed, lost count = "));
+				Serial.println(lost);
+			}
+		}
+	}
+#endif
+
+	//Acts on a (debounced) pin state - calls runInterrupt() or runInterruptEnded() when the status changes
+	void InterruptSensor::setState(bool inputState)
+	{
+		if (inputState == m_bInterruptState && !m_bStatus) //new interrupt
+		{
+			m_bStatus = true;
+			m_bInitRequired = false;
+			runInterrupt();
+		}
+		else if ((inputState != m_bInterruptState && m_bStatus) || m_bInitRequired) //interrupt has ended OR Init called us
+		{
+			m_bStatus = false;
+			m_bInitRequired = false;
+			runInterruptEnded();
+		}
+	}
+
 	//Checks to see if the pin has changed state.  If so calls appropriate function.
 	void InterruptSensor::checkIfTriggered()
 	{
             bool inputState;
+#if defined(ENABLE_INTERRUPT_ISR)
+			if (m_nIsrSlot != NO_ISR_SLOT)
+			{
+				processEdges();
+				if (m_bEdgePending && (micros() - m_lPendingMicros >= m_lDebounceMicros))
+				{
+					m_bEdgePending = false;
+					setState(m_bPendingState);
+				}
+				return;
+			}
+#endif
 #if defined(ARDUINO_ARCH_ESP8266)
             if (m_nInterruptPin == A0) 
 			{
@@ -85,18 +291,37 @@ namespace st
 		m_nCurrentDownCount(numReqCounts),
 		m_nLoopCounter(0)
 		{
+#if defined(ENABLE_INTERRUPT_ISR)
+			m_nIsrSlot = NO_ISR_SLOT;
+			m_bEdgePending = false;
+			m_bPendingState = false;
+			m_lPendingMicros = 0;
+			m_lDebounceMicros = Constants::INTERRUPT_DEBOUNCE_MS * 1000UL;
+#endif
 			setInterruptPin(pin);
 		}
 	
 	//destructor
 	InterruptSensor::~InterruptSensor()
 	{
-	
+#if defined(ENABLE_INTERRUPT_ISR)
+		detachIsr();
+#endif
 	}
 	
 	//initialization function
 	void InterruptSensor::init()
 	{
+#if defined(ENABLE_INTERRUPT_ISR)
+		//interrupts are attached here rather than in the constructor, which runs before the board is set up
+		attachIsr();
+		if (m_nIsrSlot != NO_ISR_SLOT)
+		{
+			m_bEdgePending = false;
+			setState(digitalRead(m_nInterruptPin));
+			return;
+		}
+#endif
 		checkIfTriggered();
 	}
 	
@@ -127,6 +352,10 @@ namespace st
 	//sets the pin to be monitored, and set the Arduino pinMode based on constructor data
 	void InterruptSensor::setInterruptPin(byte pin)
 	{
+#if defined(ENABLE_INTERRUPT_ISR)
+		bool reattach = (m_nIsrSlot != NO_ISR_SLOT);
+		detachIsr();
+#endif
 		m_nInterruptPin=pin;
 
 #if defined(ARDUINO_ARCH_ESP8266)
@@ -144,6 +373,40 @@ namespace st
 		{
 			pinMode(m_nInterruptPin, INPUT_PULLUP);
 		}
+#if defined(ENABLE_INTERRUPT_ISR)
+		if (reattach)
+		{
+			attachIsr();
+		}
+#endif
+	}
+
+	void InterruptSensor::setDebounceTime(unsigned int ms)
+	{
+#if defined(ENABLE_INTERRUPT_ISR)
+		m_lDebounceMicros = ms * 1000UL;
+#endif
+	}
+
+	bool InterruptSensor::isInterruptDriven() const
+	{
+#if defined(ENABLE_INTERRUPT_ISR)
+		return m_nIsrSlot != NO_ISR_SLOT;
+#else
+		return false;
+#endif
+	}
+
+	unsigned int InterruptSensor::getLostEdgeCount()
+	{
+#if defined(ENABLE_INTERRUPT_ISR)
+		noInterrupts();
+		unsigned int lost = s_nLostEdges;
+		interrupts();
+		return lost;
+#else
+		return 0;
+#endif
 	}
 	
 	//debug flag to determine if debug print statements are executed (set value in your sketch)
@@ -6,6 +6,14 @@
 //			  parent class for the st::IS_Motion, IS_Contact, and IS_DoorControl classes.
 //			  In general, this file should not need to be modified.   
 //
+//			  If ENABLE_INTERRUPT_ISR is defined in Constants.h, sensors on pins that support
+//			  attachInterrupt() record each pin change (with a micros() timestamp) from a
+//			  hardware interrupt into a small lock-free queue shared by all InterruptSensors.
+//			  update() drains that queue in order and only believes a change once the pin has
+//			  stayed put for the debounce time, so short pulses are caught even if loop() is
+//			  busy elsewhere.  Other pins (and the ESP8266 A0 pin) keep using the polled,
+//			  count based debounce.
+//
 //  Change History:
 //
 //    Date        Who            What
@@ -13,6 +21,7 @@
 //    2015-01-03  Dan & Daniel   Original Creation
 //	  2015-03-17  Dan			 Added optional "numReqCounts" constructor argument/capability
 //    2019-09-22  Dan Ogorchock  ESP8266 support for using A0 pin as a digital input
+//    2026-10-16  a00889920      Optional hardware interrupt mode with a lock-free pin change queue (ENABLE_INTERRUPT_ISR)
 //
 //
 //******************************************************************************************
@@ -21,6 +30,7 @@
 #define ST_INTERRUPTSENSOR_H
 
 #include "Sensor.h"
+#include "Constants.h"
 
 namespace st
 {
@@ -37,7 +47,24 @@ namespace st
 			long m_nCurrentDownCount;
 			long m_nLoopCounter;
 
+#if defined(ENABLE_INTERRUPT_ISR)
+			static const byte NO_ISR_SLOT = 0xFF;
+
+			byte m_nIsrSlot;				//index into the interrupt handler table, NO_ISR_SLOT when the pin is polled
+			bool m_bEdgePending;			//true == a pin change is waiting out the debounce time
+			bool m_bPendingState;			//pin state after the pending change
+			unsigned long m_lPendingMicros;	//micros() when the pending change happened
+			unsigned long m_lDebounceMicros;	//how long the pin must be stable before a change is believed
+
+			void attachIsr();
+			void detachIsr();
+			void queueState(bool inputState, unsigned long time);
+			void resyncState(bool inputState, unsigned long time);	//catches up with the pin after changes were dropped
+			static void processEdges();		//moves the pin changes recorded by the interrupt handlers to their sensors
+#endif
+
 			void checkIfTriggered(); 
+			void setState(bool inputState);
 			
 		public:
 			//constructor
@@ -67,6 +94,13 @@ namespace st
 			//sets
 			void setInterruptPin(byte pin);
 			void setInterruptState(bool b) {m_bInterruptState=b;}
+			void setDebounceTime(unsigned int ms);	//only used when ENABLE_INTERRUPT_ISR is defined
+
+			//true if the sensor is driven by a hardware interrupt rather than polled
+			bool isInterruptDriven() const;
+
+			//number of pin changes dropped because loop() did not drain the queue in time (the pins are re-read when this happens - see INTERRUPT_QUEUE_SIZE)
+			static unsigned int getLostEdgeCount();
 	
 			//debug flag to determine if debug print statements are executed (set value in your sketch)
 			static bool debug;
@@ -32,6 +32,7 @@
 //    2015-01-03  Dan & Daniel   Original Creation
 //    2017-08-30  Dan Ogorchock  Modified comment section above to comply with new Parent/Child Device Handler requirements
 //	  2019-12-23  D. Johnson	 Created 10k_Thermistor using PS_Illuminance as example
+//	  2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
 //
 //******************************************************************************************
 
@@ -69,6 +70,11 @@ namespace st
 	//SmartThings Shield data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
 	void PS_10kThermistor::beSmart(const String &str)
 	{
+		if (beSmartReportPolicy(str))
+		{
+			return;	//deadband, minreport or heartbeat command
+		}
+
 		String s = str.substring(str.indexOf(' ') + 1);
 
 		if (s.toInt() != 0) {
@@ -127,7 +133,10 @@ namespace st
 			m_nSensorValue = Temp1C;
 		}
 		
-		Everything::sendSmartString(getName() + " " + String(m_nSensorValue));
+		if (shouldReport(m_nSensorValue))
+		{
+			Everything::sendSmartString(getName() + " " + String(m_nSensorValue));
+		}
 	}
 	void PS_10kThermistor::setPin(byte pin)
 	{
@@ -32,6 +32,7 @@
 //    2015-01-03  Dan & Daniel   Original Creation
 //    2017-08-30  Dan Ogorchock  Modified comment section above to comply with new Parent/Child Device Handler requirements
 //	  2019-12-23  D. Johnson	 Created 10k_Thermistor using PS_Illuminance as example
+//	  2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
 //
 //******************************************************************************************
 
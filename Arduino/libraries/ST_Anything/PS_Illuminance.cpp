@@ -35,6 +35,7 @@
 //    ----        ---            ----
 //    2015-01-03  Dan & Daniel   Original Creation
 //    2017-08-30  Dan Ogorchock  Modified comment section above to comply with new Parent/Child Device Handler requirements
+//    2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
 //
 //
 //******************************************************************************************
@@ -71,6 +72,11 @@ namespace st
 	//SmartThings Shield data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
 	void PS_Illuminance::beSmart(const String &str)
 	{
+		if (beSmartReportPolicy(str))
+		{
+			return;	//deadband, minreport or heartbeat command
+		}
+
 		String s = str.substring(str.indexOf(' ') + 1);
 
 		if (s.toInt() != 0) {
@@ -95,7 +101,10 @@ namespace st
 	{
 		int m_nSensorValue=map(analogRead(m_nAnalogInputPin), SENSOR_LOW, SENSOR_HIGH, MAPPED_LOW, MAPPED_HIGH);
 		
-		Everything::sendSmartString(getName() + " " + String(m_nSensorValue));
+		if (shouldReport(m_nSensorValue))
+		{
+			Everything::sendSmartString(getName() + " " + String(m_nSensorValue));
+		}
 	}
 	
 	void PS_Illuminance::setPin(byte pin)
@@ -35,6 +35,7 @@
 //    ----        ---            ----
 //    2015-01-03  Dan & Daniel   Original Creation
 //    2018-08-30  Dan Ogorchock  Modified comment section above to comply with new Parent/Child Device Handler requirements
+//    2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
 //
 //
 //******************************************************************************************
@@ -27,6 +27,7 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2017-07-04  Dan Ogorchock  Original Creation
+//    2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
 //
 //
 //******************************************************************************************
@@ -61,6 +62,11 @@ namespace st
 	//SmartThings data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
 	void PS_MQ2_Smoke::beSmart(const String &str)
 	{
+		if (beSmartReportPolicy(str))
+		{
+			return;	//deadband, minreport or heartbeat command
+		}
+
 		String s = str.substring(str.indexOf(' ') + 1);
 
 		if (s.toInt() != 0) {
@@ -85,7 +91,11 @@ namespace st
 	{
 		int m_nSensorValue=analogRead(m_nAnalogInputPin);
 		
-		Everything::sendSmartString(getName() + (m_nSensorValue < m_nSensorLimit ? F(" clear") : F(" detected")));
+		bool detected = (m_nSensorValue >= m_nSensorLimit);
+		if (shouldReport(detected ? 1 : 0))
+		{
+			Everything::sendSmartString(getName() + (detected ? F(" detected") : F(" clear")));
+		}
 
 		if (st::PollingSensor::debug)
 		{
@@ -27,6 +27,7 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2017-07-04  Dan Ogorchock  Original Creation
+//    2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
 //
 //
 //******************************************************************************************
@@ -7,6 +7,11 @@
 //			  voltage on an analog input pin via the EmonLib.  This produce the Irms current of the Current Transformer.
 //            The Irms current is then multiplied by the voltage constant passed in to produce Power in Watts.
 //
+//			  The current is sampled in the background:  every pass through loop() takes a short slice of analog readings
+//			  and adds them to a running sum of squares, with the DC offset tracked by EmonLib's low-pass filter.  Each
+//			  numSamples readings make a window, whose Irms is worked out as calcIrms() would.  getData() reports the mean
+//			  of the windows since the last poll, so each value covers the whole polling interval rather than a single
+//			  calcIrms() snapshot, and the loop is never held up for more than a slice.
 //
 //			  Create an instance of this class in your sketch's global variable section
 //			  For Example:  st::PS_Power sensor1(F("power1"), 120, 0, PIN_POWER, 30.0, 1480, 120.0);
@@ -17,7 +22,7 @@
 //				- long offset - REQUIRED - the polling interval offset in seconds - used to prevent all polling sensors from executing at the same time
 //				- byte pin - REQUIRED - the Arduino Pin to be used as an analog input
 //              - double ICAL - REQUIRED - EmonLib Calibration Constant
-//				- unsigned int numSamples - OPTIONAL - defaults to 1480, number of analog readings to use for calculating the Irms Current
+//				- unsigned int numSamples - OPTIONAL - defaults to 1480, number of analog readings in each window used for calculating the Irms Current
 //              - float voltage - OPTIONAL - defaults to 120, AC voltage of the mains line being monitored
 //				- byte filterConstant - OPTIONAL - Value from 5% to 100% to determine how much filtering/averaging is performed 100 = none (default), 5 = maximum
 //
@@ -29,6 +34,8 @@
 //    ----        ---            ----
 //    2019-02-17  Dan Ogorchock  Original Creation
 //    2019-09-19  Dan Ogorchock  Added filtering optional argument to help reduce noisy signals
+//    2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
+//    2026-10-16  a00889920      Background sampling over the whole polling interval instead of blocking calcIrms() calls
 //
 //
 //******************************************************************************************
@@ -40,7 +47,48 @@
 
 namespace st
 {
+	static const byte SETTLE_WINDOWS = 5;	//windows thrown away while the DC offset filter settles, as init() used to throw away 5 calcIrms() results
+
+	//analogRead() too often upsets the ESP8266's WiFi, so it takes one reading every few ms - elsewhere a slice lasts about 1 ms
+#if defined(ARDUINO_ARCH_ESP8266)
+	static const unsigned int SLICE_US = 0;
+	static const unsigned int SLICE_GAP_MS = 5;
+#else
+	static const unsigned int SLICE_US = 1000;
+	static const unsigned int SLICE_GAP_MS = 0;
+#endif
+
 //private
+	void PS_Power::sampleSlice()
+	{
+		unsigned long start = micros();
+		do
+		{
+			int sample = analogRead(m_nAnalogInputPin);
+
+			//EmonLib's digital low pass filter extracts the dc offset (offset += (sample - offset) / 1024), in fixed point
+			m_lOffset += sample - (m_lOffset >> 10);
+			long filtered = ((long)sample << 3) - ((m_lOffset + 64) >> 7);	//in 1/8ths of a count
+
+			m_nSumSquares += (unsigned long)(filtered * filtered);
+			m_nSampleCount++;
+		} while (((micros() - start) < SLICE_US) && (m_nSampleCount < m_nNumSamples));
+
+		if (m_nSampleCount >= m_nNumSamples)
+		{
+			if (m_nSettling > 0)
+			{
+				m_nSettling--;
+			}
+			else
+			{
+				m_fRmsSum += sqrt((double)m_nSumSquares / m_nSampleCount) / 8;
+				m_nWindows++;
+			}
+			m_nSumSquares = 0;
+			m_nSampleCount = 0;
+		}
+	}
 
 //public
 	//constructor - called in your sketch's global variable declaration section
@@ -52,7 +100,15 @@ namespace st
 		m_fIrms(0.0),
 		m_fApparentPower(0.0),
 		m_nNumSamples(NumSamples),
-		m_fVoltage(voltage)
+		m_fVoltage(voltage),
+		m_lOffset((long)(ADC_COUNTS >> 1) << 10),
+		m_nSumSquares(0),
+		m_nSampleCount(0),
+		m_fRmsSum(0.0),
+		m_nWindows(0),
+		m_nSettling(SETTLE_WINDOWS),
+		m_lLastSlice(0),
+		m_bHaveReading(false)
 	{
 		setPin(analogInputPin);
 
@@ -71,6 +127,7 @@ namespace st
 		}
 
 		emon1.current(m_nAnalogInputPin, m_fICAL);             // Current: input pin, calibration.
+		setScheduled(false);	//update() samples the current on every pass through loop()
 	}
 	
 
@@ -82,22 +139,49 @@ namespace st
 
 	void PS_Power::init()
 	{
-		//Make sure the EmonLib has some data accumulated before anything is transmitted to ST/Hubitat
-		m_fIrms = emon1.calcIrms(m_nNumSamples);
-		m_fIrms = emon1.calcIrms(m_nNumSamples);
-		m_fIrms = emon1.calcIrms(m_nNumSamples);
-		m_fIrms = emon1.calcIrms(m_nNumSamples);
-		m_fIrms = emon1.calcIrms(m_nNumSamples);
+		//Nothing is sent until the DC offset has settled - update() sends the first reading as soon as there is a window
+		m_nSettling = SETTLE_WINDOWS;
+		m_nSumSquares = 0;
+		m_nSampleCount = 0;
+		m_fRmsSum = 0.0;
+		m_nWindows = 0;
+		m_bHaveReading = false;
+	}
+
+	void PS_Power::update()
+	{
+		if ((millis() - m_lLastSlice) >= SLICE_GAP_MS)
+		{
+			m_lLastSlice = millis();
+			sampleSlice();
+		}
 
-		m_fApparentPower = m_fIrms * m_fVoltage; //Calcuate Apparent Power
+		//send initial data to ST/Hubitat once the first window is complete
+		if (!m_bHaveReading && (m_nWindows > 0))
+		{
+			getData();
+		}
 
-		//Send initial data to ST/Hubitat
-		getData();
+		//make sure to call the parent class' update function, since we've overriden update()
+		PollingSensor::update();
+	}
+
+	void PS_Power::refresh()
+	{
+		if (m_bHaveReading)
+		{
+			Everything::sendSmartString(getName() + " " + String(m_fApparentPower));
+		}
 	}
 
 	//SmartThings Shield data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
 	void PS_Power::beSmart(const String &str)
 	{
+		if (beSmartReportPolicy(str))
+		{
+			return;	//deadband, minreport or heartbeat command
+		}
+
 		String s = str.substring(str.indexOf(' ') + 1);
 
 		if (s.toInt() != 0) {
@@ -122,13 +206,41 @@ namespace st
 	{
 		double tempValue = 0;
 
-		m_fIrms = emon1.calcIrms(m_nNumSamples);  // Calculate Irms only
+		if (m_nWindows == 0)
+		{
+			if (st::PollingSensor::debug) {
+				Serial.println(F("PS_Power:: No complete window of readings yet"));
+			}
+			return;		//the window carries on into the next polling interval
+		}
+
+		//Calculate Irms only, as EmonLib's calcIrms() does
+#if defined emonTxV3
+		int SupplyVoltage = 3300;
+#else
+		int SupplyVoltage = emon1.readVcc();
+#endif
+		double I_RATIO = m_fICAL * ((SupplyVoltage / 1000.0) / (ADC_COUNTS));
+		m_fIrms = I_RATIO * m_fRmsSum / m_nWindows;
+		m_fRmsSum = 0.0;
+		m_nWindows = 0;
 
 		tempValue = m_fIrms * m_fVoltage; //Calcuate Apparent Power
 
-		m_fApparentPower = (m_fFilterConstant * tempValue) + (1 - m_fFilterConstant) * m_fApparentPower;
+		if (m_bHaveReading)
+		{
+			m_fApparentPower = (m_fFilterConstant * tempValue) + (1 - m_fFilterConstant) * m_fApparentPower;
+		}
+		else
+		{
+			m_fApparentPower = tempValue;	//nothing to filter against yet
+			m_bHaveReading = true;
+		}
 
-		Everything::sendSmartString(getName() + " " + String(m_fApparentPower));
+		if (shouldReport(m_fApparentPower))
+		{
+			Everything::sendSmartString(getName() + " " + String(m_fApparentPower));
+		}
 	}
 	
 	void PS_Power::setPin(byte pin)
@@ -7,6 +7,11 @@
 //			  voltage on an analog input pin via the EmonLib.  This produce the Irms current of the Current Transformer.
 //            The Irms current is then multiplied by the voltage constant passed in to produce Power in Watts.
 //
+//			  The current is sampled in the background:  every pass through loop() takes a short slice of analog readings
+//			  and adds them to a running sum of squares, with the DC offset tracked by EmonLib's low-pass filter.  Each
+//			  numSamples readings make a window, whose Irms is worked out as calcIrms() would.  getData() reports the mean
+//			  of the windows since the last poll, so each value covers the whole polling interval rather than a single
+//			  calcIrms() snapshot, and the loop is never held up for more than a slice.
 //
 //			  Create an instance of this class in your sketch's global variable section
 //			  For Example:  st::PS_Power sensor1(F("power1"), 120, 0, PIN_POWER, 30.0, 1480, 120.0);
@@ -17,7 +22,7 @@
 //				- long offset - REQUIRED - the polling interval offset in seconds - used to prevent all polling sensors from executing at the same time
 //				- byte pin - REQUIRED - the Arduino Pin to be used as an analog input
 //              - double ICAL - REQUIRED - EmonLib Calibration Constant
-//				- unsigned int numSamples - OPTIONAL - defaults to 1480, number of analog readings to use for calculating the Irms Current
+//				- unsigned int numSamples - OPTIONAL - defaults to 1480, number of analog readings in each window used for calculating the Irms Current
 //              - float voltage - OPTIONAL - defaults to 120, AC voltage of the mains line being monitored
 //				- byte filterConstant - OPTIONAL - Value from 5% to 100% to determine how much filtering/averaging is performed 100 = none (default), 5 = maximum
 //
@@ -29,6 +34,8 @@
 //    ----        ---            ----
 //    2019-02-17  Dan Ogorchock  Original Creation
 //    2019-09-19  Dan Ogorchock  Added filtering optional argument to help reduce noisy signals
+//    2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
+//    2026-10-16  a00889920      Background sampling over the whole polling interval instead of blocking calcIrms() calls
 //
 //
 //******************************************************************************************
@@ -52,6 +59,17 @@ namespace st
 			double m_fApparentPower;
 			float m_fFilterConstant;        //Filter constant % as floating point from 0.00 to 1.00
 
+			long m_lOffset;					//DC offset of the readings, in 1/1024ths of a count (EmonLib's offsetI)
+			uint64_t m_nSumSquares;			//sum of the squared readings in this window, in 1/64ths of a count squared
+			unsigned int m_nSampleCount;	//readings in this window
+			double m_fRmsSum;				//sum of the RMS (in counts) of the windows since the last poll
+			unsigned int m_nWindows;		//windows since the last poll
+			byte m_nSettling;				//windows still to be thrown away while the DC offset settles
+			unsigned long m_lLastSlice;		//millis() of the last slice of readings
+			bool m_bHaveReading;			//an Irms has been calculated
+
+			void sampleSlice();				//takes one slice of readings, closing the window once it has numSamples
+
 		public:
 			//constructor - called in your sketch's global variable declaration section
 			PS_Power(const __FlashStringHelper *name, unsigned int interval, int offset, byte analogInputPin, double ICAL, unsigned int NumSamples=1480, float voltage=120.0, byte filterConstant = 100);
@@ -65,12 +83,19 @@ namespace st
 			//SmartThings Shield data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
 			virtual void beSmart(const String &str);
 
-			//function to get data from sensor and queue results for transfer to ST Cloud 
+			//called on every pass through loop() - takes a slice of readings, then polls as usual
+			virtual void update();
+
+			//called periodically by Everything class to ensure ST Cloud is kept consistent - sends the last value
+			virtual void refresh();
+
+			//function to get data from sensor and queue results for transfer to ST Cloud - the RMS of the readings since the last poll
 			virtual void getData();
 			
 			//gets
 			inline byte getPin() const {return m_nAnalogInputPin;}
 			inline float getSensorValue() const {return m_fApparentPower;}
+			inline unsigned int getWindowCount() const {return m_nWindows;}	//windows so far in this polling interval
 				
 			//sets
 			void setPin(byte pin);
@@ -36,6 +36,7 @@
 //    2020-01-17  Dan Ogorchock  Improved support for ESP8266 using Arduino IDE Board Manager 2.5.1 and newer
 //    2020-11-15  Dan Ogorchock  Prevent Refresh from sending data for this particular device.
 //    2021-04-12  Dan Ogorchock  Corrected data type for interrupt type to correct compiler error for Nano 33 IoT
+//    2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
 //
 //
 //******************************************************************************************
@@ -91,6 +92,11 @@ PS_PulseCounter::PS_PulseCounter(const __FlashStringHelper* name, unsigned int i
 	//SmartThings Shield data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
 	void PS_PulseCounter::beSmart(const String &str)
 	{
+		if (beSmartReportPolicy(str))
+		{
+			return;	//deadband, minreport or heartbeat command
+		}
+
 		String s = str.substring(str.indexOf(' ') + 1);
 		
 		if (s.toInt() != 0) {
@@ -137,7 +143,10 @@ PS_PulseCounter::PS_PulseCounter(const __FlashStringHelper* name, unsigned int i
 			}
 		}
 
-		Everything::sendSmartString(getName() + " " + m_nSensorValue);
+		if (shouldReport(m_nSensorValue))
+		{
+			Everything::sendSmartString(getName() + " " + m_nSensorValue);
+		}
 	}
 
 	void PS_PulseCounter::setPin(byte pin)
@@ -34,6 +34,8 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2019-07-08  Dan Ogorchock  Original Creation
+//    2026-10-16  a00889920      Opted out of the Everything scheduler - update() samples the microphone on every loop()
+//    2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
 //
 //
 //******************************************************************************************
@@ -63,6 +65,7 @@ namespace st
 		m_nHighSpeedPollingInterval(HighSpeedPollingInterval)
 	{
 		setPin(analogInputPin);
+		setScheduled(false);	//update() samples the microphone on every pass through loop()
 	}
 	
 	//destructor
@@ -74,6 +77,11 @@ namespace st
 	//SmartThings Shield data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
 	void PS_SoundPressureLevel::beSmart(const String &str)
 	{
+		if (beSmartReportPolicy(str))
+		{
+			return;	//deadband, minreport or heartbeat command
+		}
+
 		String s = str.substring(str.indexOf(' ') + 1);
 
 		if (s.toInt() != 0) {
@@ -124,7 +132,10 @@ namespace st
 		update();
 
 		//transfer the data to the hub
-		Everything::sendSmartString(getName() + " " + String(m_fSensorValue));
+		if (shouldReport(m_fSensorValue))
+		{
+			Everything::sendSmartString(getName() + " " + String(m_fSensorValue));
+		}
 		
 		//reset the max value
 		m_fSensorValue = -1.0;
@@ -34,6 +34,7 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2019-07-08  Dan Ogorchock  Original Creation
+//    2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
 //
 //
 //******************************************************************************************
@@ -5,6 +5,7 @@
 //  Summary:  PS_Ultrasonic is a class which implements a custom Level device capability.
 //			  It inherits from the st::PollingSensor class.  
 //
+//			  Each poll sends a burst of pings and reports the median distance - see PS_Ultrasonic.h
 //
 //			  Create an instance of this class in your sketch's global variable section
 //			  For Example:  st::PS_Ultrasonic sensor1(F("ultrasonic1"), 60, 0, PIN_ULTRASONIC_T, PIN_ULTRASONIC_E);
@@ -15,13 +16,15 @@
 //				- long offset - REQUIRED - the polling interval offset in seconds - used to prevent all polling sensors from executing at the same time
 //				- byte digitalTriggerPin - REQUIRED - the Arduino Pin to be used as a digital output to trigger ultrasonic
 //				- byte digitalEchoPin - REQUIRED - the Arduino Pin to be used as a digital input to read the echo
+//				- byte pings - OPTIONAL - number of pings per poll, 1 to MAX_PINGS - defaults to 5
+//				- float temperature - OPTIONAL - air temperature in Celsius, for the speed of sound - defaults to 20.0
 //
 //
 //  Change History:
 //
 //    Date        Who            What
 //    ----        ---            ----
-//    
+//    2026-10-16  a00889920      Non-blocking interrupt-timed echoes, median of a burst of pings, temperature compensated
 //
 //
 //******************************************************************************************
@@ -34,16 +37,144 @@
 
 namespace st
 {
+	static const unsigned long ECHO_MAX_US = 25000;	//about 4.3 m away - anything longer is "no echo" (the sensor's own timeout is about 38 ms)
+
+	//The echo of the ping in flight, timed by the interrupt handler (or by pulseIn() on a pin without an interrupt).
+	//One PS_Ultrasonic pings at a time - s_pPingOwner is the sensor it belongs to.
+	static volatile unsigned long s_lEchoStart = 0;
+	static volatile unsigned long s_lEchoMicros = 0;	//length of the echo pulse - 0 until it has ended
+	static volatile bool s_bEchoStarted = false;
+	static volatile byte s_nEchoPin = 0;
+	static PS_Ultrasonic *s_pPingOwner = 0;
+
+	static void ST_ISR_ATTR isrEcho()
+	{
+		unsigned long now = micros();
+
+		if (digitalRead(s_nEchoPin) == HIGH)
+		{
+			s_lEchoStart = now;
+			s_bEchoStarted = true;
+		}
+		else if (s_bEchoStarted && (s_lEchoMicros == 0))
+		{
+			unsigned long echo = now - s_lEchoStart;
+			s_lEchoMicros = (echo > 0) ? echo : 1;
+		}
+	}
+
 //private
-	
+	void PS_Ultrasonic::nextStep(byte state, unsigned long ms)
+	{
+		m_nPingState = state;
+		m_lStepDue = millis() + ms;
+		scheduleUpdate(m_lStepDue);
+	}
+
+	void PS_Ultrasonic::ping()
+	{
+		if (s_pPingOwner && (s_pPingOwner != this))
+		{
+			nextStep(PING_WAITING, PING_INTERVAL_MS);	//another sensor's echo could still be on its way
+			return;
+		}
+		s_pPingOwner = this;
+
+		s_bEchoStarted = false;
+		s_lEchoMicros = 0;
+		if (m_bUseIsr)
+		{
+			s_nEchoPin = m_nDigitalEchoPin;
+			attachInterrupt(digitalPinToInterrupt(m_nDigitalEchoPin), isrEcho, CHANGE);
+		}
+
+		// Clears the trigPin
+		digitalWrite(m_nDigitalTriggerPin, LOW);
+		delayMicroseconds(2);
+		// Sets the trigPin on HIGH state for 10 micro seconds
+		digitalWrite(m_nDigitalTriggerPin, HIGH);
+		delayMicroseconds(10);
+		digitalWrite(m_nDigitalTriggerPin, LOW);
+		m_nPing++;
+
+		if (!m_bUseIsr)
+		{
+			//the echo starts about 0.5 ms after the trigger - wait no longer than an echo from ECHO_MAX_US away can take
+			s_lEchoMicros = pulseIn(m_nDigitalEchoPin, HIGH, ECHO_MAX_US + 1000);
+		}
+
+		nextStep(PING_LISTENING, PING_INTERVAL_MS);
+	}
+
+	void PS_Ultrasonic::collectEcho()
+	{
+		if (m_bUseIsr)
+		{
+			detachInterrupt(digitalPinToInterrupt(m_nDigitalEchoPin));
+		}
+
+		unsigned long echo = s_lEchoMicros;
+		if ((echo == 0) || (echo > ECHO_MAX_US))
+		{
+			return;		//no echo (or one from out of range)
+		}
+
+		//insertion sort - the echoes are kept in order of length, so the median is the middle one
+		byte i = m_nEchoes++;
+		while ((i > 0) && (m_Echoes[i - 1] > echo))
+		{
+			m_Echoes[i] = m_Echoes[i - 1];
+			i--;
+		}
+		m_Echoes[i] = echo;
+	}
+
+	void PS_Ultrasonic::finishBurst()
+	{
+		s_pPingOwner = 0;
+		m_nPingState = PING_IDLE;
+
+		unsigned long echo = 0;
+		if (m_nEchoes > 0)
+		{
+			byte mid = m_nEchoes / 2;
+			echo = (m_nEchoes % 2) ? m_Echoes[mid] : (m_Echoes[mid - 1] + m_Echoes[mid]) / 2;
+		}
+
+		// Calculating the distance - the sound goes there and back, so cm = us * (cm/s) / 2000000, here in hundredths of a cm
+		m_nSensorValue = (echo * m_nSpeedOfSound / 20000) / 100.0;
+
+		if (st::PollingSensor::debug) {
+			Serial.print(F("PS_Ultrasonic:: "));
+			Serial.print(m_nEchoes);
+			Serial.print(F(" echoes from "));
+			Serial.print(m_nPing);
+			Serial.print(F(" pings, median "));
+			Serial.print(echo);
+			Serial.println(F(" us"));
+		}
+
+		// queue the distance to send to smartthings 
+		if (shouldReport(m_nSensorValue))
+		{
+			Everything::sendSmartString(getName() + " " + String(m_nSensorValue));
+		}
+	}
 
 //public
 	//constructor - called in your sketch's global variable declaration section
-	PS_Ultrasonic::PS_Ultrasonic(const __FlashStringHelper *name, unsigned int interval, int offset, byte digitalTriggerPin, byte digitalEchoPin):
+	PS_Ultrasonic::PS_Ultrasonic(const __FlashStringHelper *name, unsigned int interval, int offset, byte digitalTriggerPin, byte digitalEchoPin, byte pings, float temperature):
 		PollingSensor(name, interval, offset),
-		m_nSensorValue(0)
+		m_nSensorValue(0),
+		m_bUseIsr(false),
+		m_nPingState(PING_IDLE),
+		m_lStepDue(0),
+		m_nPing(0),
+		m_nEchoes(0)
 	{
 		setPin(digitalTriggerPin,digitalEchoPin);
+		setPings(pings);
+		setTemperature(temperature);
 	}
 	
 	//destructor
@@ -55,6 +186,11 @@ namespace st
 	//SmartThings Shield data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
 	void PS_Ultrasonic::beSmart(const String &str)
 	{
+		if (beSmartReportPolicy(str))
+		{
+			return;	//deadband, minreport or heartbeat command
+		}
+
 		String s = str.substring(str.indexOf(' ') + 1);
 		Serial.print("st string #####  ");
 		Serial.println(str);
@@ -75,26 +211,56 @@ namespace st
 		}
 	}
 
+	//initialization routine - starts the first burst, whose distance is sent once it is over
+	void PS_Ultrasonic::init()
+	{
+		m_bUseIsr = true;
+#if defined(NOT_AN_INTERRUPT)
+		if (digitalPinToInterrupt(m_nDigitalEchoPin) == NOT_AN_INTERRUPT)
+		{
+			m_bUseIsr = false;
+		}
+#endif
+		getData();
+	}
+
+	//runs the next step of a burst when it is due, and otherwise polls as usual
+	void PS_Ultrasonic::update()
+	{
+		if (m_nPingState != PING_IDLE)
+		{
+			if ((long)(millis() - m_lStepDue) < 0)
+			{
+				scheduleUpdate(m_lStepDue);
+				return;
+			}
+
+			if (m_nPingState == PING_LISTENING)
+			{
+				collectEcho();
+				if (m_nPing >= m_nPings)
+				{
+					finishBurst();
+					PollingSensor::update();	//reschedules the next poll (or starts it, if it is already due)
+					return;
+				}
+			}
+			ping();
+			return;
+		}
+
+		PollingSensor::update();
+	}
+
 	//function to get data from sensor and queue results for transfer to ST Cloud 
 	void PS_Ultrasonic::getData()
 	{
-		
-		//int m_nSensorValue=map(analogRead(m_nAnalogInputPin), SENSOR_LOW, SENSOR_HIGH, MAPPED_LOW, MAPPED_HIGH);
-		long duration;
-		// Clears the trigPin
-		digitalWrite(m_nDigitalTriggerPin, LOW);
-		delayMicroseconds(2);
-		// Sets the trigPin on HIGH state for 10 micro seconds
-		digitalWrite(m_nDigitalTriggerPin, HIGH);
-		delayMicroseconds(10);
-		digitalWrite(m_nDigitalTriggerPin, LOW);
-		// Reads the echoPin, returns the sound wave travel time in microseconds
-		duration = pulseIn(m_nDigitalEchoPin, HIGH);
-		// Calculating the distance
-		m_nSensorValue = duration*0.034/2;
-
-		// queue the distance to send to smartthings 
-		Everything::sendSmartString(getName() + " " + String(m_nSensorValue));
+		if (m_nPingState == PING_IDLE)
+		{
+			m_nPing = 0;
+			m_nEchoes = 0;
+			ping();		//update() sends the rest of the burst and reports the distance
+		}
 	}
 	
 	void PS_Ultrasonic::setPin(byte &trigPin,byte &echoPin)
@@ -104,4 +270,15 @@ namespace st
 		pinMode(m_nDigitalTriggerPin, OUTPUT); // Sets the trigPin as an Output
 		pinMode(m_nDigitalEchoPin, INPUT); // Sets the echoPin as an Input
 	}
+
+	void PS_Ultrasonic::setPings(byte pings)
+	{
+		m_nPings = constrain(pings, 1, MAX_PINGS);
+	}
+
+	void PS_Ultrasonic::setTemperature(float temperature)
+	{
+		//331.3 m/s at 0C, plus 0.606 m/s per degree
+		m_nSpeedOfSound = 33130 + 60.6 * constrain(temperature, -40.0, 80.0) + 0.5;
+	}
 }
@@ -5,9 +5,17 @@
 //  Summary:  PS_Ultrasonic is a class which implements a custom Level device capability.
 //			  It inherits from the st::PollingSensor class.  
 //
+//			  Each poll sends a burst of pings, one every PING_INTERVAL_MS, and reports the median distance in cm, so a
+//			  stray echo does not make it to ST.  If the echo pin supports attachInterrupt(), nothing blocks:  an interrupt
+//			  handler times the echo pulse and update() collects it when the next ping is due.  Other pins wait for the
+//			  echo with pulseIn(), but only for as long as an echo from the sensor's maximum range can take.  If no ping
+//			  gets an echo, 0 is reported, as before.
+//
+//			  The speed of sound is worked out from the air temperature (setTemperature(), or the constructor's default).
 //
 //			  Create an instance of this class in your sketch's global variable section
 //			  For Example:  st::PS_Ultrasonic sensor1(F("ultrasonic1"), 60, 0, PIN_ULTRASONIC_T, PIN_ULTRASONIC_E);
+//			  With 7 pings per poll in 12.5C air:  st::PS_Ultrasonic sensor1(F("ultrasonic1"), 60, 0, PIN_ULTRASONIC_T, PIN_ULTRASONIC_E, 7, 12.5);
 //
 //			  st::PS_Ultrasonic() constructor requires the following arguments
 //				- String &name - REQUIRED - the name of the object - must match the Groovy ST_Anything DeviceType tile name
@@ -15,13 +23,15 @@
 //				- long offset - REQUIRED - the polling interval offset in seconds - used to prevent all polling sensors from executing at the same time
 //				- byte digitalTriggerPin - REQUIRED - the Arduino Pin to be used as a digital output to trigger ultrasonic
 //				- byte digitalEchoPin - REQUIRED - the Arduino Pin to be used as a digital input to read the echo
+//				- byte pings - OPTIONAL - number of pings per poll, 1 to MAX_PINGS - defaults to 5
+//				- float temperature - OPTIONAL - air temperature in Celsius, for the speed of sound - defaults to 20.0
 //
 //
 //  Change History:
 //
 //    Date        Who            What
 //    ----        ---            ----
-//    
+//    2026-10-16  a00889920      Non-blocking interrupt-timed echoes, median of a burst of pings, temperature compensated
 //
 //
 //******************************************************************************************
@@ -35,14 +45,35 @@ namespace st
 {
 	class PS_Ultrasonic : public PollingSensor
 	{
+		public:
+			static const byte MAX_PINGS = 9;				//most pings in one poll
+			static const unsigned long PING_INTERVAL_MS = 60;	//time allowed for each ping - the sensor's own echo timeout is about 38 ms
+
 		private:
 			byte m_nDigitalTriggerPin;
 			byte m_nDigitalEchoPin;
 			float m_nSensorValue;
-			
+			byte m_nPings;					//pings per poll
+			unsigned int m_nSpeedOfSound;	//in cm per second, from the air temperature
+			bool m_bUseIsr;					//the echo pin supports attachInterrupt() - otherwise pulseIn() times the echo
+			byte m_nPingState;				//PING_IDLE, or the step of the burst in progress
+			unsigned long m_lStepDue;		//millis() at which the next step of the burst is due
+			byte m_nPing;					//pings sent so far in this burst
+			byte m_nEchoes;					//echoes received so far in this burst
+			unsigned int m_Echoes[MAX_PINGS];	//echo times in microseconds, in order of length once the burst is over
+
+			static const byte PING_IDLE = 0;
+			static const byte PING_WAITING = 1;		//another PS_Ultrasonic is pinging - wait for it, so the echoes cannot mix
+			static const byte PING_LISTENING = 2;	//a ping was sent - the interrupt handler times its echo
+
+			void nextStep(byte state, unsigned long ms);	//moves the burst on to state in ms milliseconds
+			void ping();					//sends the next ping of the burst
+			void collectEcho();				//keeps the last ping's echo time, if there was an echo
+			void finishBurst();				//reports the median distance
+
 		public:
 			//constructor - called in your sketch's global variable declaration section
-			PS_Ultrasonic(const __FlashStringHelper *name, unsigned int interval, int offset, byte digitalTriggerPin, byte digitalEchoPin);
+			PS_Ultrasonic(const __FlashStringHelper *name, unsigned int interval, int offset, byte digitalTriggerPin, byte digitalEchoPin, byte pings = 5, float temperature = 20.0);
 			
 			//destructor
 			virtual ~PS_Ultrasonic();
@@ -50,7 +81,13 @@ namespace st
 			//SmartThings Shield data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
 			virtual void beSmart(const String &str);
 
-			//function to get data from sensor and queue results for transfer to ST Cloud 
+			//initialization routine
+			virtual void init();
+
+			//called by Everything when a poll or the next ping of a burst is due
+			virtual void update();
+
+			//function to get data from sensor and queue results for transfer to ST Cloud - the distance is sent once the burst is over
 			virtual void getData();
 			
 			//gets
@@ -59,6 +96,8 @@ namespace st
 				
 			//sets
 			void setPin(byte &trigPin,byte &echoPin);
+			void setPings(byte pings);					//pings per poll, 1 to MAX_PINGS
+			void setTemperature(float temperature);		//air temperature in Celsius, for the speed of sound
 	};
 }
 #endif
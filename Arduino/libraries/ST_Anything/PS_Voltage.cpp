@@ -72,6 +72,7 @@
 //    2017-08-31  Dan Ogorchock  Added filtering optional argument to help reduce noisy signals
 //    2017-09-01  Dan Ogorchock  Added 3rd order polynomial nonlinear correction compensation
 //    2018-06-24  Dan Ogorchock  Improved documentation / comments (above)
+//    2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
 //
 //
 //******************************************************************************************
@@ -162,6 +163,11 @@ namespace st
 	//SmartThings Shield data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
 	void PS_Voltage::beSmart(const String &str)
 	{
+		if (beSmartReportPolicy(str))
+		{
+			return;	//deadband, minreport or heartbeat command
+		}
+
 		String s = str.substring(str.indexOf(' ') + 1);
 
 		if (s.toInt() != 0) {
@@ -229,7 +235,10 @@ namespace st
 			m_fSensorValue = (m_fFilterConstant * tempValue) + (1 - m_fFilterConstant) * m_fSensorValue;
 		}
 		
-		Everything::sendSmartString(getName() + " " + String(m_fSensorValue));
+		if (shouldReport(m_fSensorValue))
+		{
+			Everything::sendSmartString(getName() + " " + String(m_fSensorValue));
+		}
 	}
 	
 	void PS_Voltage::setPin(byte pin)
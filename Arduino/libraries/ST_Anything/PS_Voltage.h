@@ -72,6 +72,7 @@
 //    2017-08-31  Dan Ogorchock  Added filtering optional argument to help reduce noisy signals
 //    2017-09-01  Dan Ogorchock  Added 3rd order polynomial nonlinear correction compensation
 //    2018-06-24  Dan Ogorchock  Improved documentation / comments (above)
+//    2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
 //
 //
 //******************************************************************************************
@@ -30,6 +30,7 @@
 //    2015-01-03  Dan & Daniel   Original Creation
 //    2015-08-23  Dan			 Added optional alarm limit to constructor
 //    2018-10-17  Dan            Added invertLogic parameter to constructor
+//    2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
 //
 //
 //******************************************************************************************
@@ -65,6 +66,11 @@ namespace st
 	//SmartThings Shield data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
 	void PS_Water::beSmart(const String &str)
 	{
+		if (beSmartReportPolicy(str))
+		{
+			return;	//deadband, minreport or heartbeat command
+		}
+
 		String s = str.substring(str.indexOf(' ') + 1);
 		
 		if (s.toInt() != 0) {
@@ -98,13 +104,10 @@ namespace st
 		}
 
 		//compare the sensor's value is against the limit to determine whether to send "dry" versus "wet".  
-		if (m_binvertLogic)
-		{
-			Everything::sendSmartString(getName() + (m_nSensorValue > m_nSensorLimit ? F(" dry") : F(" wet")));
-		}
-		else
+		bool dry = m_binvertLogic ? (m_nSensorValue > m_nSensorLimit) : (m_nSensorValue < m_nSensorLimit);
+		if (shouldReport(dry ? 1 : 0))
 		{
-			Everything::sendSmartString(getName() + (m_nSensorValue < m_nSensorLimit ? F(" dry") : F(" wet")));
+			Everything::sendSmartString(getName() + (dry ? F(" dry") : F(" wet")));
 		}
 	}
 	
@@ -17,6 +17,9 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2015-01-03  Dan & Daniel   Original Creation
+//    2026-10-16  a00889920      Ported onto the Everything scheduler - deadline based, drift-free and millis() rollover safe
+//    2026-10-16  a00889920      Added optional reporting policy - deadband, minimum report interval and heartbeat
+//    2026-10-16  a00889920      Reporting policy moved to st::ReportPolicy
 //
 //
 //******************************************************************************************
@@ -31,36 +34,50 @@ namespace st
 //private
 	bool PollingSensor::checkInterval()
 	{
-		//check for time overflow
-		if(millis()<m_nPreviousTime)
+		unsigned long now = millis();
+
+		if(!m_bStarted) //eliminates problem of there being a delay before first update() call
 		{
-			if (debug)
-			{
-				Serial.println(F("PollingSensor: millis() Overflow handled"));
-			}
-			
-			m_nPreviousTime = 0;
+			m_bStarted = true;
+			m_nPreviousTime = now;
 		}
-		
-		if(m_nPreviousTime==0) //eliminates problem of there being a delay before first update() call
+
+		//unsigned subtraction and signed compares keep this correct across millis() rollover
+		unsigned long due = m_nPreviousTime + m_nOffset + m_nInterval;
+		if((long)(now - due) < 0)
 		{
-			m_nPreviousTime=millis();
+			scheduleUpdate(due);
+			return false;
 		}
-		
-		//calculate new delta time
-		m_nDeltaTime+=(millis()-m_nPreviousTime)-m_nOffset;
-		m_nOffset=0;
-		m_nPreviousTime=millis();
-		
-		//determine interval has passed
-		if(m_nDeltaTime>=m_nInterval)
+
+		//the next interval starts when this one was due, not when we got around to it, so the period does not drift.
+		//If a whole interval was missed (e.g. a long blocking call elsewhere), start over rather than poll twice in a row.
+		m_nPreviousTime = ((long)(now - due) >= m_nInterval) ? now : due;
+		m_nOffset = 0;
+		scheduleUpdate(m_nPreviousTime + m_nInterval);
+		return true;
+	}
+
+	bool PollingSensor::beSmartReportPolicy(const String &str)
+	{
+		if(!m_ReportPolicy.beSmart(str))
 		{
-			m_nDeltaTime=0;
-			return true;
+			return false;
 		}
-		else
+
+		if(debug)
 		{
-			return false;
+			Serial.print(F("PollingSensor::beSmart set report policy "));
+			Serial.println(str);
+		}
+		return true;
+	}
+
+	void PollingSensor::reschedule()
+	{
+		if(m_bStarted && isScheduled())
+		{
+			scheduleUpdate(m_nPreviousTime + m_nOffset + m_nInterval);
 		}
 	}
 
@@ -69,11 +86,12 @@ namespace st
 	PollingSensor::PollingSensor(const __FlashStringHelper *name, long interval, long offset):
 		Sensor(name),
 		m_nPreviousTime(0),
-		m_nDeltaTime(0),
+		m_bStarted(false),
 		m_nInterval(interval*1000),
-		m_nOffset(offset*1000)
+		m_nOffset(offset*1000),
+		m_bForceReport(false)
 	{
-	
+		setScheduled(true);	//update() only has work to do once per interval - subclasses that must run every loop() call setScheduled(false)
 	}
 	
 	//destructor
@@ -89,7 +107,9 @@ namespace st
 
 	void PollingSensor::refresh()
 	{
+		m_bForceReport = true;	//refresh exists to make sure the hub is in sync, so it is never suppressed
 		getData();
+		m_bForceReport = false;
 	}
 
 	void PollingSensor::update()
@@ -12,11 +12,21 @@
 //				- long interval - REQUIRED - the polling interval in seconds
 //				- long offset - REQUIRED - the polling interval offset in seconds - used to prevent all polling sensors from executing at the same time
 //
+//			  Reporting policy (optional - by default every reading is sent):
+//				setReportPolicy(deadband, percent, minInterval, heartbeat) in your sketch's setup(), or
+//				"<name> deadband <value>[%]", "<name> minreport <seconds>", "<name> heartbeat <seconds>" from the hub.
+//				A reading is only sent if it differs from the last one sent by more than the deadband (absolute, or
+//				percent of the last value sent), and at least minInterval seconds after it.  If heartbeat is non-zero,
+//				a reading is sent anyway once nothing has been sent for that many seconds.  refresh() always sends.
+//
 //  Change History:
 //
 //    Date        Who            What
 //    ----        ---            ----
 //    2015-01-03  Dan & Daniel   Original Creation
+//    2026-10-16  a00889920      Ported onto the Everything scheduler - deadline based, drift-free and millis() rollover safe
+//    2026-10-16  a00889920      Added optional reporting policy - deadband, minimum report interval and heartbeat
+//    2026-10-16  a00889920      Reporting policy moved to st::ReportPolicy - shouldReport() takes a channel for each extra value sent
 //
 //
 //******************************************************************************************
@@ -25,18 +35,35 @@
 #define ST_POLLINGSENSOR_H
 
 #include "Sensor.h"
+#include "ReportPolicy.h"
 
 namespace st
 {
 	class PollingSensor: public Sensor
 	{
 		private:
-			unsigned long m_nPreviousTime; //in milliseconds - time of last poll
-			long m_nDeltaTime;			   //in milliseconds - elapsed time since last poll
+			unsigned long m_nPreviousTime; //in milliseconds - time the current polling interval started
+			bool m_bStarted;			   //false until the first update() call starts the first polling interval
 			long m_nInterval;			   //in milliseconds - polling interval for the sensor
 			long m_nOffset;				   //in milliseconds - offset to prevent all Polling sensors from running at the same time
 			
-			virtual bool checkInterval(); //returns true and resets m_nDeltaTime if m_nInterval has been reached
+			virtual bool checkInterval(); //returns true and starts the next interval if m_nInterval has been reached, and schedules the next update()
+			void reschedule();			  //schedules the next update() after the interval or offset has been changed
+
+			ReportPolicy m_ReportPolicy;   //deadband, minimum report interval and heartbeat (none by default)
+			ReportPolicy::Channel m_ReportChannel; //last value sent by shouldReport(value)
+			bool m_bForceReport;		   //true while refresh() is running - the reading is always sent
+
+		protected:
+			//applies the reporting policy - returns true (and remembers value as sent) if the reading should be sent
+			//force always sends (as does refresh()) - for readings that complete after refresh() has returned
+			bool shouldReport(float value, bool force=false) {return m_ReportPolicy.shouldReport(value, m_ReportChannel, force || m_bForceReport);}
+
+			//as above, for sensors that send several values - each value after the first has its own channel
+			bool shouldReport(float value, ReportPolicy::Channel &channel, bool force=false) {return m_ReportPolicy.shouldReport(value, channel, force || m_bForceReport);}
+
+			//handles "deadband", "minreport" and "heartbeat" commands from the hub - returns false if str is not one of them
+			bool beSmartReportPolicy(const String &str);
 			
 		public:
 			//constructor
@@ -58,10 +85,12 @@ namespace st
 			virtual void getData();
 			
 			//gets
-			virtual void offset(long os) {m_nOffset=os;} //offset the delta time from its current value
+			virtual void offset(long os) {m_nOffset=os; reschedule();} //offset the delta time from its current value
 
 			//sets
-			virtual void setInterval(long interval) {m_nInterval=interval;}
+			virtual void setInterval(long interval) {m_nInterval=interval; reschedule();}
+			void setReportPolicy(float deadband, bool percent=false, long minInterval=0, long heartbeat=0) {m_ReportPolicy.set(deadband, percent, minInterval, heartbeat);} //minInterval and heartbeat in seconds
+			void clearReportPolicy() {m_ReportPolicy.clear();}	//send every reading again
 	
 			//debug flag to determine if debug print statements are executed (set value in your sketch)
 			static bool debug;
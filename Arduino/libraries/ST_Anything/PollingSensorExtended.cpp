@@ -20,6 +20,8 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2015-01-03  a00889920      Original Creation
+//    2026-10-16  a00889920      Ported onto the Everything scheduler - deadline based, drift-free and millis() rollover safe
+//    2026-10-16  a00889920      Added the optional reporting policy of st::PollingSensor (st::ReportPolicy)
 //
 //
 //******************************************************************************************
@@ -32,57 +34,87 @@
 namespace st
 {
 //private
-bool PollingSensorExtended::checkInterval()
+unsigned long PollingSensorExtended::getDueTime() const
 {
-	//check for time overflow
-	if (millis() < m_nPreviousTime)
-	{
-		if (debug)
-		{
-			Serial.println(F("PollingSensorExtended: millis() Overflow handled"));
-		}
+	long due; //in milliseconds - time into the cycle at which the current state is due
 
-		m_nPreviousTime = 0;
+	if (m_bState_PreGetData)
+	{
+		due = m_nIntervalGetData - m_nIntervalPreGetData;
 	}
-
-	if (m_nPreviousTime == 0) //eliminates problem of there being a delay before first update() call
+	else if (m_bState_GetData)
+	{
+		due = m_nIntervalGetData;
+	}
+	else
 	{
-		m_nPreviousTime = millis();
+		due = m_nIntervalPreGetData + m_nIntervalPostGetData; //never runs before getData() since the states run in order
 	}
 
-	//calculate new delta time
-	m_nDeltaTime += (millis() - m_nPreviousTime) - m_nOffset;
-	m_nOffset = 0;
-	m_nPreviousTime = millis();
+	return m_nPreviousTime + m_nOffset + due;
+}
+
+bool PollingSensorExtended::checkInterval()
+{
+	unsigned long now = millis();
+
+	if (!m_bStarted) //eliminates problem of there being a delay before first update() call
+	{
+		m_bStarted = true;
+		m_nPreviousTime = now;
+	}
 
-	//determine interval has passed
-	if (m_bState_PreGetData && m_nDeltaTime >= (m_nIntervalGetData - m_nIntervalPreGetData))
+	//unsigned subtraction and signed compares keep this correct across millis() rollover
+	unsigned long due = getDueTime();
+	if ((long)(now - due) < 0)
 	{
-		// PreGetData
-		return true;
+		scheduleUpdate(due);
+		return false;
 	}
-	else if (m_bState_GetData && m_nDeltaTime >= m_nIntervalGetData)
+
+	if (m_bState_PostGetData)
 	{
-		// GetData
-		return true;
+		//the next cycle starts when this one was due to end (postGetData() never runs before getData()), so the period
+		//does not drift.  If a whole cycle was missed, start over from now rather than run the states back to back.
+		long cycle = max(m_nIntervalGetData, m_nIntervalPreGetData + m_nIntervalPostGetData);
+		m_nPreviousTime += m_nOffset + cycle;
+		m_nOffset = 0;
+		if ((long)(now - m_nPreviousTime) >= cycle)
+		{
+			m_nPreviousTime = now;
+		}
 	}
-	else if (m_bState_PostGetData && m_nDeltaTime >= (m_nIntervalPreGetData + m_nIntervalPostGetData))
+	return true;
+}
+
+void PollingSensorExtended::reschedule()
+{
+	if (m_bStarted && isScheduled())
 	{
-		// PostGetData
-		m_nDeltaTime = 0;
-		return true;
+		scheduleUpdate(getDueTime());
 	}
-	else
+}
+
+bool PollingSensorExtended::beSmartReportPolicy(const String &str)
+{
+	if (!m_ReportPolicy.beSmart(str))
 	{
 		return false;
 	}
+
+	if (debug)
+	{
+		Serial.print(F("PollingSensorExtended::beSmart set report policy "));
+		Serial.println(str);
+	}
+	return true;
 }
 
 //public
 //constructor
 PollingSensorExtended::PollingSensorExtended(const __FlashStringHelper *name, long preInterval, long interval, long postInterval, long offset) : Sensor(name),
 																																				 m_nPreviousTime(0),
-																																				 m_nDeltaTime(0),
+																																				 m_bStarted(false),
 																																				 m_nIntervalPreGetData(preInterval * 1000),
 																																				 m_nIntervalGetData(interval * 1000),
 																																				 m_nIntervalPostGetData(postInterval * 1000),
@@ -91,6 +123,7 @@ PollingSensorExtended::PollingSensorExtended(const __FlashStringHelper *name, lo
 																																				 m_bState_GetData(false),
 																																				 m_bState_PostGetData(false)
 {
+	setScheduled(true); //update() only has work to do when the next state is due
 }
 
 //destructor
@@ -140,6 +173,8 @@ void PollingSensorExtended::update()
 				Serial.println(F("PollingSensorExtended: update running with an invalid state"));
 			}
 		}
+
+		scheduleUpdate(getDueTime()); //wake up again when the next state is due
 	}
 }
 
@@ -17,6 +17,8 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2015-01-03  a00889920      Original Creation
+//    2026-10-16  a00889920      Ported onto the Everything scheduler - deadline based, drift-free and millis() rollover safe
+//    2026-10-16  a00889920      Added the optional reporting policy of st::PollingSensor (st::ReportPolicy)
 //
 //
 //******************************************************************************************
@@ -25,14 +27,15 @@
 #define ST_POLLINGSENSOREXTENDED_H
 
 #include "Sensor.h"
+#include "ReportPolicy.h"
 
 namespace st
 {
 class PollingSensorExtended : public Sensor
 {
 private:
-	unsigned long m_nPreviousTime; //in milliseconds - time of last poll
-	long m_nDeltaTime;			   //in milliseconds - elapsed time since last poll
+	unsigned long m_nPreviousTime; //in milliseconds - time the current pre/get/post cycle started
+	bool m_bStarted;			   //false until the first update() call starts the first cycle
 	long m_nIntervalPreGetData;	//in milliseconds - polling interval before getting sensor data
 	long m_nIntervalGetData;	   //in milliseconds - polling interval for the sensor
 	long m_nIntervalPostGetData;   //in milliseconds - polling interval after getting sensor data
@@ -42,7 +45,18 @@ private:
 	bool m_bState_GetData;	//boolean flag to indicate which state polling sensor is in
 	bool m_bState_PostGetData; //boolean flag to indicate which state polling sensor is in
 
-	virtual bool checkInterval(); //returns true and resets m_nDeltaTime if m_nInterval has been reached
+	virtual bool checkInterval(); //returns true if the current state's time has been reached, otherwise schedules the next update()
+	unsigned long getDueTime() const; //time at which the current state is due
+	void reschedule();			  //schedules the next update() after an interval or offset has been changed
+
+	ReportPolicy m_ReportPolicy;   //deadband, minimum report interval and heartbeat (none by default)
+
+protected:
+	//applies the reporting policy to one of the values the sensor sends - returns true (and remembers value as sent on channel) if it should be sent
+	bool shouldReport(float value, ReportPolicy::Channel &channel, bool force = false) { return m_ReportPolicy.shouldReport(value, channel, force); }
+
+	//handles "deadband", "minreport" and "heartbeat" commands from the hub - returns false if str is not one of them
+	bool beSmartReportPolicy(const String &str);
 
 public:
 	//constructor
@@ -70,12 +84,14 @@ public:
 	virtual void postGetData();
 
 	//gets
-	virtual void offset(long os) { m_nOffset = os; } //offset the delta time from its current value
+	virtual void offset(long os) { m_nOffset = os; reschedule(); } //offset the delta time from its current value
 
 	//sets
-	virtual void setPreInterval(long interval) { m_nIntervalPreGetData = interval; }
-	virtual void setInterval(long interval) { m_nIntervalGetData = interval; }
-	virtual void setPostInterval(long interval) { m_nIntervalPostGetData = interval; }
+	virtual void setPreInterval(long interval) { m_nIntervalPreGetData = interval; reschedule(); }
+	virtual void setInterval(long interval) { m_nIntervalGetData = interval; reschedule(); }
+	virtual void setPostInterval(long interval) { m_nIntervalPostGetData = interval; reschedule(); }
+	void setReportPolicy(float deadband, bool percent = false, long minInterval = 0, long heartbeat = 0) { m_ReportPolicy.set(deadband, percent, minInterval, heartbeat); } //minInterval and heartbeat in seconds
+	void clearReportPolicy() { m_ReportPolicy.clear(); } //send every reading again
 
 	//debug flag to determine if debug print statements are executed (set value in your sketch)
 	static bool debug;
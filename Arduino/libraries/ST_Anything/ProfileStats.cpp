@@ -0,0 +1,96 @@
+//******************************************************************************************
+//  File: ProfileStats.cpp
+//  Authors: Dan G Ogorchock & Daniel J Ogorchock (Father and Son)
+//
+//  Summary:  st::ProfileStats collects execution time samples (in microseconds) for one device or one
+//			  phase of Everything::run().  See ProfileStats.h for details.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  a00889920      Original Creation
+//
+//
+//******************************************************************************************
+
+#include "ProfileStats.h"
+
+#if defined(ENABLE_PROFILER)
+namespace st
+{
+//public
+	//constructor
+	ProfileStats::ProfileStats()
+	{
+		reset();
+	}
+
+	void ProfileStats::record(unsigned long us)
+	{
+		byte bucket = 0;
+		while (us >> bucket && bucket < BUCKETS - 1)
+		{
+			bucket++;
+		}
+
+		if (m_Buckets[bucket] == 0xFF)
+		{
+			for (byte i = 0; i < BUCKETS; i++)
+			{
+				m_Buckets[i] = (m_Buckets[i] + 1) / 2;	//non-empty buckets stay non-empty
+			}
+		}
+		m_Buckets[bucket]++;
+
+		m_nCount++;
+		m_nTotal += us;
+		if (us > m_nMax)
+		{
+			m_nMax = us;
+		}
+	}
+
+	void ProfileStats::reset()
+	{
+		m_nCount = 0;
+		m_nTotal = 0;
+		m_nMax = 0;
+		memset(m_Buckets, 0, sizeof(m_Buckets));
+	}
+
+	unsigned long ProfileStats::getPercentile(byte percent) const
+	{
+		unsigned int samples = 0;
+		for (byte i = 0; i < BUCKETS; i++)
+		{
+			samples += m_Buckets[i];
+		}
+
+		unsigned int needed = ((unsigned long)samples * percent + 99) / 100;
+		unsigned int seen = 0;
+		for (byte i = 0; i < BUCKETS - 1; i++)
+		{
+			seen += m_Buckets[i];
+			if (seen >= needed)
+			{
+				unsigned long upper = (1UL << i) - 1;
+				return (upper < m_nMax) ? upper : m_nMax;
+			}
+		}
+		return m_nMax;
+	}
+
+	void ProfileStats::print(Print &out) const
+	{
+		out.print(F("count="));
+		out.print(m_nCount);
+		out.print(F(" total="));
+		out.print(m_nTotal);
+		out.print(F(" max="));
+		out.print(m_nMax);
+		out.print(F(" p99="));
+		out.print(getPercentile(99));
+	}
+}
+#endif
@@ -0,0 +1,74 @@
+//******************************************************************************************
+//  File: ProfileStats.h
+//  Authors: Dan G Ogorchock & Daniel J Ogorchock (Father and Son)
+//
+//  Summary:  st::ProfileStats collects execution time samples (in microseconds) for one device or one
+//			  phase of Everything::run() - call count, total, maximum, and a log2 bucketed histogram
+//			  from which percentiles (e.g. p99) are estimated.
+//
+//			  Only compiled in if ENABLE_PROFILER is defined in Constants.h.  The ST_PROFILE_START()
+//			  and ST_PROFILE_END() macros compile to nothing otherwise.
+//
+//			  Histogram bucket 0 counts 0us samples, bucket n counts samples from 2^(n-1) to 2^n - 1 us,
+//			  and the last bucket counts everything longer.  Buckets are single bytes - when one fills up
+//			  all of them are halved, which keeps the shape of the distribution that percentiles need.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  a00889920      Original Creation
+//
+//
+//******************************************************************************************
+
+#ifndef ST_PROFILESTATS_H
+#define ST_PROFILESTATS_H
+
+#include <Arduino.h>
+#include "Constants.h"
+
+#if defined(ENABLE_PROFILER)
+	#define ST_PROFILE_START(start) unsigned long start = micros()
+	#define ST_PROFILE_END(stats, start) (stats).record(micros() - (start))
+#else
+	#define ST_PROFILE_START(start)
+	#define ST_PROFILE_END(stats, start)
+#endif
+
+#if defined(ENABLE_PROFILER)
+namespace st
+{
+	class ProfileStats
+	{
+		public:
+			static const byte BUCKETS = 16;	//last bucket starts at 2^14 us = 16ms
+
+			//constructor
+			ProfileStats();
+
+			//adds one sample
+			void record(unsigned long us);
+
+			//forgets all samples
+			void reset();
+
+			//gets
+			unsigned long getCount() const {return m_nCount;}
+			unsigned long getTotal() const {return m_nTotal;}	//wraps after ~71 minutes of accumulated time
+			unsigned long getMax() const {return m_nMax;}
+			unsigned long getPercentile(byte percent) const;	//upper bound of the bucket holding that percentile, never more than getMax()
+
+			//prints "count=... total=... max=... p99=..." (microseconds) without a newline
+			void print(Print &out) const;
+
+		private:
+			unsigned long m_nCount;
+			unsigned long m_nTotal;
+			unsigned long m_nMax;
+			byte m_Buckets[BUCKETS];
+	};
+}
+#endif
+
+#endif
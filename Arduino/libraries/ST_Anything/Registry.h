@@ -0,0 +1,148 @@
+//******************************************************************************************
+//  File: Registry.h
+//  Authors: Dan G Ogorchock & Daniel J Ogorchock (Father and Son)
+//
+//  Summary:  st::Registry is an optional, compile-time list of the devices in a sketch.  It holds
+//			  st::Everything's device storage, sized for exactly these devices, in place of the
+//			  MAX_SENSOR_COUNT/MAX_EXECUTOR_COUNT sized arrays used by Everything::init() - a sketch
+//			  that uses a Registry never links those arrays.  It also calls update() on each device
+//			  by its declared type rather than through the Device vtable, so the compiler can inline it.
+//
+//			  The name index, schedule, refresh() and beSmart() dispatch all work as before.  Scheduled
+//			  devices (e.g. PollingSensors) are still woken by Everything's scheduler - the Registry
+//			  only updates the devices that need update() on every pass, in the order they are listed.
+//
+//			  Example (in setup(), after the devices are declared):
+//
+//				static st::Registry<st::IS_Contact, st::IS_Contact, st::EX_Switch> registry(sensor1, sensor2, executor1);
+//				registry.init();			//replaces st::Everything::init() and the addSensor()/addExecutor() calls
+//				st::Everything::initDevices();
+//
+//			  Each type must be the declared type of its device - update() is called as that type.
+//			  The Registry has no room for more devices, so addSensor()/addExecutor() fail after it.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  a00889920      Original Creation
+//
+//
+//******************************************************************************************
+
+#ifndef ST_REGISTRY_H
+#define ST_REGISTRY_H
+
+#include "Everything.h"
+
+namespace st
+{
+	//helpers used by the Registry templates - Everything and Device let this class at their storage and timings
+	class RegistryAccess
+	{
+		public:
+			//hands the Registry's storage, already holding its devices, to Everything, then initializes Everything
+			static void init(RegistryBase *registry, Sensor **sensors, byte sensorCount, Executor **executors, byte executorCount, byte *deviceIndex, Device **schedule)
+			{
+				Everything::useStorage(sensors, sensorCount, executors, executorCount, deviceIndex, schedule);
+				Everything::m_nSensorCount = sensorCount;
+				Everything::m_nExecutorCount = executorCount;
+				Everything::m_pRegistry = registry;
+				Everything::start();
+			}
+
+			//update() called as the device's own type - no vtable lookup, may be inlined
+			template<typename T> static void update(T *device)
+			{
+				if (!device->m_bScheduled)
+				{
+					ST_PROFILE_START(start);
+					device->T::update();
+					ST_PROFILE_END(device->m_UpdateStats, start);
+					Everything::sendStrings();
+				}
+			}
+
+			//a device's slot in the Registry's storage - picked by overload resolution
+			static Sensor *&slot(Sensor *, Sensor **sensors, Executor **executors, byte sensor, byte executor) {return sensors[sensor];}
+			static Executor *&slot(Executor *, Sensor **sensors, Executor **executors, byte sensor, byte executor) {return executors[executor];}
+
+			//compile-time Sensor test - sizeof(isSensor((T*)0)) is 1 for Sensors and 2 for Executors
+			static char (&isSensor(Sensor *))[1];
+			static char (&isSensor(Executor *))[2];
+	};
+
+	//non-template base so Everything can hold on to a Registry of any type
+	class RegistryBase
+	{
+		public:
+			virtual void updateAll() = 0;	//calls update() on every device in the Registry that is not scheduled
+	};
+
+	//the device types, expanded recursively at compile time.  SensorsBefore and ExecutorsBefore are how many of each come before First.
+	template<byte SensorsBefore, byte ExecutorsBefore, typename... Devices> class RegistryList;
+
+	template<byte SensorsBefore, byte ExecutorsBefore> class RegistryList<SensorsBefore, ExecutorsBefore>
+	{
+		public:
+			static const byte SENSOR_COUNT = 0;
+			static const byte EXECUTOR_COUNT = 0;
+
+			static void place(Sensor **sensors, Executor **executors) {}
+			static void updateAll(Sensor **sensors, Executor **executors) {}
+	};
+
+	template<byte SensorsBefore, byte ExecutorsBefore, typename First, typename... Rest> class RegistryList<SensorsBefore, ExecutorsBefore, First, Rest...>
+	{
+		private:
+			static const bool IS_SENSOR = (sizeof(RegistryAccess::isSensor((First *)0)) == 1);
+			typedef RegistryList<SensorsBefore + (IS_SENSOR ? 1 : 0), ExecutorsBefore + (IS_SENSOR ? 0 : 1), Rest...> Next;
+
+		public:
+			static const byte SENSOR_COUNT = (IS_SENSOR ? 1 : 0) + Next::SENSOR_COUNT;
+			static const byte EXECUTOR_COUNT = (IS_SENSOR ? 0 : 1) + Next::EXECUTOR_COUNT;
+
+			static void place(Sensor **sensors, Executor **executors, First &first, Rest&... rest)
+			{
+				RegistryAccess::slot(&first, sensors, executors, SensorsBefore, ExecutorsBefore) = &first;
+				Next::place(sensors, executors, rest...);
+			}
+
+			static void updateAll(Sensor **sensors, Executor **executors)
+			{
+				RegistryAccess::update(static_cast<First *>(RegistryAccess::slot((First *)0, sensors, executors, SensorsBefore, ExecutorsBefore)));
+				Next::updateAll(sensors, executors);
+			}
+	};
+
+	template<typename... Devices> class Registry : public RegistryBase
+	{
+		private:
+			typedef RegistryList<0, 0, Devices...> List;
+
+		public:
+			static const byte SENSOR_COUNT = List::SENSOR_COUNT;
+			static const byte EXECUTOR_COUNT = List::EXECUTOR_COUNT;
+
+			static_assert(sizeof...(Devices) > 0, "st::Registry needs at least one device");
+			static_assert(sizeof...(Devices) < Device::NOT_SCHEDULED, "Too many devices in st::Registry");
+
+		private:
+			Sensor *m_Sensors[SENSOR_COUNT > 0 ? SENSOR_COUNT : 1];
+			Executor *m_Executors[EXECUTOR_COUNT > 0 ? EXECUTOR_COUNT : 1];
+			byte m_DeviceIndex[SENSOR_COUNT + EXECUTOR_COUNT];
+			Device *m_Schedule[SENSOR_COUNT + EXECUTOR_COUNT];
+
+		public:
+			Registry(Devices&... devices) {List::place(m_Sensors, m_Executors, devices...);}
+
+			//st::Everything initialization routine, using this Registry's devices and storage - call it instead of Everything::init()
+			//and the addSensor()/addExecutor() calls, before Everything::initDevices().  The Registry must outlive Everything's use
+			//of it (declare it static).
+			void init() {RegistryAccess::init(this, m_Sensors, SENSOR_COUNT, m_Executors, EXECUTOR_COUNT, m_DeviceIndex, m_Schedule);}
+
+			virtual void updateAll() {List::updateAll(m_Sensors, m_Executors);}
+	};
+}
+
+#endif
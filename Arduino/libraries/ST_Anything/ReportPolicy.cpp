@@ -0,0 +1,97 @@
+//******************************************************************************************
+//  File: ReportPolicy.cpp
+//  Authors: Dan G Ogorchock & Daniel J Ogorchock (Father and Son)
+//
+//  Summary:  st::ReportPolicy decides whether a polled reading is worth sending to the hub.
+//			  See ReportPolicy.h for details.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  a00889920      Original Creation - moved out of PollingSensor so PollingSensorExtended can use it
+//
+//
+//******************************************************************************************
+
+#include "ReportPolicy.h"
+
+namespace st
+{
+//public
+	//constructor
+	ReportPolicy::ReportPolicy():
+		m_bEnabled(false),
+		m_bPercent(false),
+		m_fDeadband(0),
+		m_lMinInterval(0),
+		m_lMaxSilence(0)
+	{
+
+	}
+
+	bool ReportPolicy::shouldReport(float value, Channel &channel, bool force)
+	{
+		unsigned long now = millis();
+
+		if(m_bEnabled && channel.reported && !force)
+		{
+			float deadband = m_bPercent ? fabs(channel.last) * m_fDeadband / 100 : m_fDeadband;
+			unsigned long silence = now - channel.time;
+			bool heartbeat = (m_lMaxSilence > 0) && (silence >= m_lMaxSilence);
+
+			if(!heartbeat && ((fabs(value - channel.last) <= deadband) || (silence < m_lMinInterval)))
+			{
+				return false;
+			}
+		}
+
+		channel.reported = true;
+		channel.last = value;
+		channel.time = now;
+		return true;
+	}
+
+	bool ReportPolicy::beSmart(const String &str)
+	{
+		String s = str.substring(str.indexOf(' ') + 1);
+		int space = s.indexOf(' ');
+
+		if(space < 0)
+		{
+			return false;	//not a "<name> <command> <value>" message
+		}
+
+		String command = s.substring(0, space);
+		String value = s.substring(space + 1);
+
+		if(command == "deadband")
+		{
+			m_fDeadband = value.toFloat();
+			m_bPercent = value.endsWith("%");
+		}
+		else if(command == "minreport")
+		{
+			m_lMinInterval = value.toInt() * 1000;
+		}
+		else if(command == "heartbeat")
+		{
+			m_lMaxSilence = value.toInt() * 1000;
+		}
+		else
+		{
+			return false;
+		}
+		m_bEnabled = true;
+		return true;
+	}
+
+	void ReportPolicy::set(float deadband, bool percent, long minInterval, long heartbeat)
+	{
+		m_fDeadband = deadband;
+		m_bPercent = percent;
+		m_lMinInterval = minInterval * 1000;
+		m_lMaxSilence = heartbeat * 1000;
+		m_bEnabled = true;
+	}
+}
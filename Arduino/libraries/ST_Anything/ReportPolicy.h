@@ -0,0 +1,64 @@
+//******************************************************************************************
+//  File: ReportPolicy.h
+//  Authors: Dan G Ogorchock & Daniel J Ogorchock (Father and Son)
+//
+//  Summary:  st::ReportPolicy decides whether a polled reading is worth sending to the hub - a deadband
+//			  (absolute, or percent of the last value sent), a minimum time between sends, and a heartbeat
+//			  after which an unchanged reading is sent anyway.  Without a policy every reading is sent.
+//
+//			  One policy is shared by all the values a sensor sends.  Each value keeps its own
+//			  ReportPolicy::Channel (last value sent, and when), so e.g. the temperature and humidity of
+//			  one sensor are judged separately.  Used by st::PollingSensor and st::PollingSensorExtended.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  a00889920      Original Creation - moved out of PollingSensor so PollingSensorExtended can use it
+//
+//
+//******************************************************************************************
+
+#ifndef ST_REPORTPOLICY_H
+#define ST_REPORTPOLICY_H
+
+#include <Arduino.h>
+
+namespace st
+{
+	class ReportPolicy
+	{
+		public:
+			//what was last sent for one value
+			struct Channel
+			{
+				bool reported;				//true once a reading has been sent
+				float last;					//last value sent
+				unsigned long time;			//in milliseconds - time the last value was sent
+
+				Channel() : reported(false), last(0), time(0) {}
+			};
+
+			//constructor - no policy, every reading is sent
+			ReportPolicy();
+
+			//returns true (and remembers value as sent on channel) if the reading should be sent - force always sends
+			bool shouldReport(float value, Channel &channel, bool force = false);
+
+			//handles "<name> deadband <value>[%]", "<name> minreport <seconds>" and "<name> heartbeat <seconds>" - returns false if str is not one of them
+			bool beSmart(const String &str);
+
+			//sets
+			void set(float deadband, bool percent = false, long minInterval = 0, long heartbeat = 0); //minInterval and heartbeat in seconds
+			void clear() {m_bEnabled = false;}	//send every reading again
+
+		private:
+			bool m_bEnabled;				//false == send every reading (default)
+			bool m_bPercent;				//true == m_fDeadband is a percentage of the last value sent
+			float m_fDeadband;				//change from the last value sent that is too small to be worth sending
+			unsigned long m_lMinInterval;	//in milliseconds - minimum time between sends
+			unsigned long m_lMaxSilence;	//in milliseconds - send even an unchanged reading after this long (0 = never)
+	};
+}
+
+#endif
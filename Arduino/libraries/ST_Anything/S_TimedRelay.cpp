@@ -28,6 +28,7 @@
 //    2018-08-30  Dan Ogorchock  Modified comment section above to comply with new Parent/Child Device Handler requirements
 //    2019-06-23  Brian Wilson   Added finalState option
 //    2020-10-20  Dan Ogorchock  Fixed minor bug to ensure proper reporting of device state 
+//    2026-10-16  a00889920      Ported onto the Everything scheduler - update() only runs when the on/off timer expires
 //
 //
 //******************************************************************************************
@@ -60,6 +61,7 @@ namespace st
 		m_bTimerPending(false)
 		{
 			setOutputPin(pinOutput);
+			setScheduled(true);	//update() only has work to do when the on/off timer expires
 
 			if (numCycles < 1)
 			{
@@ -95,13 +97,13 @@ namespace st
 					{
 						m_bCurrentState = LOW;
 						writeStateToPin();
-						m_lTimeChanged = millis();
+						m_lTimeChanged += m_lOnTime;	//measure from when the change was due, so cycles do not drift
 					}
 
 				} else {
 						m_bCurrentState = LOW;
 						writeStateToPin();
-						m_lTimeChanged = millis();
+						m_lTimeChanged += m_lOnTime;
 				}
 			}
 			else if ((m_bCurrentState == LOW) && (millis() - m_lTimeChanged >= m_lOffTime))
@@ -113,12 +115,12 @@ namespace st
 					{
 						m_bCurrentState = HIGH;
 						writeStateToPin();
-						m_lTimeChanged = millis();
+						m_lTimeChanged += m_lOffTime;
 					}
 				} else {
 						m_bCurrentState = HIGH;
 						writeStateToPin();
-						m_lTimeChanged = millis();
+						m_lTimeChanged += m_lOffTime;
 				}	
 			}
 			
@@ -132,6 +134,11 @@ namespace st
 				//Queue the relay status update the ST Cloud
 				Everything::sendSmartString(getName() + " " + (m_bCurrentState == HIGH ? F("on") : F("off")));
 			}
+			else
+			{
+				//wake up again when the current on or off period ends
+				scheduleUpdate(m_lTimeChanged + (m_bCurrentState == HIGH ? m_lOnTime : m_lOffTime));
+			}
 		}
 	}
 
@@ -163,6 +170,9 @@ namespace st
 
 			//update the digital output
 			writeStateToPin();
+
+			//wake up when the on time expires
+			scheduleUpdate(m_lTimeChanged + m_lOnTime);
 		}
 		else if ((s == F("off")) && (m_bCurrentState == HIGH))
 		{
@@ -177,6 +187,7 @@ namespace st
 			
 			//Reset the count to the number of required cycles to prevent Update() routine from running if someone sends an OFF command
 			m_iCurrentCount = m_iNumCycles;
+			cancelUpdate();
 
 			//update the digital output
 			writeStateToPin();
@@ -28,6 +28,7 @@
 //    2018-08-30  Dan Ogorchock  Modified comment section above to comply with new Parent/Child Device Handler requirements
 //    2019-06-23  Brian Wilson   Added finalState option
 //    2019-08-10  Dan Ogorchock  Added public getStatus() 
+//    2026-10-16  a00889920      Ported onto the Everything scheduler - update() only runs when the on/off timer expires
 //
 //
 //******************************************************************************************
@@ -38,6 +38,7 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2018-07-01  Dan & Daniel   Original Creation
+//    2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
 //
 //******************************************************************************************
 
@@ -90,6 +91,11 @@ namespace st
 	//SmartThings Shield data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
 	void PS_AdafruitBME280_TempHumidPress::beSmart(const String &str)
 	{
+		if (beSmartReportPolicy(str))
+		{
+			return;	//deadband, minreport or heartbeat command
+		}
+
 		String s = str.substring(str.indexOf(' ') + 1);
 
 		if (s.toInt() != 0) {
@@ -184,9 +190,18 @@ namespace st
 				m_fPressureSensorValue = (m_fFilterConstant * (bme.readPressure() / 100.0F)) + (1 - m_fFilterConstant) * m_fPressureSensorValue;
 			}
 
-		Everything::sendSmartString(m_strTemperature + " " + String(m_fTemperatureSensorValue));
-		Everything::sendSmartString(m_strHumidity + " " + String(m_fHumiditySensorValue));
-		Everything::sendSmartString(m_strPressure + " " + String(m_fPressureSensorValue));
+		if (shouldReport(m_fTemperatureSensorValue))
+		{
+			Everything::sendSmartString(m_strTemperature + " " + String(m_fTemperatureSensorValue));
+		}
+		if (shouldReport(m_fHumiditySensorValue, m_HumidityReport))
+		{
+			Everything::sendSmartString(m_strHumidity + " " + String(m_fHumiditySensorValue));
+		}
+		if (shouldReport(m_fPressureSensorValue, m_PressureReport))
+		{
+			Everything::sendSmartString(m_strPressure + " " + String(m_fPressureSensorValue));
+		}
 
 	}
 	
@@ -38,6 +38,7 @@
 //    Date        Who            What
 //    ----        ---            ----
 //    2018-07-01  Dan & Daniel   Original Creation
+//    2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
 //
 //******************************************************************************************
 
@@ -62,6 +63,8 @@ namespace st
 			String m_strPressure;			//name of pressure sensor to use when transferring data to ST Cloud / Hubitat		
 			bool m_In_C;					//Return temp in C (true or false)
 			float m_fFilterConstant;        //Filter constant % as floating point from 0.00 to 1.00
+			ReportPolicy::Channel m_HumidityReport;	//last humidity sent - the temperature uses the PollingSensor's own channel
+			ReportPolicy::Channel m_PressureReport;	//last pressure sent
 
 		public:
 			//constructor - called in your sketch's global variable declaration section 
@@ -0,0 +1,272 @@
+//******************************************************************************************
+//  File: PS_DS18B20_MultiBus.cpp
+//  Author: Dan G Ogorchock
+//
+//  Summary:  PS_DS18B20_MultiBus is a class which implements the SmartThings "Temperature Measurement" capability for
+//			  DS18B20 sensors spread over several One-Wire buses, one per digital pin (e.g. to keep each cable run short).
+//			  It inherits from the st::PollingSensorExtended class.
+//
+//			  preGetData() starts a conversion on every bus at once, and getData() reads all of the sensors one
+//			  conversion time later - so a poll takes about one conversion time however many buses there are, and
+//			  the loop is not held up while the sensors convert.
+//
+//			  Create an instance of this class in your sketch's global variable section
+//			  For Example:  const byte tempPins[] = {PIN_TEMPERATURE_1, PIN_TEMPERATURE_2, PIN_TEMPERATURE_3};
+//							const byte tempCounts[] = {4, 2, 3};
+//							st::PS_DS18B20_MultiBus sensor1(F("temperature"), 60, 0, tempPins, tempCounts, 3, false, 10);
+//
+//			  See PS_DS18B20_MultiBus.h for the constructor's arguments.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  a00889920      Original Creation, based on PS_DS18B20_Temperature
+//    2026-10-16  a00889920      Readings are sent through the reporting policy (deadband / minreport / heartbeat), per sensor
+//
+//
+//******************************************************************************************
+#include "PS_DS18B20_MultiBus.h"
+
+#include "Constants.h"
+#include "Everything.h"
+#include "PollingSensor.h"		//st::PollingSensor::debug switches this sensor's debug output, as for PS_DS18B20_Temperature
+#include <Wire.h>
+#include <OneWire.h>
+#include <DallasTemperature.h>
+
+namespace st
+{
+//private
+	//finds the ROM address of each sensor on one bus - the only time the bus is searched
+	void PS_DS18B20_MultiBus::findSensors(Bus_t &bus)
+	{
+		bus.sensors->begin();				   //Count the devices and check for parasite power
+		bus.found = 0;
+
+		bus.wire->reset_search();
+		while ((bus.found < bus.count) && bus.wire->search(m_Addresses[bus.first + bus.found]))
+		{
+			uint8_t *address = m_Addresses[bus.first + bus.found];
+			if (bus.sensors->validAddress(address) && bus.sensors->validFamily(address))
+			{
+				bus.sensors->setResolution(address, m_Resolution, true);
+				bus.found++;
+			}
+		}
+		bus.rescan = (bus.found < bus.count);
+
+		if (st::PollingSensor::debug) {
+			Serial.print(F("PS_DS18B20_MultiBus:: Found "));
+			Serial.print(bus.found);
+			Serial.print(F(" of "));
+			Serial.print(bus.count);
+			Serial.print(F(" sensors starting at # "));
+			Serial.println(m_sensorStartingNum + bus.first);
+		}
+	}
+
+	//reads one sensor by its cached address - returns DEVICE_DISCONNECTED_C if every attempt fails
+	float PS_DS18B20_MultiBus::readSensor(Bus_t &bus, byte index)
+	{
+		if (index >= bus.first + bus.found)
+		{
+			m_ReadErrors[index]++;			//not found on the bus
+			return DEVICE_DISCONNECTED_C;
+		}
+
+		for (byte attempt = 0; attempt <= READ_RETRIES; attempt++)
+		{
+			//the conversion result stays in the scratchpad, so a bad read can simply be repeated
+			float tempC = bus.sensors->getTempC(m_Addresses[index]);
+			if (tempC != DEVICE_DISCONNECTED_C)
+			{
+				return tempC;
+			}
+
+			m_ReadErrors[index]++;
+			if (st::PollingSensor::debug) {
+				Serial.print(F("PS_DS18B20_MultiBus:: Bad CRC or no reply from sensor # "));
+				Serial.println(m_sensorStartingNum + index);
+			}
+		}
+
+		bus.rescan = true;	//search the bus again before the next conversion
+		return DEVICE_DISCONNECTED_C;
+	}
+
+	void PS_DS18B20_MultiBus::sendValue(byte index)
+	{
+		if (m_numSensors == 1)
+		{
+			Everything::sendSmartString(getName() + " " + String(m_Values[index]));
+		}
+		else
+		{
+			Everything::sendSmartString(getName() + (m_sensorStartingNum + index) + " " + String(m_Values[index]));
+		}
+	}
+
+//public
+	//constructor - called in your sketch's global variable declaration section
+	PS_DS18B20_MultiBus::PS_DS18B20_MultiBus(const __FlashStringHelper *name, unsigned int interval, int offset, const byte *pins, const byte *num_sensors, byte num_buses, bool In_C, byte resolution, byte sensorStartingNum) :
+		PollingSensorExtended(name, 0, interval, 0, offset),
+		m_numBuses(num_buses),
+		m_numSensors(0),
+		m_sensorStartingNum(sensorStartingNum),
+		m_In_C(In_C),
+		m_Resolution(resolution)
+	{
+		m_Buses = new Bus_t[m_numBuses];
+		for (byte b = 0; b < m_numBuses; b++)
+		{
+			m_Buses[b].wire = new OneWire(pins[b]);
+			m_Buses[b].sensors = new DallasTemperature(m_Buses[b].wire);
+			m_Buses[b].first = m_numSensors;
+			m_Buses[b].count = num_sensors[b];
+			m_Buses[b].found = 0;
+			m_Buses[b].rescan = true;
+			m_numSensors += num_sensors[b];
+		}
+
+		m_Addresses = new DeviceAddress[m_numSensors];
+		m_Values = new float[m_numSensors];
+		m_Reports = new ReportPolicy::Channel[m_numSensors];
+		m_ReadErrors = new unsigned int[m_numSensors];
+		for (byte i = 0; i < m_numSensors; i++)
+		{
+			m_Values[i] = -99.0;
+			m_ReadErrors[i] = 0;
+		}
+
+		//all of the buses convert at the same time, so a poll waits for one conversion
+		if (m_numBuses > 0)
+		{
+			setPreInterval(m_Buses[0].sensors->millisToWaitForConversion(m_Resolution));
+		}
+	}
+
+	//destructor
+	PS_DS18B20_MultiBus::~PS_DS18B20_MultiBus()
+	{
+		for (byte b = 0; b < m_numBuses; b++)
+		{
+			delete m_Buses[b].sensors;
+			delete m_Buses[b].wire;
+		}
+		delete[] m_Buses;
+		delete[] m_Addresses;
+		delete[] m_Values;
+		delete[] m_Reports;
+		delete[] m_ReadErrors;
+	}
+
+	//SmartThings Shield data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
+	void PS_DS18B20_MultiBus::beSmart(const String &str)
+	{
+		if (beSmartReportPolicy(str))
+		{
+			return;	//deadband, minreport or heartbeat command
+		}
+
+		String s = str.substring(str.indexOf(' ') + 1);
+
+		if (s.toInt() != 0) {
+			st::PollingSensorExtended::setInterval(s.toInt() * 1000);
+			if (st::PollingSensor::debug) {
+				Serial.print(F("PS_DS18B20_MultiBus::beSmart set polling interval to "));
+				Serial.println(s.toInt());
+			}
+		}
+		else {
+			if (st::PollingSensor::debug)
+			{
+				Serial.print(F("PS_DS18B20_MultiBus::beSmart cannot convert "));
+				Serial.print(s);
+				Serial.println(F(" to an Integer."));
+			}
+		}
+	}
+
+	//initialization routine - get first set of readings and send to ST cloud
+	void PS_DS18B20_MultiBus::init()
+	{
+		for (byte b = 0; b < m_numBuses; b++)
+		{
+			findSensors(m_Buses[b]);
+			m_Buses[b].sensors->setWaitForConversion(false);	//requestTemperatures() returns at once - getData() reads the results later
+		}
+		preGetData();						   //Get temperatures once, to ensure clean data before sending to ST
+		if (m_numBuses > 0)
+		{
+			delay(m_Buses[0].sensors->millisToWaitForConversion(m_Resolution));	//only init() waits for the conversion
+		}
+		getData();							   //Get temperature data and send to ST cloud
+	}
+
+	//sends the last readings - the buses are not touched
+	void PS_DS18B20_MultiBus::refresh()
+	{
+		for (byte i = 0; i < m_numSensors; i++)
+		{
+			shouldReport(m_Values[i], m_Reports[i], true);	//always sent, and counts as a report
+			sendValue(i);
+		}
+	}
+
+	//starts a conversion on every bus, one straight after another (Skip ROM, Convert T) - the results are read by getData()
+	void PS_DS18B20_MultiBus::preGetData()
+	{
+		if (st::PollingSensor::debug) {
+			Serial.println(F("PS_DS18B20_MultiBus::Requesting temperatures..."));
+		}
+
+		for (byte b = 0; b < m_numBuses; b++)
+		{
+			if (m_Buses[b].rescan)
+			{
+				findSensors(m_Buses[b]);	//a sensor was missing or stopped answering - look for it again
+			}
+			m_Buses[b].sensors->requestTemperatures();
+		}
+	}
+
+	//function to get data from sensors and queue results for transfer to ST Cloud
+	void PS_DS18B20_MultiBus::getData()
+	{
+		for (byte b = 0; b < m_numBuses; b++)
+		{
+			Bus_t &bus = m_Buses[b];
+			for (byte i = bus.first; i < bus.first + bus.count; i++)
+			{
+				float tempC = readSensor(bus, i);
+
+				if (tempC == DEVICE_DISCONNECTED_C)
+				{
+					if (st::PollingSensor::debug) {
+						Serial.print(F("PS_DS18B20_MultiBus:: Error Reading Sensor # "));
+						Serial.println(m_sensorStartingNum + i);
+					}
+					m_Values[i] = -99.0;
+				}
+				else
+				{
+					m_Values[i] = m_In_C ? tempC : DallasTemperature::toFahrenheit(tempC);
+				}
+
+				if (st::PollingSensor::debug) {
+					Serial.print(F("PS_DS18B20_MultiBus:: Temperature for the device # "));
+					Serial.print(m_sensorStartingNum + i);
+					Serial.print(F(" is: "));
+					Serial.println(m_Values[i]);
+				}
+
+				if (shouldReport(m_Values[i], m_Reports[i]))
+				{
+					sendValue(i);
+				}
+			}
+		}
+	}
+
+}
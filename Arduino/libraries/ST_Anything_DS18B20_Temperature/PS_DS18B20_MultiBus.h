@@ -0,0 +1,127 @@
+//******************************************************************************************
+//  File: PS_DS18B20_MultiBus.h
+//  Author: Dan G Ogorchock
+//
+//  Summary:  PS_DS18B20_MultiBus is a class which implements the SmartThings "Temperature Measurement" capability for
+//			  DS18B20 sensors spread over several One-Wire buses, one per digital pin (e.g. to keep each cable run short).
+//			  It inherits from the st::PollingSensorExtended class.
+//
+//			  preGetData() starts a conversion on every bus at once, and getData() reads all of the sensors one
+//			  conversion time later - so a poll takes about one conversion time however many buses there are, and
+//			  the loop is not held up while the sensors convert.  The sensors' ROM addresses are found by init(), and
+//			  a bus is only searched again when one of its sensors is missing or cannot be read.
+//
+//			  A reading whose scratchpad CRC is bad is read again, up to READ_RETRIES more times.  If it still fails,
+//			  -99 is sent for that sensor, and getReadErrors() counts the failure.
+//
+//			  Sensors are numbered the same way as PS_DS18B20_Temperature's, counting from sensorStartingNum:  the
+//			  first bus's sensors come first, in bus search order, then the second bus's, and so on.  Each bus keeps
+//			  the block of numbers given by its entry in num_sensors, so a missing sensor never renumbers the others.
+//
+//			  Create an instance of this class in your sketch's global variable section
+//			  For Example:  const byte tempPins[] = {PIN_TEMPERATURE_1, PIN_TEMPERATURE_2, PIN_TEMPERATURE_3};
+//							const byte tempCounts[] = {4, 2, 3};
+//							st::PS_DS18B20_MultiBus sensor1(F("temperature"), 60, 0, tempPins, tempCounts, 3, false, 10);
+//							(sends temperature1 to temperature4 from the first pin, temperature5 and temperature6 from the
+//							second, and temperature7 to temperature9 from the third)
+//
+//			  st::PS_DS18B20_MultiBus() constructor requires the following arguments
+//				- String &name - REQUIRED - the name of the object - "temperature"
+//				- long interval - REQUIRED - the polling interval in seconds
+//				- long offset - REQUIRED - the polling interval offset in seconds - used to prevent all polling sensors from executing at the same time
+//				- const byte *pins - REQUIRED - the Arduino Pin of each One-Wire bus (the array must stay in scope - declare it globally)
+//				- const byte *num_sensors - REQUIRED - number of DS18B20 sensors attached to each bus (also global)
+//				- byte num_buses - REQUIRED - number of entries in pins and num_sensors
+//				- bool In_C - OPTIONAL - true = Report Celsius, false = Report Farenheit (Farentheit is the default)
+//				- byte resolution - OPTIONAL - DS18B20 sensor resolution in bits.  9, 10, 11, or 12.  Defaults to 10 for decent accuracy and performance
+//				- byte sensorStartingNum - OPTIONAL - Starting number for sending temperature sensor data - Defaults to 1
+//
+//			  This class supports receiving configuration data from the SmartThings cloud via the ST App.  A user preference
+//			  can be configured in your phone's ST App, and then the "Configure" tile will send the data for all sensors to
+//			  the ST Shield.  For PollingSensors, this data is handled in the beSMart() function.
+//
+//  Change History:
+//
+//    Date        Who            What
+//    ----        ---            ----
+//    2026-10-16  a00889920      Original Creation, based on PS_DS18B20_Temperature
+//    2026-10-16  a00889920      Readings are sent through the reporting policy (deadband / minreport / heartbeat), per sensor
+//
+//
+//******************************************************************************************
+#ifndef ST_PS_DS18B20_MULTIBUS_H
+#define ST_PS_DS18B20_MULTIBUS_H
+
+
+#include "PollingSensorExtended.h"
+#include <Wire.h>
+#include <OneWire.h>
+#include <DallasTemperature.h>
+
+namespace st
+{
+	class PS_DS18B20_MultiBus : public PollingSensorExtended
+	{
+		public:
+			static const byte READ_RETRIES = 2;		//extra reads of a sensor whose scratchpad CRC is bad
+
+		private:
+			typedef struct
+			{
+				OneWire *wire;
+				DallasTemperature *sensors;
+				byte first;							//index of the bus's first sensor in m_Addresses and m_Values
+				byte count;							//sensors expected on the bus
+				byte found;							//sensors whose address is known
+				bool rescan;						//a sensor is missing or could not be read - search the bus before the next conversion
+			} Bus_t;
+
+			Bus_t *m_Buses;
+			byte m_numBuses;
+			byte m_numSensors;						//total over all buses
+			byte m_sensorStartingNum;				//starting number of the sensors for data transfer
+			bool m_In_C;							//Return temp in C
+			byte m_Resolution;						//Sensor resolution in bits
+			DeviceAddress *m_Addresses;				//ROM address of each sensor, by bus (m_numSensors entries)
+			float *m_Values;						//last value read from each sensor - sent by refresh()
+			ReportPolicy::Channel *m_Reports;		//last value sent for each sensor, for the reporting policy
+			unsigned int *m_ReadErrors;				//failed reads of each sensor, retries included
+
+			void findSensors(Bus_t &bus);			//searches one bus for its sensors' ROM addresses
+			float readSensor(Bus_t &bus, byte index);	//reads one sensor by address, retrying on a bad CRC
+			void sendValue(byte index);				//sends m_Values[index] to ST
+
+		public:
+
+			//constructor - called in your sketch's global variable declaration section
+			PS_DS18B20_MultiBus(const __FlashStringHelper *name, unsigned int interval, int offset, const byte *pins, const byte *num_sensors, byte num_buses, bool In_C = false, byte resolution = 10, byte sensorStartingNum = 1);
+
+			//destructor
+			virtual ~PS_DS18B20_MultiBus();
+
+			//SmartThings Shield data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
+			virtual void beSmart(const String &str);
+
+			//initialization routine
+			virtual void init();
+
+			//called periodically by Everything class to ensure ST Cloud is kept consistent - sends the last values read
+			virtual void refresh();
+
+			//starts a temperature conversion on every bus - returns at once
+			virtual void preGetData();
+
+			//function to get data from sensors and queue results for transfer to ST Cloud
+			virtual void getData();
+
+			//gets
+			inline byte getSensorCount() const { return m_numSensors; }
+			inline float getTemperatureSensorValue(byte index) const { return m_Values[index]; }
+			inline unsigned int getReadErrors(byte index) const { return m_ReadErrors[index]; }
+
+			//sets
+
+	};
+}
+
+#endif /* ST_PS_DS18B20_MULTIBUS_H */
@@ -3,9 +3,13 @@
 //  Author: Dan G Ogorchock
 //
 //  Summary:  PS_DS18B20_Temperature is a class which implements both the SmartThings "Temperature Measurement" capability.
-//			  It inherits from the st::PollingSensor class.  The current version uses a digital pin to measure the 
+//			  It inherits from the st::PollingSensorExtended class.  The current version uses a digital pin to measure the 
 //			  temperature from a Dallas Semiconductor One Wire DS18B20 series sensor. 
 //
+//			  Each poll is done in two steps, so the loop is never held up for the conversion:  preGetData() starts
+//			  a conversion on every sensor at once, and getData() reads the results one conversion time later.  The
+//			  sensors' ROM addresses are found once by init() and each is then read by address, without a bus search.
+//
 //			  Create an instance of this class in your sketch's global variable section
 //			  For Example:  st::PS_DS18B20_Temperature sensor1(F("temperature1"), 120, 0, PIN_TEMPERATURE, false); (for a single sensor)
 //                          st::PS_DS18B20_Temperature sensor1(F("temperature"), 120, 0, PIN_TEMPERATURE, false, 10, 3); (for 3 sensors)
@@ -37,6 +41,8 @@
 //    2018-08-30  Dan Ogorchock  Modified comment section above to comply with new Parent/Child Device Handler requirements
 //    2019-03-11  Dan Ogorchock  Added new optional parameter for starting sensor number for data transfer
 //    2019-07-05  Dan Ogorchock  Fix bug in multiple sensor support logic
+//    2026-10-16  a00889920      Non-blocking conversions on PollingSensorExtended, ROM addresses cached by init()
+//    2026-10-16  a00889920      Readings are sent through the reporting policy (deadband / minreport / heartbeat), per sensor
 //
 //
 //******************************************************************************************
@@ -44,6 +50,7 @@
 
 #include "Constants.h"
 #include "Everything.h"
+#include "PollingSensor.h"		//st::PollingSensor::debug still switches this sensor's debug output
 #include <Wire.h>
 #include <OneWire.h>
 #include <DallasTemperature.h>
@@ -51,36 +58,90 @@
 namespace st
 {
 //private
+	//finds the ROM address of each sensor - the only time the bus is searched
+	void PS_DS18B20_Temperature::findSensors()
+	{
+		m_DS18B20.begin();					   //Count the devices and check for parasite power
+		m_nFound = 0;
+
+		//one pass over the bus - getAddress() would start a new search for every index
+		m_OneWireBus.reset_search();
+		while ((m_nFound < m_numSensors) && m_OneWireBus.search(m_Addresses[m_nFound]))
+		{
+			if (m_DS18B20.validAddress(m_Addresses[m_nFound]) && m_DS18B20.validFamily(m_Addresses[m_nFound]))
+			{
+				m_DS18B20.setResolution(m_Addresses[m_nFound], m_Resolution, true);
+				m_nFound++;
+			}
+		}
+		m_bRescan = (m_nFound < m_numSensors);
 
+		if (st::PollingSensor::debug) {
+			Serial.print(F("PS_DS18B20_Temperature:: Found "));
+			Serial.print(m_nFound);
+			Serial.print(F(" of "));
+			Serial.println(m_numSensors);
+		}
+	}
+
+	void PS_DS18B20_Temperature::sendValue(byte index)
+	{
+		if (m_numSensors == 1)
+		{
+			Everything::sendSmartString(getName() + " " + String(m_Values[index]));
+		}
+		else
+		{
+			Everything::sendSmartString(getName() + (m_sensorStartingNum + index) + " " + String(m_Values[index]));
+		}
+	}
 
 //public
 	//constructor - called in your sketch's global variable declaration section
 	PS_DS18B20_Temperature::PS_DS18B20_Temperature(const __FlashStringHelper *name, unsigned int interval, int offset, byte pin, bool In_C, byte resolution, byte num_sensors, byte sensorStartingNum) :
-		PollingSensor(name, interval, offset),
+		PollingSensorExtended(name, 0, interval, 0, offset),
 		m_dblTemperatureSensorValue(0.0),
 		m_OneWireBus(pin),
 		m_DS18B20(&m_OneWireBus),
 		m_In_C(In_C),
 		m_Resolution(resolution),
 		m_numSensors(num_sensors),
-		m_sensorStartingNum(sensorStartingNum)
+		m_sensorStartingNum(sensorStartingNum),
+		m_nFound(0),
+		m_bRescan(true)
 	{
-		
+		m_Addresses = new DeviceAddress[m_numSensors];
+		m_Values = new float[m_numSensors];
+		m_Reports = new ReportPolicy::Channel[m_numSensors];
+		for (byte i = 0; i < m_numSensors; i++)
+		{
+			m_Values[i] = -99.0;
+		}
+
+		//the conversion is started this long before the readings are due
+		setPreInterval(m_DS18B20.millisToWaitForConversion(m_Resolution));
 	}
 
 	//destructor
 	PS_DS18B20_Temperature::~PS_DS18B20_Temperature()
 	{
-
+		delete[] m_Addresses;
+		delete[] m_Values;
+		delete[] m_Reports;
 	}
 
 	//SmartThings Shield data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
 	void PS_DS18B20_Temperature::beSmart(const String &str)
 	{
+		if (beSmartReportPolicy(str))
+		{
+			return;	//deadband, minreport or heartbeat command
+		}
+
 		String s = str.substring(str.indexOf(' ') + 1);
 
 		if (s.toInt() != 0) {
-			st::PollingSensor::setInterval(s.toInt() * 1000);
+			st::PollingSensorExtended::setInterval(s.toInt() * 1000);
 			if (st::PollingSensor::debug) {
 				Serial.print(F("PS_DS18B20_Temperature::beSmart set polling interval to "));
 				Serial.println(s.toInt());
@@ -99,62 +160,71 @@ namespace st
 	//initialization routine - get first set of readings and send to ST cloud
 	void PS_DS18B20_Temperature::init()
 	{
-		m_DS18B20.begin();					   //Initialize the DallasTemperature library
-		m_DS18B20.setResolution(m_Resolution); //Set the temperature sensor resolution
-		m_DS18B20.requestTemperatures();	   //Send the command to get temperatures once, to ensure clean data before sending to ST
-		delay(500);						       //Wait 500ms to let sensors stabilize
+		findSensors();
+		m_DS18B20.setWaitForConversion(false); //requestTemperatures() returns at once - getData() reads the results later
+		preGetData();						   //Get temperatures once, to ensure clean data before sending to ST
+		delay(m_DS18B20.millisToWaitForConversion(m_Resolution));	//only init() waits for the conversion
 		getData();							   //Get temperature data and send to ST cloud
 	}
 
-	//function to get data from sensor and queue results for transfer to ST Cloud
-	void PS_DS18B20_Temperature::getData()
+	//sends the last readings - the bus is not touched
+	void PS_DS18B20_Temperature::refresh()
 	{
-		if (st::PollingSensor::debug) {
-			Serial.print(F("PS_DS18B20_Temperature::Requesting temperatures..."));
+		for (byte i = 0; i < m_numSensors; i++)
+		{
+			shouldReport(m_Values[i], m_Reports[i], true);	//always sent, and counts as a report
+			sendValue(i);
+		}
+	}
+
+	//starts a conversion on every sensor at once (Skip ROM, Convert T) - the results are read by getData()
+	void PS_DS18B20_Temperature::preGetData()
+	{
+		if (m_bRescan)
+		{
+			findSensors();	//a sensor was missing or stopped answering - look for it again
 		}
-		
-		m_DS18B20.requestTemperatures(); // Send the command to get temperatures
 
 		if (st::PollingSensor::debug) {
-			Serial.println(F("DONE"));
+			Serial.println(F("PS_DS18B20_Temperature::Requesting temperatures..."));
 		}
 
-		byte maxSensorNum = m_sensorStartingNum + m_numSensors - 1;
-		for (int index = m_sensorStartingNum; index <= maxSensorNum; index++)
+		m_DS18B20.requestTemperatures(); // Send the command to get temperatures
+	}
+
+	//function to get data from sensor and queue results for transfer to ST Cloud
+	void PS_DS18B20_Temperature::getData()
+	{
+		for (byte i = 0; i < m_numSensors; i++)
 		{
-			if (m_In_C)
+			//reads the scratchpad of the sensor at the cached address, and checks its CRC
+			float tempC = (i < m_nFound) ? m_DS18B20.getTempC(m_Addresses[i]) : DEVICE_DISCONNECTED_C;
+
+			if (tempC == DEVICE_DISCONNECTED_C)
 			{
-				m_dblTemperatureSensorValue = m_DS18B20.getTempCByIndex(index-m_sensorStartingNum);
+				if (st::PollingSensor::debug) {
+					Serial.print(F("PS_DS18B20_Temperature:: Error Reading Sensor # "));
+					Serial.println(m_sensorStartingNum + i);
+				}
+				m_dblTemperatureSensorValue = -99.0;
+				m_bRescan = true;	//search the bus again before the next conversion
 			}
 			else
 			{
-				m_dblTemperatureSensorValue = m_DS18B20.getTempFByIndex(index-m_sensorStartingNum);
+				m_dblTemperatureSensorValue = m_In_C ? tempC : DallasTemperature::toFahrenheit(tempC);
 			}
 
 			if (st::PollingSensor::debug) {
 				Serial.print(F("PS_DS18B20_Temperature:: Temperature for the device # "));
-				Serial.print(index);
+				Serial.print(m_sensorStartingNum + i);
 				Serial.print(F(" is: "));
 				Serial.println(m_dblTemperatureSensorValue);
 			}
 
-
-			if (isnan(m_dblTemperatureSensorValue))
-			{
-				if (st::PollingSensor::debug) {
-					Serial.print(F("PS_DS18B20_Temperature:: Error Reading Sensor # "));
-					Serial.println(index);
-				}
-				m_dblTemperatureSensorValue = -99.0;
-			}
-
-			if (m_numSensors == 1)
-			{
-				Everything::sendSmartString(getName() + " " + String(m_dblTemperatureSensorValue));
-			}
-			else
+			m_Values[i] = m_dblTemperatureSensorValue;
+			if (shouldReport(m_Values[i], m_Reports[i]))
 			{
-				Everything::sendSmartString(getName() + index + " " + String(m_dblTemperatureSensorValue));
+				sendValue(i);
 			}
 		}
 	}
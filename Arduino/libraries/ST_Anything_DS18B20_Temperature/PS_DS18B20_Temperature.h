@@ -3,9 +3,13 @@
 //  Author: Dan G Ogorchock
 //
 //  Summary:  PS_DS18B20_Temperature is a class which implements both the SmartThings "Temperature Measurement" capability.
-//			  It inherits from the st::PollingSensor class.  The current version uses a digital pin to measure the 
+//			  It inherits from the st::PollingSensorExtended class.  The current version uses a digital pin to measure the 
 //			  temperature from a Dallas Semiconductor One Wire DS18B20 series sensor. 
 //
+//			  Each poll is done in two steps, so the loop is never held up for the conversion:  preGetData() starts
+//			  a conversion on every sensor at once, and getData() reads the results one conversion time later.  The
+//			  sensors' ROM addresses are found once by init() and each is then read by address, without a bus search.
+//
 //			  Create an instance of this class in your sketch's global variable section
 //			  For Example:  st::PS_DS18B20_Temperature sensor1(F("temperature1"), 120, 0, PIN_TEMPERATURE, false); (for a single sensor)
 //                          st::PS_DS18B20_Temperature sensor1(F("temperature"), 120, 0, PIN_TEMPERATURE, false, 10, 3); (for 3 sensors)
@@ -36,6 +40,8 @@
 //    2017-08-18  Dan Ogorchock  Modified to send floating point values to SmartThings
 //    2018-08-30  Dan Ogorchock  Modified comment section above to comply with new Parent/Child Device Handler requirements
 //    2019-03-11  Dan Ogorchock  Added new optional parameter for starting sensor number for data transfer
+//    2026-10-16  a00889920      Non-blocking conversions on PollingSensorExtended, ROM addresses cached by init()
+//    2026-10-16  a00889920      Readings are sent through the reporting policy (deadband / minreport / heartbeat), per sensor
 //
 //
 //******************************************************************************************
@@ -43,14 +49,14 @@
 #define ST_PS_DS18B20_TEMPERATURE_H
 
 
-#include "PollingSensor.h"
+#include "PollingSensorExtended.h"
 #include <Wire.h>
 #include <OneWire.h>
 #include <DallasTemperature.h>
 
 namespace st
 {
-	class PS_DS18B20_Temperature : public PollingSensor
+	class PS_DS18B20_Temperature : public PollingSensorExtended
 	{
 		private:
 			float m_dblTemperatureSensorValue;		//current Temperature value
@@ -60,6 +66,14 @@ namespace st
 			bool m_In_C;							//Return temp in C
 			byte m_numSensors;						//number of DS18B20 sensors to report values for
 			byte m_sensorStartingNum;				//starting number of the sensor for data transfer to avoid conflicts with other devices on other pins
+			DeviceAddress *m_Addresses;				//ROM address of each sensor, in bus search order (m_numSensors entries)
+			float *m_Values;						//last value read from each sensor - sent by refresh()
+			ReportPolicy::Channel *m_Reports;		//last value sent for each sensor, for the reporting policy
+			byte m_nFound;							//sensors whose address is known
+			bool m_bRescan;							//a sensor is missing or could not be read - search the bus before the next conversion
+
+			void findSensors();						//searches the bus for the sensors' ROM addresses
+			void sendValue(byte index);				//sends m_Values[index] to ST
 
 		public:
 
@@ -75,6 +89,12 @@ namespace st
 			//initialization routine
 			virtual void init();
 
+			//called periodically by Everything class to ensure ST Cloud is kept consistent - sends the last values read
+			virtual void refresh();
+
+			//starts a temperature conversion on all sensors - returns at once
+			virtual void preGetData();
+
 			//function to get data from sensor and queue results for transfer to ST Cloud
 			virtual void getData();
 
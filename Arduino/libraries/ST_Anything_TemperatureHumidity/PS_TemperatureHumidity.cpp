@@ -7,6 +7,11 @@
 //			  It inherits from the st::PollingSensor class.  The current version uses a digital input to measure the 
 //			  temperature and humidity from a DHT series sensor.  This was tested with both the DHT11 and DHT22.  
 //
+//			  If the pin supports attachInterrupt(), a reading does not block:  getData() pulls the line low to wake the
+//			  sensor, update() releases it a few ms later, an interrupt handler timestamps each falling edge of the reply,
+//			  and update() decodes the 40 bits from those timestamps once the reply is over.  Other pins fall back to the
+//			  blocking dht library read.
+//
 //			  Create an instance of this class in your sketch's global variable section
 //			  For Example:  st::PS_TemperatureHumidity sensor2(F("temphumid1"), 120, 7, PIN_TEMPERATUREHUMIDITY, st::PS_TemperatureHumidity::DHT22, "temperature1", "humidity1", false);
 //
@@ -43,6 +48,8 @@
 //    2015-03-29  Dan Ogorchock	 Optimized use of the DHT library (made it static) to reduce SRAM memory usage at runtime.
 //    2017-06-27  Dan Ogorchock  Added optional Celsius reading argument
 //    2017-08-17  Dan Ogorchock  Added optional filter constant argument and to transmit floating point values to SmartThings
+//    2026-10-16  a00889920      Non-blocking reads decoded from interrupt edge timestamps, no delay() in init()
+//    2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
 //
 //******************************************************************************************
 
@@ -54,8 +61,120 @@
 
 namespace st
 {
+	static const unsigned long DHT_POWERUP_MS = 1500;	//the sensor gives an "Unknown Error" if it is read sooner after power up
+	static const unsigned long DHT11_WAKE_MS = 20;		//the line is held low at least 18 ms to wake a DHT11...
+	static const unsigned long DHT_WAKE_MS = 2;			//...and at least 1 ms for the others
+	static const unsigned long DHT_REPLY_MS = 7;		//the whole reply takes at most about 5.5 ms
+
+	//The reply is 80us low and 80us high, then 40 bits of 50us low followed by 26-28us high for a 0 or 70us high for a 1,
+	//so the time from one falling edge to the next is about 78us for a 0 and 120us for a 1.
+	static const byte DHT_BITS = 40;
+	static const byte DHT_EDGES = DHT_BITS + 2;			//the start of the reply, one per bit, and the end
+	static const byte DHT_PERIOD_MIN = 50;
+	static const byte DHT_PERIOD_ONE = 100;				//longer than this is a 1
+	static const byte DHT_PERIOD_MAX = 170;
+
+	//Falling edges of the reply being captured, recorded by the interrupt handler as the time from each edge to the
+	//next (255 if longer).  One reading is captured at a time - s_pDhtOwner is the sensor it belongs to.
+	static volatile byte s_DhtPeriods[DHT_EDGES - 1];
+	static volatile byte s_nDhtEdges = 0;
+	static volatile unsigned long s_lDhtLastEdge = 0;
+	static PS_TemperatureHumidity *s_pDhtOwner = 0;
+
+	static void ST_ISR_ATTR isrDhtEdge()
+	{
+		unsigned long now = micros();
+		byte n = s_nDhtEdges;
+
+		if (n > DHT_EDGES)
+		{
+			return;				//already more edges than a reply has - decodeReply() rejects it
+		}
+		if ((n > 0) && (n <= DHT_EDGES - 1))
+		{
+			unsigned long period = now - s_lDhtLastEdge;
+			s_DhtPeriods[n - 1] = (period > 255) ? 255 : period;
+		}
+		s_lDhtLastEdge = now;
+		s_nDhtEdges = n + 1;
+	}
+
 //private
-	
+	void PS_TemperatureHumidity::nextStep(byte state, unsigned long ms)
+	{
+		m_nReadState = state;
+		m_lStepDue = millis() + ms;
+		scheduleUpdate(m_lStepDue);
+	}
+
+	void PS_TemperatureHumidity::startRead()
+	{
+		if (s_pDhtOwner && (s_pDhtOwner != this))
+		{
+			nextStep(READ_WAITING, DHT_REPLY_MS);	//another DHT is being read - try again when it is done
+			return;
+		}
+		s_pDhtOwner = this;
+
+		pinMode(m_nDigitalInputPin, OUTPUT);
+		digitalWrite(m_nDigitalInputPin, LOW);
+		nextStep(READ_WAKE, (m_bDHTSensorType == DHT11) ? DHT11_WAKE_MS : DHT_WAKE_MS);
+	}
+
+	void PS_TemperatureHumidity::captureReply()
+	{
+		s_nDhtEdges = 0;
+		pinMode(m_nDigitalInputPin, INPUT);		//the pull-up takes the line high, and the sensor replies 20-40us later
+		attachInterrupt(digitalPinToInterrupt(m_nDigitalInputPin), isrDhtEdge, FALLING);
+		nextStep(READ_CAPTURE, DHT_REPLY_MS);
+	}
+
+	int8_t PS_TemperatureHumidity::decodeReply(float &humidity, float &temperature)
+	{
+		byte edges = s_nDhtEdges;
+		if ((edges < DHT_BITS + 1) || (edges > DHT_EDGES))
+		{
+			return DHTLIB_ERROR_TIMEOUT;		//edges were missed (or noise added some)
+		}
+
+		//the bits are the last 40 periods - the edge at the start of the reply is missed if attachInterrupt() was slow
+		byte first = edges - 1 - DHT_BITS;
+		byte bits[5] = { 0, 0, 0, 0, 0 };
+		for (byte i = 0; i < DHT_BITS; i++)
+		{
+			byte period = s_DhtPeriods[first + i];
+			if ((period < DHT_PERIOD_MIN) || (period > DHT_PERIOD_MAX))
+			{
+				return DHTLIB_ERROR_TIMEOUT;
+			}
+			if (period > DHT_PERIOD_ONE)
+			{
+				bits[i / 8] |= 0x80 >> (i % 8);
+			}
+		}
+
+		if (bits[4] != (byte)(bits[0] + bits[1] + bits[2] + bits[3]))
+		{
+			return DHTLIB_ERROR_CHECKSUM;
+		}
+
+		//the same conversions as the dht library
+		if (m_bDHTSensorType == DHT11)
+		{
+			humidity = bits[0];
+			temperature = bits[2];
+		}
+		else
+		{
+			humidity = word(bits[0], bits[1]) * 0.1;
+			temperature = word(bits[2] & 0x7F, bits[3]) * 0.1;
+			if (bits[2] & 0x80)
+			{
+				temperature = -temperature;
+			}
+		}
+		return DHTLIB_OK;
+	}
 
 //public
 	//constructor - called in your sketch's global variable declaration section
@@ -66,7 +185,12 @@ namespace st
 		m_bDHTSensorType(DHTSensorType),
 		m_strTemperature(strTemp),
 		m_strHumidity(strHumid),
-		m_In_C(In_C)
+		m_In_C(In_C),
+		m_nReadState(READ_IDLE),
+		m_lStepDue(0),
+		m_bUseIsr(false),
+		m_nReadErrors(0),
+		m_bRefreshPending(false)
 	{
 		setPin(digitalInputPin);
 
@@ -95,6 +219,11 @@ namespace st
 	//SmartThings Shield data handler (receives configuration data from ST - polling interval, and adjusts on the fly)
 	void PS_TemperatureHumidity::beSmart(const String &str)
 	{
+		if (beSmartReportPolicy(str))
+		{
+			return;	//deadband, minreport or heartbeat command
+		}
+
 		String s = str.substring(str.indexOf(' ') + 1);
 
 		if (s.toInt() != 0) {
@@ -117,13 +246,81 @@ namespace st
 	//initialization routine - get first set of readings and send to ST cloud
 	void PS_TemperatureHumidity::init()
 	{
-		delay(1500);		//Needed to prevent "Unknown Error" on first read of DHT Sensor
-		getData();
+		m_bUseIsr = true;
+#if defined(NOT_AN_INTERRUPT)
+		if (digitalPinToInterrupt(m_nDigitalInputPin) == NOT_AN_INTERRUPT)
+		{
+			m_bUseIsr = false;
+		}
+#endif
+
+		if (m_bUseIsr)
+		{
+			nextStep(READ_WAITING, DHT_POWERUP_MS);	//the first reading is sent once the sensor has settled
+		}
+		else
+		{
+			delay(DHT_POWERUP_MS);		//Needed to prevent "Unknown Error" on first read of DHT Sensor
+			getData();
+		}
+	}
+
+	//runs the next step of a reading when it is due, and otherwise polls as usual
+	void PS_TemperatureHumidity::update()
+	{
+		if (m_nReadState != READ_IDLE)
+		{
+			if ((long)(millis() - m_lStepDue) < 0)
+			{
+				scheduleUpdate(m_lStepDue);
+				return;
+			}
+
+			switch (m_nReadState)
+			{
+			case READ_WAITING:
+				startRead();
+				return;
+			case READ_WAKE:
+				captureReply();
+				return;
+			default:
+				{
+					detachInterrupt(digitalPinToInterrupt(m_nDigitalInputPin));
+					s_pDhtOwner = 0;
+					m_nReadState = READ_IDLE;
+
+					float humidity = 0.0;
+					float temperature = 0.0;
+					int8_t chk = decodeReply(humidity, temperature);
+					processReading(chk, humidity, temperature);
+				}
+				break;
+			}
+		}
+
+		PollingSensor::update();	//reschedules the next poll (or starts it, if it is already due)
+	}
+
+	//with interrupt reads the values arrive after refresh() has returned, so the reading it starts is flagged to be sent
+	void PS_TemperatureHumidity::refresh()
+	{
+		m_bRefreshPending = true;
+		PollingSensor::refresh();
 	}
 	
 	//function to get data from sensor and queue results for transfer to ST Cloud 
 	void PS_TemperatureHumidity::getData()
 	{
+		if (m_bUseIsr)
+		{
+			if (m_nReadState == READ_IDLE)
+			{
+				startRead();	//update() sends the values once the reply has been decoded
+			}
+			return;
+		}
+
 		// READ DATA
 		int8_t chk = 0;
 		switch (m_bDHTSensorType) {
@@ -151,6 +348,16 @@ namespace st
 				Serial.println(F("PS_TemperatureHumidity: Invalid DHT Sensor Type"));
 			}
 
+		processReading(chk, DHT.humidity, DHT.temperature);
+	}
+
+	//filters a reading and queues the results for transfer to ST Cloud - on an error the last values are sent again
+	void PS_TemperatureHumidity::processReading(int8_t chk, float humidity, float temperature)
+	{
+		if (chk != DHTLIB_OK)
+		{
+			m_nReadErrors++;
+		}
 
 		switch (chk)
 		{
@@ -160,11 +367,11 @@ namespace st
 			if (m_fHumiditySensorValue == -1.0)
 			{
 				Serial.println("First time through Humidity");
-				m_fHumiditySensorValue = DHT.humidity;  //first time through, no filtering
+				m_fHumiditySensorValue = humidity;  //first time through, no filtering
 			}
 			else
 			{
-				m_fHumiditySensorValue = (m_fFilterConstant * DHT.humidity) + (1 - m_fFilterConstant) * m_fHumiditySensorValue;
+				m_fHumiditySensorValue = (m_fFilterConstant * humidity) + (1 - m_fFilterConstant) * m_fHumiditySensorValue;
 			}
 
 			//Temperature
@@ -174,22 +381,22 @@ namespace st
 				//first time through, no filtering
 				if (m_In_C == false)
 				{
-					m_fTemperatureSensorValue = (DHT.temperature * 1.8) + 32.0;		//Scale from Celsius to Farenheit
+					m_fTemperatureSensorValue = (temperature * 1.8) + 32.0;		//Scale from Celsius to Farenheit
 				}
 				else
 				{
-					m_fTemperatureSensorValue = DHT.temperature;
+					m_fTemperatureSensorValue = temperature;
 				}
 			}
 			else
 			{
 				if (m_In_C == false)
 				{
-					m_fTemperatureSensorValue = (m_fFilterConstant * ((DHT.temperature * 1.8) + 32.0)) + (1 - m_fFilterConstant) * m_fTemperatureSensorValue;
+					m_fTemperatureSensorValue = (m_fFilterConstant * ((temperature * 1.8) + 32.0)) + (1 - m_fFilterConstant) * m_fTemperatureSensorValue;
 				}
 				else
 				{
-					m_fTemperatureSensorValue = (m_fFilterConstant * DHT.temperature) + (1 - m_fFilterConstant) * m_fTemperatureSensorValue;
+					m_fTemperatureSensorValue = (m_fFilterConstant * temperature) + (1 - m_fFilterConstant) * m_fTemperatureSensorValue;
 				}
 				
 			}
@@ -235,8 +442,16 @@ namespace st
 		//Serial.print(m_nTemperatureSensorValue, 1);
 		//Serial.println();
 
-		Everything::sendSmartString(m_strTemperature + " " + String(m_fTemperatureSensorValue));
-		Everything::sendSmartString(m_strHumidity + " " + String(m_fHumiditySensorValue));
+		bool force = m_bRefreshPending;
+		m_bRefreshPending = false;
+		if (shouldReport(m_fTemperatureSensorValue, force))
+		{
+			Everything::sendSmartString(m_strTemperature + " " + String(m_fTemperatureSensorValue));
+		}
+		if (shouldReport(m_fHumiditySensorValue, m_HumidityReport, force))
+		{
+			Everything::sendSmartString(m_strHumidity + " " + String(m_fHumiditySensorValue));
+		}
 	}
 	
 	void PS_TemperatureHumidity::setPin(byte pin)
@@ -7,6 +7,11 @@
 //			  It inherits from the st::PollingSensor class.  The current version uses a digital input to measure the 
 //			  temperature and humidity from a DHT series sensor.  This was tested with both the DHT11 and DHT22.  
 //
+//			  If the pin supports attachInterrupt(), a reading does not block:  getData() pulls the line low to wake the
+//			  sensor, update() releases it a few ms later, an interrupt handler timestamps each falling edge of the reply,
+//			  and update() decodes the 40 bits from those timestamps once the reply is over.  Other pins fall back to the
+//			  blocking dht library read.
+//
 //			  Create an instance of this class in your sketch's global variable section
 //			  For Example:  st::PS_TemperatureHumidity sensor2(F("temphumid1"), 120, 7, PIN_TEMPERATUREHUMIDITY, st::PS_TemperatureHumidity::DHT22, "temperature1", "humidity1", false);
 //
@@ -43,6 +48,8 @@
 //    2015-03-29  Dan Ogorchock	 Optimized use of the DHT library (made it static) to reduce SRAM memory usage at runtime.
 //    2017-06-27  Dan Ogorchock  Added optional Celsius reading argument
 //    2017-08-17  Dan Ogorchock  Added optional filter constant argument and to transmit floating point values to SmartThings
+//    2026-10-16  a00889920      Non-blocking reads decoded from interrupt edge timestamps, no delay() in init()
+//    2026-10-16  a00889920      Readings are sent through the PollingSensor reporting policy (deadband / minreport / heartbeat)
 //
 //******************************************************************************************
 
@@ -66,6 +73,23 @@ namespace st
 			String m_strHumidity;			//name of temparature sensor to use when transferring data to ST Cloud		
 			bool m_In_C;					//Return temp in C
 			float m_fFilterConstant;        //Filter constant % as floating point from 0.00 to 1.00
+			byte m_nReadState;				//READ_IDLE, or the step of the reading in progress
+			unsigned long m_lStepDue;		//millis() at which the next step of the reading is due
+			bool m_bUseIsr;					//the pin supports attachInterrupt() - otherwise the dht library reads it
+			unsigned int m_nReadErrors;		//readings that failed (timeout or checksum)
+			ReportPolicy::Channel m_HumidityReport;	//last humidity sent - the temperature uses the PollingSensor's own channel
+			bool m_bRefreshPending;			//refresh() started the reading in progress - its values are always sent
+
+			static const byte READ_IDLE = 0;
+			static const byte READ_WAITING = 1;		//waiting for the sensor to settle after power up, or for another DHT's reading to finish
+			static const byte READ_WAKE = 2;		//the line is held low to wake the sensor
+			static const byte READ_CAPTURE = 3;		//the sensor is replying - the interrupt handler records the edges
+
+			void nextStep(byte state, unsigned long ms);	//moves the reading on to state in ms milliseconds
+			void startRead();				//wakes the sensor - the rest of the reading is driven by update()
+			void captureReply();			//releases the line and starts recording edges
+			int8_t decodeReply(float &humidity, float &temperature);	//decodes the recorded edges - returns a DHTLIB_ code
+			void processReading(int8_t chk, float humidity, float temperature);	//filters and sends a reading
 
 		public:
 			//types of DHT sensors supported by the dht library
@@ -83,13 +107,20 @@ namespace st
 			//initialization routine
 			virtual void init();
 
-			//function to get data from sensor and queue results for transfer to ST Cloud 
+			//called by Everything when a poll or the next step of a reading is due
+			virtual void update();
+
+			//called periodically by Everything class to ensure ST Cloud is kept consistent - the next reading is always sent
+			virtual void refresh();
+
+			//function to get data from sensor and queue results for transfer to ST Cloud - the values are sent once the reading is complete
 			virtual void getData();
 			
 			//gets
 			inline byte getPin() const { return m_nDigitalInputPin; }
 			inline float getTemperatureSensorValue() const { return m_fTemperatureSensorValue; }
 			inline float getHumiditySensorValue() const { return m_fHumiditySensorValue; }
+			inline unsigned int getReadErrors() const { return m_nReadErrors; }
 				
 			//sets
 			void setPin(byte pin);
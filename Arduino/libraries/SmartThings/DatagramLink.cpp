@@ -0,0 +1,250 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - Datagram Link
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  a00889920      Created as a lower overhead alternative to an HTTP POST per transmission
+//*******************************************************************************
+#include "DatagramLink.h"
+
+namespace st
+{
+	//true if sequence number a is at or before b, allowing for wrap around
+	static bool seqAtOrBefore(uint16_t a, uint16_t b)
+	{
+		return (uint16_t)(b - a) < 0x8000;
+	}
+
+//private
+	void DatagramLink::transmit(Slot &s, const char *payload, unsigned int length)
+	{
+		m_pUdp->beginPacket(m_HubIP, m_nHubPort);
+		m_pUdp->print('#');
+		m_pUdp->print(m_nSession);
+		m_pUdp->print(':');
+		m_pUdp->print(s.seq);
+		m_pUdp->print('\n');
+		m_pUdp->write((const uint8_t *)payload, length);
+		m_pUdp->endPacket();
+
+		s.sentMillis = millis();
+		++s.tries;
+	}
+
+	bool DatagramLink::parseNumber(char *&p, uint16_t &value)
+	{
+		if ((*p < '0') || (*p > '9'))
+		{
+			return false;
+		}
+		value = 0;
+		while ((*p >= '0') && (*p <= '9'))
+		{
+			value = value * 10 + (*p++ - '0');
+		}
+		return true;
+	}
+
+	void DatagramLink::handleAck(char *ack)
+	{
+		char *p = ack;
+		uint16_t session;
+		uint16_t cumulative;
+
+		if ((strncmp(p, "ack ", 4) != 0))
+		{
+			return;
+		}
+		p += 4;
+		if (!parseNumber(p, session) || (session != m_nSession) || (*p++ != ' ') || !parseNumber(p, cumulative))
+		{
+			return;		//not for this run of the board
+		}
+
+		for (byte i = 0; i < m_nCount; ++i)
+		{
+			if (seqAtOrBefore(slot(i).seq, cumulative))
+			{
+				slot(i).acked = true;
+			}
+		}
+
+		//selective acknowledgements - "first-last" ranges beyond the cumulative one
+		while (*p == ' ')
+		{
+			uint16_t first;
+			uint16_t last;
+
+			++p;
+			if (!parseNumber(p, first) || (*p++ != '-') || !parseNumber(p, last))
+			{
+				return;
+			}
+			for (byte i = 0; i < m_nCount; ++i)
+			{
+				if (seqAtOrBefore(first, slot(i).seq) && seqAtOrBefore(slot(i).seq, last))
+				{
+					slot(i).acked = true;
+				}
+			}
+		}
+	}
+
+	void DatagramLink::report(SmartThingsSendCallout_t *callout, const char *payload, unsigned int length, SmartThingsSendResult_t result)
+	{
+		if (!callout)
+		{
+			return;
+		}
+
+		//one report per message, as if each had been sent on its own
+		unsigned int start = 0;
+		for (unsigned int i = 0; i <= length; ++i)
+		{
+			if ((i == length) || (payload[i] == '\n'))
+			{
+				callout(payload + start, i - start, result);
+				start = i + 1;
+			}
+		}
+	}
+
+	void DatagramLink::retire(SmartThingsSendCallout_t *callout, bool force, SmartThingsSendResult_t result)
+	{
+		const char *payload;
+		unsigned int length;
+
+		if (!m_nCount || !m_Window.front(payload, length))
+		{
+			return;
+		}
+
+		if (force)
+		{
+			++m_lGivenUp;
+		}
+		report(callout, payload, length, force ? result : STSEND_OK);
+
+		m_Window.pop();
+		m_nFirst = (m_nFirst + 1) % WINDOW_SIZE;
+		--m_nCount;
+	}
+
+//public
+	//*******************************************************************************
+	// DatagramLink Constructor
+	//*******************************************************************************
+	DatagramLink::DatagramLink(UDP &udp, byte *buffer, unsigned int size) :
+		m_pUdp(&udp),
+		m_Window(buffer, size),
+		m_nFirst(0),
+		m_nCount(0),
+		m_nSession(0),
+		m_nNextSeq(1),
+		m_nHubPort(0),
+		m_bStarted(false),
+		m_lResent(0),
+		m_lGivenUp(0)
+	{
+	}
+
+	void DatagramLink::begin(IPAddress hubIP, uint16_t hubPort, uint16_t localPort)
+	{
+		m_HubIP = hubIP;
+		m_nHubPort = hubPort;
+
+		if (!m_bStarted)
+		{
+			//network start up time varies by some microseconds from one boot to the next
+			m_nSession = (uint16_t)(micros() ^ random(0x7FFF)) | 1;
+			m_bStarted = true;
+		}
+		m_pUdp->stop();
+		m_pUdp->begin(localPort);
+	}
+
+	void DatagramLink::send(const char * const *messages, const unsigned int *lengths, byte count, SmartThingsSendCallout_t *callout)
+	{
+		if (!count)
+		{
+			return;
+		}
+
+		//make room - the oldest datagrams are given up first
+		while ((m_nCount == WINDOW_SIZE) || ((m_nCount > 0) && !m_Window.push(messages, lengths, count, '\n')))
+		{
+			retire(callout, !slot(0).acked, STSEND_OVERFLOW);
+		}
+		if ((m_nCount == 0) && !m_Window.push(messages, lengths, count, '\n'))
+		{
+			for (byte i = 0; i < count; ++i)
+			{
+				report(callout, messages[i], lengths[i], STSEND_OVERFLOW);	//larger than the whole buffer
+			}
+			return;
+		}
+
+		Slot &s = slot(m_nCount);
+		s.seq = m_nNextSeq++;
+		s.tries = 0;
+		s.acked = false;
+		++m_nCount;
+
+		const char *payloads[WINDOW_SIZE];
+		unsigned int payloadLengths[WINDOW_SIZE];
+		m_Window.frontBatch(payloads, payloadLengths, WINDOW_SIZE, 0xFFFF);
+		transmit(s, payloads[m_nCount - 1], payloadLengths[m_nCount - 1]);
+	}
+
+	void DatagramLink::run(SmartThingsSendCallout_t *callout)
+	{
+		if (!m_bStarted)
+		{
+			return;
+		}
+
+		//read every acknowledgement that has arrived - never waits
+		int size;
+		while ((size = m_pUdp->parsePacket()) > 0)
+		{
+			char ack[MAX_ACK_LENGTH + 1];
+			int length = m_pUdp->read(ack, MAX_ACK_LENGTH);
+			ack[length > 0 ? length : 0] = 0;	//anything past MAX_ACK_LENGTH is discarded by the next parsePacket()
+			handleAck(ack);
+		}
+
+		while (m_nCount && slot(0).acked)
+		{
+			retire(callout, false, STSEND_OK);
+		}
+		if (!m_nCount)
+		{
+			return;
+		}
+
+		//resend what is overdue, oldest first
+		const char *payloads[WINDOW_SIZE];
+		unsigned int lengths[WINDOW_SIZE];
+		m_Window.frontBatch(payloads, lengths, WINDOW_SIZE, 0xFFFF);
+
+		for (byte i = 0; i < m_nCount; ++i)
+		{
+			Slot &s = slot(i);
+			if (!s.acked && (millis() - s.sentMillis >= ((unsigned long)RETRY_TIMEOUT << (s.tries - 1))))
+			{
+				if (s.tries < MAX_TRIES)
+				{
+					++m_lResent;
+					transmit(s, payloads[i], lengths[i]);
+				}
+				else if (i == 0)
+				{
+					retire(callout, true, STSEND_TIMEOUT);
+					return;		//the views in payloads have moved along - carry on next run()
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,112 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - Datagram Link
+//
+//	Summary:  st::DatagramLink sends messages to the hub as UDP datagrams instead
+//			  of one HTTP POST per transmission.  Each datagram carries a session
+//			  number, a sequence number and one or more messages:
+//
+//				#<session>:<seq>\n<message>\n<message>...
+//
+//			  The hub answers every datagram with an acknowledgement naming all it
+//			  has received - everything up to a cumulative sequence number, plus
+//			  any ranges received beyond it:
+//
+//				ack <session> <cumulative> <first>-<last> <first>-<last>...
+//
+//			  Sent datagrams are kept in a caller supplied buffer until they are
+//			  acknowledged.  Only the ones not acknowledged are sent again, with
+//			  the wait doubling each time.  A datagram that is never acknowledged
+//			  is given up after MAX_TRIES.  When the buffer or the window of
+//			  WINDOW_SIZE datagrams is full, the oldest is dropped to make room.
+//
+//			  The session number changes each time the board starts, so the hub
+//			  knows to forget the sequence numbers of the previous run.
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  a00889920      Created as a lower overhead alternative to an HTTP POST per transmission
+//*******************************************************************************
+#ifndef __DATAGRAMLINK_H__
+#define __DATAGRAMLINK_H__
+
+#include "SmartThings.h"
+#include "MessageQueue.h"
+#include <IPAddress.h>
+#include <Udp.h>
+
+namespace st
+{
+	class DatagramLink
+	{
+	public:
+		static const byte WINDOW_SIZE = 8;				//most datagrams awaiting acknowledgement
+		static const unsigned int RETRY_TIMEOUT = 300;	//ms before the first resend - doubles on each resend
+		static const byte MAX_TRIES = 5;				//sends of one datagram before it is given up
+		static const byte MAX_ACK_LENGTH = 80;			//longest acknowledgement read from the hub
+
+	private:
+		struct Slot
+		{
+			uint16_t seq;
+			unsigned long sentMillis;
+			byte tries;
+			bool acked;
+		};
+
+		UDP *m_pUdp;
+		MessageQueue m_Window;			//payloads of the datagrams in m_Slots, oldest first
+		Slot m_Slots[WINDOW_SIZE];		//ring, m_nFirst is the oldest
+		byte m_nFirst;
+		byte m_nCount;
+		uint16_t m_nSession;
+		uint16_t m_nNextSeq;
+		IPAddress m_HubIP;
+		uint16_t m_nHubPort;
+		bool m_bStarted;
+		unsigned long m_lResent;		//datagrams sent again
+		unsigned long m_lGivenUp;		//datagrams dropped unacknowledged
+
+		Slot &slot(byte n) { return m_Slots[(m_nFirst + n) % WINDOW_SIZE]; }
+		void transmit(Slot &s, const char *payload, unsigned int length);
+		void handleAck(char *ack);
+		void retire(SmartThingsSendCallout_t *callout, bool force, SmartThingsSendResult_t result);	//removes the oldest datagram
+		static void report(SmartThingsSendCallout_t *callout, const char *payload, unsigned int length, SmartThingsSendResult_t result);
+		static bool parseNumber(char *&p, uint16_t &value);
+
+	public:
+		//*******************************************************************************
+		/// @brief  DatagramLink Constructor
+		///   @param[in] udp - UDP socket of the board's network library (e.g. WiFiUDP, EthernetUDP)
+		///   @param[in] buffer - storage for the datagrams awaiting acknowledgement (must outlive the link)
+		///   @param[in] size - size of buffer in bytes
+		//*******************************************************************************
+		DatagramLink(UDP &udp, byte *buffer, unsigned int size);
+
+		//*******************************************************************************
+		/// Opens the UDP socket - called by the transport once the network is up
+		///   @param[in] hubIP, hubPort - where datagrams are sent
+		///   @param[in] localPort - port the hub's acknowledgements are sent to
+		//*******************************************************************************
+		void begin(IPAddress hubIP, uint16_t hubPort, uint16_t localPort);
+
+		//*******************************************************************************
+		/// Sends the messages as one datagram.  The messages are copied.
+		//*******************************************************************************
+		void send(const char * const *messages, const unsigned int *lengths, byte count, SmartThingsSendCallout_t *callout);
+
+		//*******************************************************************************
+		/// Reads acknowledgements and resends datagrams that are overdue - call from run().
+		/// Every message is reported to callout as STSEND_OK once acknowledged, or as
+		/// STSEND_TIMEOUT / STSEND_OVERFLOW if it was given up.
+		//*******************************************************************************
+		void run(SmartThingsSendCallout_t *callout);
+
+		bool isStarted() const { return m_bStarted; }
+		byte inFlight() const { return m_nCount; }
+		unsigned long getResentCount() const { return m_lResent; }
+		unsigned long getGivenUpCount() const { return m_lGivenUp; }
+	};
+}
+#endif
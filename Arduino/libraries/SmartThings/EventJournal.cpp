@@ -0,0 +1,79 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - Event Journal
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  a00889920      Created to keep events that could not be sent during a network outage
+//	2026-10-16  a00889920      append() stamps the message with the millis() it is given
+//*******************************************************************************
+#include "EventJournal.h"
+
+namespace st
+{
+	//*******************************************************************************
+	// RamJournal Constructor
+	//*******************************************************************************
+	RamJournal::RamJournal(byte *buffer, unsigned int size) :
+		m_Queue(buffer, size)
+	{
+	}
+
+	bool RamJournal::append(const char *message, unsigned int length, unsigned long capturedMillis)
+	{
+		if (length > MAX_MESSAGE_LENGTH)
+		{
+			++m_lDropped;
+			return false;
+		}
+
+		byte record[4 + MAX_MESSAGE_LENGTH];
+		uint32_t captured = capturedMillis;
+		memcpy(record, &captured, 4);
+		memcpy(record + 4, message, length);
+
+		//make room - the oldest messages are dropped first
+		while (!m_Queue.push((const char *)record, 4 + length))
+		{
+			if (m_Queue.isEmpty())
+			{
+				++m_lDropped;
+				return false;
+			}
+			m_Queue.pop();
+			++m_lDropped;
+		}
+
+		++m_lAppended;
+		m_lBytesWritten += MessageQueue::HEADER_SIZE + 4 + length;
+		return true;
+	}
+
+	bool RamJournal::front(const char *&message, unsigned int &length, unsigned long &capturedMillis, bool &thisBoot)
+	{
+		const char *record;
+		unsigned int recordLength;
+		if (!m_Queue.front(record, recordLength))
+		{
+			return false;
+		}
+
+		uint32_t captured;
+		memcpy(&captured, record, 4);
+		capturedMillis = captured;
+		message = record + 4;
+		length = recordLength - 4;
+		thisBoot = true;
+		return true;
+	}
+
+	void RamJournal::pop()
+	{
+		if (!m_Queue.isEmpty())
+		{
+			m_Queue.pop();
+			++m_lRemoved;
+		}
+	}
+}
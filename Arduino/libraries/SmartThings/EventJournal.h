@@ -0,0 +1,94 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - Event Journal
+//
+//	Summary:  st::EventJournal holds messages a transport could not deliver, so
+//			  they can be sent later, oldest first, once the hub can be reached
+//			  (see SmartThingsEthernet::setJournal).  Each message is stamped with
+//			  the millis() it was captured at.
+//
+//			  st::RamJournal keeps the messages in a caller supplied RAM buffer -
+//			  suits AVR boards, but is lost on a reset.  When full, the oldest
+//			  message is dropped to make room.
+//
+//			  st::FlashJournal (FlashJournal.h, ESP8266/ESP32 only) keeps them in
+//			  LittleFS or SPIFFS, so they also survive a reset or deep sleep.
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  a00889920      Created to keep events that could not be sent during a network outage
+//	2026-10-16  a00889920      append() can be given the millis() the message was captured at
+//*******************************************************************************
+#ifndef __EVENTJOURNAL_H__
+#define __EVENTJOURNAL_H__
+
+#include <Arduino.h>
+#include "MessageQueue.h"
+
+namespace st
+{
+	class EventJournal
+	{
+	protected:
+		unsigned long m_lAppended;		//messages added
+		unsigned long m_lRemoved;		//messages taken out with pop()
+		unsigned long m_lDropped;		//messages lost because the journal was full
+		unsigned long m_lBytesWritten;	//bytes written to the journal's storage, including its own overhead
+
+	public:
+		//longest message kept - longer ones are dropped
+		static const unsigned int MAX_MESSAGE_LENGTH = 120;
+
+		EventJournal() : m_lAppended(0), m_lRemoved(0), m_lDropped(0), m_lBytesWritten(0) {}
+		virtual ~EventJournal() {}
+
+		//*******************************************************************************
+		/// Adds a message to the end of the journal, stamped with capturedMillis (a
+		/// message that failed earlier keeps the time of its first attempt), or with
+		/// millis() now.  Returns false if it was dropped.
+		//*******************************************************************************
+		virtual bool append(const char *message, unsigned int length, unsigned long capturedMillis) = 0;
+		bool append(const char *message, unsigned int length) { return append(message, length, millis()); }
+
+		//*******************************************************************************
+		/// Returns a view of the oldest message, the millis() it was captured at, and
+		/// whether that was since this board last started (capturedMillis is meaningless
+		/// otherwise).  The view remains valid until pop() or append() is called.
+		//*******************************************************************************
+		virtual bool front(const char *&message, unsigned int &length, unsigned long &capturedMillis, bool &thisBoot) = 0;
+
+		//*******************************************************************************
+		/// Removes the oldest message
+		//*******************************************************************************
+		virtual void pop() = 0;
+
+		virtual bool isEmpty() = 0;
+
+		unsigned long getAppendedCount() const { return m_lAppended; }
+		unsigned long getRemovedCount() const { return m_lRemoved; }
+		unsigned long getDroppedCount() const { return m_lDropped; }
+		unsigned long getBytesWritten() const { return m_lBytesWritten; }
+	};
+
+	class RamJournal: public EventJournal
+	{
+	private:
+		MessageQueue m_Queue;	//each record is [captured millis (4 bytes)][message]
+
+	public:
+		//*******************************************************************************
+		/// @brief  RamJournal Constructor
+		///   @param[in] buffer - storage for the messages (must outlive the journal)
+		///   @param[in] size - size of buffer in bytes
+		//*******************************************************************************
+		RamJournal(byte *buffer, unsigned int size);
+
+		using EventJournal::append;
+		virtual bool append(const char *message, unsigned int length, unsigned long capturedMillis);
+		virtual bool front(const char *&message, unsigned int &length, unsigned long &capturedMillis, bool &thisBoot);
+		virtual void pop();
+		virtual bool isEmpty() { return m_Queue.isEmpty(); }
+	};
+}
+#endif
@@ -0,0 +1,506 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - Flash Journal (ESP8266 and ESP32 only)
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  a00889920      Created to keep events across a reset during a network outage
+//	2026-10-16  a00889920      append() stamps the message with the millis() it is given
+//*******************************************************************************
+#include "FlashJournal.h"
+
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+
+namespace st
+{
+	static const byte SEGMENT_SIGNATURE[4] = { 'S', 'T', 'J', 1 };
+
+//private
+	void FlashJournal::segmentPath(char *path, byte index) const
+	{
+		snprintf(path, 32, "%s%d", m_pName, index);
+	}
+
+	void FlashJournal::cursorPath(char *path) const
+	{
+		snprintf(path, 32, "%sc", m_pName);
+	}
+
+	//CRC-16/CCITT
+	uint16_t FlashJournal::crc16(uint16_t crc, const byte *data, unsigned int length)
+	{
+		while (length--)
+		{
+			crc ^= (uint16_t)*data++ << 8;
+			for (byte i = 0; i < 8; ++i)
+			{
+				crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+			}
+		}
+		return crc;
+	}
+
+	//reads the last good [generation][offset] from the cursor file - 0 and 0 if there is none
+	void FlashJournal::readCursor(uint32_t &generation, unsigned int &offset)
+	{
+		char path[32];
+		byte record[CURSOR_RECORD_SIZE];
+
+		generation = 0;
+		offset = 0;
+		m_nCursorSize = 0;
+
+		cursorPath(path);
+		if (!m_FS.exists(path))
+		{
+			return;
+		}
+		File f = m_FS.open(path, "r");
+		if (!f)
+		{
+			return;
+		}
+		while (f.read(record, CURSOR_RECORD_SIZE) == CURSOR_RECORD_SIZE)
+		{
+			m_nCursorSize += CURSOR_RECORD_SIZE;
+			if (crc16(0xFFFF, record, 6) == (uint16_t)(record[6] | (record[7] << 8)))
+			{
+				memcpy(&generation, record, 4);
+				offset = record[4] | (record[5] << 8);
+			}
+		}
+		f.close();
+	}
+
+	void FlashJournal::writeCursor()
+	{
+		char path[32];
+		byte record[CURSOR_RECORD_SIZE];
+		uint32_t generation = m_Segments[m_nRead].generation;
+
+		cursorPath(path);
+		if (m_nCursorSize + CURSOR_RECORD_SIZE > MAX_CURSOR_FILE_SIZE)
+		{
+			m_FS.remove(path);
+			m_nCursorSize = 0;
+		}
+
+		memcpy(record, &generation, 4);
+		record[4] = m_nReadOffset & 0xFF;
+		record[5] = m_nReadOffset >> 8;
+		uint16_t crc = crc16(0xFFFF, record, 6);
+		record[6] = crc & 0xFF;
+		record[7] = crc >> 8;
+
+		File f = m_FS.open(path, "a");
+		if (f)
+		{
+			m_nCursorSize += f.write(record, CURSOR_RECORD_SIZE);
+			m_lBytesWritten += CURSOR_RECORD_SIZE;
+			f.close();
+		}
+	}
+
+	//finds the valid records in a segment file - if it is the one the cursor points into, the oldest unsent record in it becomes the front
+	void FlashJournal::scanSegment(byte index, uint32_t cursorGeneration, unsigned int cursorOffset)
+	{
+		char path[32];
+		byte header[RECORD_HEADER_SIZE];
+		byte message[MAX_MESSAGE_LENGTH];
+		Segment &s = m_Segments[index];
+
+		s.generation = 0;
+		s.length = 0;
+		s.records = 0;
+
+		segmentPath(path, index);
+		if (!m_FS.exists(path))
+		{
+			return;
+		}
+		File f = m_FS.open(path, "r");
+		if (!f)
+		{
+			return;
+		}
+
+		uint32_t generation = 0;
+		if ((f.read(header, SEGMENT_HEADER_SIZE) == SEGMENT_HEADER_SIZE) && (memcmp(header, SEGMENT_SIGNATURE, 4) == 0))
+		{
+			memcpy(&generation, header + 4, 4);
+		}
+		if (generation == 0)
+		{
+			f.close();
+			m_FS.remove(path);		//not a segment this version can read
+			return;
+		}
+
+		bool isCursor = (generation == cursorGeneration);
+		unsigned int offset = SEGMENT_HEADER_SIZE;
+		unsigned int sent = 0;
+		while (f.read(header, RECORD_HEADER_SIZE) == RECORD_HEADER_SIZE)
+		{
+			unsigned int length = header[1] | (header[2] << 8);
+			if ((header[0] != RECORD_MAGIC) || (length > MAX_MESSAGE_LENGTH) || (f.read(message, length) != length))
+			{
+				break;
+			}
+			uint16_t crc = crc16(crc16(0xFFFF, header + 1, 6), message, length);
+			if (crc != (uint16_t)(header[7] | (header[8] << 8)))
+			{
+				break;		//torn or damaged - nothing after it can be trusted
+			}
+			if (isCursor && (offset < cursorOffset))
+			{
+				++sent;
+			}
+			offset += RECORD_HEADER_SIZE + length;
+			++s.records;
+		}
+		f.close();
+
+		s.generation = generation;
+		s.length = offset;
+
+		if (isCursor)
+		{
+			m_nRead = index;
+			m_nReadRecords = sent;
+			m_nReadOffset = SEGMENT_HEADER_SIZE;
+			//step to the first record at or after the cursor
+			if (sent)
+			{
+				File r = m_FS.open(path, "r");
+				if (r)
+				{
+					r.seek(m_nReadOffset);
+					for (unsigned int i = 0; (i < sent) && (r.read(header, RECORD_HEADER_SIZE) == RECORD_HEADER_SIZE); ++i)
+					{
+						m_nReadOffset += RECORD_HEADER_SIZE + (header[1] | (header[2] << 8));
+						r.seek(m_nReadOffset);
+					}
+					r.close();
+				}
+			}
+		}
+	}
+
+	int8_t FlashJournal::oldestSegment() const
+	{
+		int8_t oldest = -1;
+		for (byte i = 0; i < m_nSegments; ++i)
+		{
+			if (m_Segments[i].generation && ((oldest < 0) || (m_Segments[i].generation < m_Segments[oldest].generation)))
+			{
+				oldest = i;
+			}
+		}
+		return oldest;
+	}
+
+	int8_t FlashJournal::newestSegment() const
+	{
+		int8_t newest = -1;
+		for (byte i = 0; i < m_nSegments; ++i)
+		{
+			if (m_Segments[i].generation && ((newest < 0) || (m_Segments[i].generation > m_Segments[newest].generation)))
+			{
+				newest = i;
+			}
+		}
+		return newest;
+	}
+
+	void FlashJournal::removeSegment(byte index)
+	{
+		char path[32];
+
+		segmentPath(path, index);
+		m_FS.remove(path);
+		m_Segments[index].generation = 0;
+		m_Segments[index].length = 0;
+		m_Segments[index].records = 0;
+
+		if (index == m_nRead)
+		{
+			//the next segment is read from its start - no cursor needed
+			cursorPath(path);
+			m_FS.remove(path);
+			m_nCursorSize = 0;
+
+			m_nRead = oldestSegment();
+			m_nReadOffset = SEGMENT_HEADER_SIZE;
+			m_nReadRecords = 0;
+			m_bFrontLoaded = false;
+		}
+		if (index == m_nWrite)
+		{
+			m_nWrite = -1;
+		}
+	}
+
+	//starts the next segment file in turn for appending to, dropping the oldest segment if all are in use
+	bool FlashJournal::startSegment()
+	{
+		char path[32];
+		byte header[SEGMENT_HEADER_SIZE];
+		int8_t newest = newestSegment();
+		byte next = (newest < 0) ? 0 : (newest + 1) % m_nSegments;
+
+		if (m_Segments[next].generation)
+		{
+			m_lDropped += m_Segments[next].records - ((next == m_nRead) ? m_nReadRecords : 0);
+			removeSegment(next);
+		}
+
+		uint32_t generation = m_nNextGeneration++;
+		memcpy(header, SEGMENT_SIGNATURE, 4);
+		memcpy(header + 4, &generation, 4);
+
+		segmentPath(path, next);
+		File f = m_FS.open(path, "w");
+		if (!f)
+		{
+			return false;
+		}
+		bool ok = (f.write(header, SEGMENT_HEADER_SIZE) == SEGMENT_HEADER_SIZE);
+		f.close();
+		m_lBytesWritten += SEGMENT_HEADER_SIZE;
+		if (!ok)
+		{
+			m_FS.remove(path);
+			return false;
+		}
+
+		m_Segments[next].generation = generation;
+		m_Segments[next].length = SEGMENT_HEADER_SIZE;
+		m_Segments[next].records = 0;
+		m_nWrite = next;
+		if (m_nRead < 0)
+		{
+			m_nRead = next;
+			m_nReadOffset = SEGMENT_HEADER_SIZE;
+			m_nReadRecords = 0;
+		}
+		settleRead();		//the segment written until now may already have been sent
+		return true;
+	}
+
+	//deletes fully sent segments, except the one still being appended to
+	void FlashJournal::settleRead()
+	{
+		while ((m_nRead >= 0) && (m_nRead != m_nWrite) && (m_nReadOffset >= m_Segments[m_nRead].length))
+		{
+			removeSegment(m_nRead);
+		}
+	}
+
+	bool FlashJournal::loadFront()
+	{
+		char path[32];
+		byte header[RECORD_HEADER_SIZE];
+
+		while (!m_bFrontLoaded)
+		{
+			settleRead();
+			if ((m_nRead < 0) || (m_nReadOffset >= m_Segments[m_nRead].length))
+			{
+				return false;
+			}
+
+			segmentPath(path, m_nRead);
+			File f = m_FS.open(path, "r");
+			bool ok = f && f.seek(m_nReadOffset) && (f.read(header, RECORD_HEADER_SIZE) == RECORD_HEADER_SIZE);
+			if (ok)
+			{
+				m_nFrontLength = header[1] | (header[2] << 8);
+				ok = (header[0] == RECORD_MAGIC) && (m_nFrontLength <= MAX_MESSAGE_LENGTH) &&
+					 (f.read((byte *)m_Front, m_nFrontLength) == m_nFrontLength) &&
+					 (crc16(crc16(0xFFFF, header + 1, 6), (const byte *)m_Front, m_nFrontLength) == (uint16_t)(header[7] | (header[8] << 8)));
+			}
+			if (f)
+			{
+				f.close();
+			}
+
+			if (ok)
+			{
+				uint32_t captured;
+				memcpy(&captured, header + 3, 4);
+				m_lFrontCaptured = captured;
+				m_bFrontLoaded = true;
+			}
+			else
+			{
+				//unreadable - give up on the rest of this segment, and never append to it again
+				m_lDropped += m_Segments[m_nRead].records - m_nReadRecords;
+				m_Segments[m_nRead].length = m_nReadOffset;
+				m_Segments[m_nRead].records = m_nReadRecords;
+				if (m_nRead == m_nWrite)
+				{
+					m_nWrite = -1;
+				}
+			}
+		}
+		return true;
+	}
+
+//public
+	//*******************************************************************************
+	// FlashJournal Constructor
+	//*******************************************************************************
+	FlashJournal::FlashJournal(fs::FS &fs, const char *name, byte segments, unsigned int segmentSize) :
+		m_FS(fs),
+		m_pName(name),
+		m_nSegments(segments < 2 ? 2 : (segments > MAX_SEGMENTS ? MAX_SEGMENTS : segments)),
+		m_nSegmentSize(segmentSize),
+		m_nNextGeneration(1),
+		m_nBootGeneration(1),
+		m_nWrite(-1),
+		m_nRead(-1),
+		m_nReadOffset(SEGMENT_HEADER_SIZE),
+		m_nReadRecords(0),
+		m_nCursorSize(0),
+		m_bFrontLoaded(false),
+		m_nFrontLength(0),
+		m_lFrontCaptured(0)
+	{
+		memset(m_Segments, 0, sizeof(m_Segments));
+	}
+
+	void FlashJournal::begin()
+	{
+		uint32_t cursorGeneration;
+		unsigned int cursorOffset;
+
+		readCursor(cursorGeneration, cursorOffset);
+
+		m_nWrite = -1;
+		m_nRead = -1;
+		m_bFrontLoaded = false;
+		for (byte i = 0; i < m_nSegments; ++i)
+		{
+			scanSegment(i, cursorGeneration, cursorOffset);
+		}
+
+		uint32_t newest = 0;
+		for (byte i = 0; i < m_nSegments; ++i)
+		{
+			if (m_Segments[i].generation && (m_Segments[i].generation < cursorGeneration))
+			{
+				removeSegment(i);		//sent before the reset
+			}
+			else if (m_Segments[i].generation > newest)
+			{
+				newest = m_Segments[i].generation;
+			}
+		}
+		if (m_nRead < 0)
+		{
+			m_nRead = oldestSegment();
+			m_nReadOffset = SEGMENT_HEADER_SIZE;
+			m_nReadRecords = 0;
+		}
+
+		//a segment from before the reset may end in a torn record, so it is never appended to again
+		m_nNextGeneration = newest + 1;
+		m_nBootGeneration = m_nNextGeneration;
+		settleRead();
+	}
+
+	bool FlashJournal::append(const char *message, unsigned int length, unsigned long capturedMillis)
+	{
+		char path[32];
+		byte record[RECORD_HEADER_SIZE + MAX_MESSAGE_LENGTH];
+		unsigned int size = RECORD_HEADER_SIZE + length;
+
+		if ((length > MAX_MESSAGE_LENGTH) || (SEGMENT_HEADER_SIZE + size > m_nSegmentSize))
+		{
+			++m_lDropped;
+			return false;
+		}
+		if (((m_nWrite < 0) || (m_Segments[m_nWrite].length + size > m_nSegmentSize)) && !startSegment())
+		{
+			++m_lDropped;
+			return false;
+		}
+
+		//built whole so it is written in one go - each write to a file costs a flash program
+		uint32_t captured = capturedMillis;
+		record[0] = RECORD_MAGIC;
+		record[1] = length & 0xFF;
+		record[2] = length >> 8;
+		memcpy(record + 3, &captured, 4);
+		memcpy(record + RECORD_HEADER_SIZE, message, length);
+		uint16_t crc = crc16(crc16(0xFFFF, record + 1, 6), (const byte *)message, length);
+		record[7] = crc & 0xFF;
+		record[8] = crc >> 8;
+
+		segmentPath(path, m_nWrite);
+		File f = m_FS.open(path, "a");
+		if (!f)
+		{
+			++m_lDropped;
+			return false;
+		}
+		size_t written = f.write(record, size);
+		f.close();
+		m_lBytesWritten += written;
+
+		if (written != size)
+		{
+			//the segment may now end in part of a record - start a new one next time
+			m_nWrite = -1;
+			++m_lDropped;
+			return false;
+		}
+
+		m_Segments[m_nWrite].length += size;
+		++m_Segments[m_nWrite].records;
+		++m_lAppended;
+		return true;
+	}
+
+	bool FlashJournal::front(const char *&message, unsigned int &length, unsigned long &capturedMillis, bool &thisBoot)
+	{
+		if (!loadFront())
+		{
+			return false;
+		}
+
+		message = m_Front;
+		length = m_nFrontLength;
+		capturedMillis = m_lFrontCaptured;
+		thisBoot = (m_Segments[m_nRead].generation >= m_nBootGeneration);
+		return true;
+	}
+
+	void FlashJournal::pop()
+	{
+		if (!loadFront())
+		{
+			return;
+		}
+
+		m_nReadOffset += RECORD_HEADER_SIZE + m_nFrontLength;
+		++m_nReadRecords;
+		++m_lRemoved;
+		m_bFrontLoaded = false;
+
+		if ((m_nReadOffset < m_Segments[m_nRead].length) || (m_nRead == m_nWrite))
+		{
+			writeCursor();
+		}
+		settleRead();
+	}
+
+	bool FlashJournal::isEmpty()
+	{
+		settleRead();
+		return (m_nRead < 0) || (m_nReadOffset >= m_Segments[m_nRead].length);
+	}
+}
+
+#endif
@@ -0,0 +1,114 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - Flash Journal (ESP8266 and ESP32 only)
+//
+//	Summary:  st::FlashJournal is an st::EventJournal kept in LittleFS or SPIFFS,
+//			  so messages that could not be sent survive a reset or deep sleep.
+//
+//			  The journal is a fixed set of segment files ("/stj0", "/stj1", ...),
+//			  used in turn.  Records are only ever appended to the newest segment,
+//			  and a segment is deleted once every record in it has been sent - the
+//			  file system spreads the writes over the flash.  When every segment is
+//			  full, the oldest one is dropped to make room.
+//
+//			  Segment file:	["STJ"][version][generation (4 bytes)] then records
+//			  Record:		[0xA5][length (2 bytes)][captured millis (4 bytes)][CRC16 (2 bytes)][message]
+//
+//			  A record whose CRC does not match (e.g. power was lost while it was
+//			  being written) ends its segment.  How far the oldest segment has been
+//			  sent is appended to a small cursor file ("/stjc") after each pop(), so
+//			  at most one message is sent twice after a reset.
+//
+//			  Call LittleFS.begin() (or SPIFFS.begin()) and then begin() in setup().
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  a00889920      Created to keep events across a reset during a network outage
+//*******************************************************************************
+#ifndef __FLASHJOURNAL_H__
+#define __FLASHJOURNAL_H__
+
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+
+#include "EventJournal.h"
+#include <FS.h>
+
+namespace st
+{
+	class FlashJournal: public EventJournal
+	{
+	private:
+		static const byte MAX_SEGMENTS = 8;
+		static const unsigned int SEGMENT_HEADER_SIZE = 8;
+		static const unsigned int RECORD_HEADER_SIZE = 9;
+		static const byte RECORD_MAGIC = 0xA5;
+		static const unsigned int CURSOR_RECORD_SIZE = 8;		//[generation (4 bytes)][offset (2 bytes)][CRC16 (2 bytes)]
+		static const unsigned int MAX_CURSOR_FILE_SIZE = 256;	//the cursor file is started again when it reaches this size
+
+		struct Segment
+		{
+			uint32_t generation;	//order the segments were started in (0 = slot not in use)
+			unsigned int length;	//bytes of valid records, including the segment header
+			unsigned int records;	//number of valid records
+		};
+
+		fs::FS &m_FS;
+		const char *m_pName;
+		byte m_nSegments;
+		unsigned int m_nSegmentSize;
+
+		Segment m_Segments[MAX_SEGMENTS];
+		uint32_t m_nNextGeneration;
+		uint32_t m_nBootGeneration;		//segments from this generation on were started since this board last started
+		int8_t m_nWrite;				//segment being appended to (-1 = none yet since this board started)
+		int8_t m_nRead;					//segment holding the oldest record (-1 = journal empty)
+		unsigned int m_nReadOffset;		//offset of the oldest record within it
+		unsigned int m_nReadRecords;	//records before it in that segment (already sent)
+		unsigned int m_nCursorSize;		//bytes in the cursor file
+
+		//the oldest record, read from flash by front()
+		bool m_bFrontLoaded;
+		char m_Front[MAX_MESSAGE_LENGTH];
+		unsigned int m_nFrontLength;
+		unsigned long m_lFrontCaptured;
+
+		void segmentPath(char *path, byte index) const;
+		void cursorPath(char *path) const;
+		static uint16_t crc16(uint16_t crc, const byte *data, unsigned int length);
+
+		void readCursor(uint32_t &generation, unsigned int &offset);
+		void writeCursor();
+		void scanSegment(byte index, uint32_t cursorGeneration, unsigned int cursorOffset);
+		int8_t oldestSegment() const;
+		int8_t newestSegment() const;
+		void removeSegment(byte index);
+		bool startSegment();
+		void settleRead();
+		bool loadFront();
+
+	public:
+		//*******************************************************************************
+		/// @brief  FlashJournal Constructor
+		///   @param[in] fs - file system to keep the journal in (LittleFS or SPIFFS)
+		///   @param[in] name (optional) - start of the journal's file names (kept, not copied)
+		///   @param[in] segments (optional) - number of segment files (2 to 8)
+		///   @param[in] segmentSize (optional) - largest size of each segment file in bytes
+		//*******************************************************************************
+		FlashJournal(fs::FS &fs, const char *name = "/stj", byte segments = 4, unsigned int segmentSize = 4096);
+
+		//*******************************************************************************
+		/// Finds the records left by the previous run - call after the file system's begin()
+		//*******************************************************************************
+		void begin();
+
+		using EventJournal::append;
+		virtual bool append(const char *message, unsigned int length, unsigned long capturedMillis);
+		virtual bool front(const char *&message, unsigned int &length, unsigned long &capturedMillis, bool &thisBoot);
+		virtual void pop();
+		virtual bool isEmpty();
+	};
+}
+
+#endif
+#endif
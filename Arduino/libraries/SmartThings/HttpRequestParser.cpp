@@ -0,0 +1,226 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - HTTP Request Parser
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  a00889920      Created to replace the String based request handling in the WiFi transports
+//*******************************************************************************
+#include "HttpRequestParser.h"
+
+namespace st
+{
+	//header whose value is needed - matched case insensitively at the start of each header line
+	static const char CONTENT_LENGTH[] = "content-length:";
+	static const byte CONTENT_LENGTH_SIZE = sizeof(CONTENT_LENGTH) - 1;
+
+//private
+	void HttpRequestParser::append(char c)
+	{
+		if (m_nLength < MAX_COMMAND_LENGTH)
+		{
+			m_Command[m_nLength++] = c;
+			m_Command[m_nLength] = 0;
+		}
+		else
+		{
+			m_bOverflow = true;
+		}
+	}
+
+	void HttpRequestParser::startRequest()
+	{
+		m_Command[0] = 0;
+		m_nLength = 0;
+		m_State = PARSE_METHOD;
+		m_bOverflow = false;
+		m_bComplete = false;
+		m_bStarted = false;
+		m_bLineBlank = true;
+		m_nHeaderMatch = 0;
+		m_lBodyLength = 0;
+	}
+
+	bool HttpRequestParser::endHeaderLine()
+	{
+		if (!m_bLineBlank)
+		{
+			m_bLineBlank = true;
+			m_nHeaderMatch = 0;
+			return false;
+		}
+
+		//blank line - end of the headers
+		if (m_lBodyLength > 0)
+		{
+			m_State = PARSE_BODY;
+			return false;
+		}
+		return true;
+	}
+
+	int HttpRequestParser::hexValue(char c)
+	{
+		if ((c >= '0') && (c <= '9'))
+		{
+			return c - '0';
+		}
+		c |= 0x20;	//lower case
+		if ((c >= 'a') && (c <= 'f'))
+		{
+			return c - 'a' + 10;
+		}
+		return -1;
+	}
+
+//public
+	HttpRequestParser::HttpRequestParser()
+	{
+		reset();
+	}
+
+	void HttpRequestParser::reset()
+	{
+		startRequest();
+	}
+
+	bool HttpRequestParser::feed(char c)
+	{
+		if (m_bComplete)
+		{
+			startRequest();		//the previous request has been handled - this byte starts the next one
+		}
+
+		if (!m_bStarted)
+		{
+			if ((c == '\r') || (c == '\n'))
+			{
+				return false;	//stray line ends between pipelined requests
+			}
+			m_bStarted = true;
+		}
+
+		switch (m_State)
+		{
+		case PARSE_METHOD:
+			if (c == ' ')
+			{
+				m_State = PARSE_TARGET;
+			}
+			else if (c == '\n')
+			{
+				m_State = PARSE_HEADERS;	//malformed request line - skip to the end of the request
+			}
+			break;
+
+		case PARSE_TARGET:
+			if (c == '/')
+			{
+				m_State = PARSE_PATH;
+			}
+			else if (c == ' ')
+			{
+				m_State = PARSE_REQUEST_LINE;
+			}
+			else if (c == '\n')
+			{
+				m_State = PARSE_HEADERS;
+			}
+			break;
+
+		case PARSE_PATH:
+			if ((c == '?') || (c == ' ') || (c == '#'))
+			{
+				m_State = PARSE_REQUEST_LINE;
+			}
+			else if (c == '%')
+			{
+				m_State = PARSE_PERCENT;
+			}
+			else if (c == '\n')
+			{
+				m_State = PARSE_HEADERS;
+			}
+			else if (c != '\r')
+			{
+				append(c);
+			}
+			break;
+
+		case PARSE_PERCENT:
+		{
+			int value = hexValue(c);
+			if (value < 0)
+			{
+				append('%');	//not an escape - keep it as it was sent
+				append(c);
+				m_State = PARSE_PATH;
+			}
+			else
+			{
+				m_nPercent = value;
+				m_State = PARSE_PERCENT2;
+			}
+			break;
+		}
+
+		case PARSE_PERCENT2:
+		{
+			int value = hexValue(c);
+			if (value < 0)
+			{
+				append('%');
+				append("0123456789ABCDEF"[m_nPercent]);
+				append(c);
+			}
+			else
+			{
+				append((char)((m_nPercent << 4) | value));
+			}
+			m_State = PARSE_PATH;
+			break;
+		}
+
+		case PARSE_REQUEST_LINE:
+			if (c == '\n')
+			{
+				m_State = PARSE_HEADERS;
+			}
+			break;
+
+		case PARSE_HEADERS:
+			if (c == '\n')
+			{
+				m_bComplete = endHeaderLine();
+			}
+			else if (c != '\r')
+			{
+				m_bLineBlank = false;
+				if (m_nHeaderMatch < CONTENT_LENGTH_SIZE)
+				{
+					//still matching the header name - 0xFF marks a header that is not Content-Length
+					m_nHeaderMatch = ((c | 0x20) == CONTENT_LENGTH[m_nHeaderMatch]) ? m_nHeaderMatch + 1 : 0xFF;
+				}
+				else if ((m_nHeaderMatch == CONTENT_LENGTH_SIZE) && (c >= '0') && (c <= '9'))
+				{
+					m_lBodyLength = m_lBodyLength * 10 + (c - '0');
+				}
+			}
+			break;
+
+		case PARSE_BODY:
+			if (--m_lBodyLength == 0)
+			{
+				m_bComplete = true;
+			}
+			break;
+		}
+
+		if (m_bComplete)
+		{
+			m_bStarted = false;
+		}
+		return m_bComplete;
+	}
+}
@@ -0,0 +1,94 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - HTTP Request Parser
+//
+//	Summary:  st::HttpRequestParser pulls the command out of the HTTP requests the
+//			  hub sends to the device's server, e.g. "POST /switch1%20on? HTTP/1.1"
+//			  gives "switch1 on".  It is fed one byte at a time, so a request may
+//			  arrive across any number of run() calls, and several requests may
+//			  follow each other on one connection (pipelining).
+//
+//			  The command is percent-decoded in place into a fixed buffer - no heap
+//			  memory is ever allocated.  Headers are skipped, apart from
+//			  Content-Length, which is used to skip any request body.
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  a00889920      Created to replace the String based request handling in the WiFi transports
+//*******************************************************************************
+#ifndef __HTTPREQUESTPARSER_H__
+#define __HTTPREQUESTPARSER_H__
+
+#include <Arduino.h>
+
+namespace st
+{
+	class HttpRequestParser
+	{
+	public:
+		//longest command kept - longer commands are truncated (and reported by overflowed())
+		static const unsigned int MAX_COMMAND_LENGTH = 100;
+
+	private:
+		typedef enum
+		{
+			PARSE_METHOD,			//"POST"
+			PARSE_TARGET,			//up to the first '/' of the request target
+			PARSE_PATH,				//the command, up to '?' or ' '
+			PARSE_PERCENT,			//first hex digit after '%'
+			PARSE_PERCENT2,			//second hex digit after '%'
+			PARSE_REQUEST_LINE,		//rest of the request line
+			PARSE_HEADERS,			//header lines, up to the blank line
+			PARSE_BODY				//Content-Length bytes of body
+		} ParseState_t;
+
+		char m_Command[MAX_COMMAND_LENGTH + 1];
+		unsigned int m_nLength;
+		ParseState_t m_State;
+		bool m_bOverflow;
+		bool m_bComplete;			//the last byte fed completed a request
+		bool m_bStarted;			//some of the current request has been fed
+		bool m_bLineBlank;			//no characters other than '\r' seen on the current header line
+		byte m_nHeaderMatch;		//characters of "content-length:" matched at the start of the current header line
+		byte m_nPercent;			//value of the first hex digit of a %XX escape
+		unsigned long m_lBodyLength;	//Content-Length of the current request, then body bytes left to skip
+
+		void append(char c);
+		void startRequest();
+		bool endHeaderLine();		//returns true if the request is complete
+		static int hexValue(char c);
+
+	public:
+		HttpRequestParser();
+
+		//*******************************************************************************
+		/// Forgets any partly parsed request - call when a new connection is accepted
+		//*******************************************************************************
+		void reset();
+
+		//*******************************************************************************
+		/// Parses one byte.  Returns true when it completes a request - command() is then
+		/// valid until the next call to feed() or reset().
+		//*******************************************************************************
+		bool feed(char c);
+
+		//*******************************************************************************
+		/// The decoded command of the completed request (null terminated), empty if the
+		/// request did not carry one
+		//*******************************************************************************
+		const char *command() const { return m_Command; }
+		unsigned int commandLength() const { return m_nLength; }
+
+		//*******************************************************************************
+		/// true if the command was longer than MAX_COMMAND_LENGTH and was truncated
+		//*******************************************************************************
+		bool overflowed() const { return m_bOverflow; }
+
+		//*******************************************************************************
+		/// true if no request is partly parsed (between requests)
+		//*******************************************************************************
+		bool isIdle() const { return !m_bStarted; }
+	};
+}
+#endif
@@ -0,0 +1,293 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - Message Queue
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  a00889920      Created to replace the Everything::Return_String buffer
+//	2026-10-16  a00889920      Records carry their enqueue time so the wait in the queue can be measured
+//	2026-10-16  a00889920      Added coalesce() to replace a pending message with a newer one for the same key
+//	2026-10-16  a00889920      Added frontBatch() to view several of the oldest messages at once
+//	2026-10-16  a00889920      Added a push() overload that joins several messages into one record
+//	2026-10-16  a00889920      Added a push() overload that writes a caller's header and message as one record
+//*******************************************************************************
+#include "MessageQueue.h"
+
+namespace st
+{
+	//length value written in place of a record header to mark unused space at the end of the buffer
+	static const unsigned int PADDING_MARKER = 0xFFFF;
+	//set in a record's length when the record has been replaced and must not be sent
+	static const unsigned int DEAD_FLAG = 0x8000;
+	static const unsigned int LENGTH_MASK = 0x7FFF;
+
+//private
+	unsigned int MessageQueue::readWord(unsigned int index) const
+	{
+		return m_pBuffer[index] | ((unsigned int)m_pBuffer[index + 1] << 8);
+	}
+
+	void MessageQueue::writeWord(unsigned int index, unsigned int value)
+	{
+		m_pBuffer[index] = value & 0xFF;
+		m_pBuffer[index + 1] = (value >> 8) & 0xFF;
+	}
+
+	unsigned int MessageQueue::frontIndex() const
+	{
+		//the writer skipped to the start of the buffer if there was no room for a header, or left a padding marker
+		if ((m_nSize - m_nHead < HEADER_SIZE) || (readWord(m_nHead) == PADDING_MARKER))
+		{
+			return 0;
+		}
+		return m_nHead;
+	}
+
+	unsigned int MessageQueue::nextIndex(unsigned int index) const
+	{
+		index += HEADER_SIZE + (readWord(index) & LENGTH_MASK);
+		if ((m_nSize - index < HEADER_SIZE) || (readWord(index) == PADDING_MARKER))
+		{
+			return 0;
+		}
+		return index;
+	}
+
+	void MessageQueue::discardFront()
+	{
+		unsigned int index = frontIndex();
+		unsigned int next = index + HEADER_SIZE + (readWord(index) & LENGTH_MASK);
+
+		m_nUsed -= (index == m_nHead ? 0 : m_nSize - m_nHead) + (next - index);
+		m_nHead = next;
+		--m_nRecords;
+	}
+
+	void MessageQueue::discardDead()
+	{
+		if (m_nCount == 0)
+		{
+			clear();	//only replaced records are left - rewind to the start of the buffer to keep the free space contiguous
+			return;
+		}
+		while (readWord(frontIndex()) & DEAD_FLAG)
+		{
+			discardFront();
+		}
+	}
+
+	bool MessageQueue::pushParts(const char * const *parts, const unsigned int *lengths, byte count, const char *separator)
+	{
+		unsigned int length = 0;
+		for (byte i = 0; i < count; ++i)
+		{
+			length += ((i > 0) && separator ? 1 : 0) + lengths[i];
+		}
+
+		unsigned int needed = HEADER_SIZE + length;
+		unsigned int index = m_nTail;
+		unsigned int padding = 0;
+
+		if ((length > LENGTH_MASK) || (needed > m_nSize))
+		{
+			return false;
+		}
+
+		//records are never split - if it does not fit before the end of the buffer, start over at the beginning
+		if (m_nSize - index < needed)
+		{
+			padding = m_nSize - index;
+			index = 0;
+		}
+
+		if (m_nUsed + padding + needed > m_nSize)
+		{
+			return false;
+		}
+
+		if (padding >= HEADER_SIZE)
+		{
+			writeWord(m_nTail, PADDING_MARKER);
+		}
+
+		writeWord(index, length);
+		writeWord(index + 2, (unsigned int)millis());
+		byte *dest = m_pBuffer + index + HEADER_SIZE;
+		for (byte i = 0; i < count; ++i)
+		{
+			if ((i > 0) && separator)
+			{
+				*dest++ = *separator;
+			}
+			memcpy(dest, parts[i], lengths[i]);
+			dest += lengths[i];
+		}
+
+		m_nTail = index + needed;
+		m_nUsed += padding + needed;
+		++m_nCount;
+		++m_nRecords;
+		return true;
+	}
+
+//public
+	//*******************************************************************************
+	// MessageQueue Constructor
+	//*******************************************************************************
+	MessageQueue::MessageQueue(byte *buffer, unsigned int size) :
+		m_pBuffer(buffer),
+		m_nSize(size)
+	{
+		clear();
+	}
+
+	bool MessageQueue::push(const char *message, unsigned int length)
+	{
+		return pushParts(&message, &length, 1, 0);
+	}
+
+	bool MessageQueue::push(const char * const *messages, const unsigned int *lengths, byte count, char separator)
+	{
+		return pushParts(messages, lengths, count, &separator);
+	}
+
+	bool MessageQueue::push(const char *header, unsigned int headerLength, const char *message, unsigned int length)
+	{
+		const char *parts[2] = {header, message};
+		unsigned int lengths[2] = {headerLength, length};
+		return pushParts(parts, lengths, 2, 0);
+	}
+
+	bool MessageQueue::coalesce(const char *message, unsigned int length, unsigned int keyLength)
+	{
+		unsigned int index = frontIndex();
+		unsigned int match = 0;
+		bool found = false;
+
+		//replace the newest matching message, so the queue never ends up holding an older value after a newer one
+		for (unsigned int i = 0; i < m_nRecords; ++i)
+		{
+			if (i > 0)
+			{
+				index = nextIndex(index);
+			}
+
+			unsigned int oldLength = readWord(index);
+			if (!(oldLength & DEAD_FLAG) && (oldLength >= keyLength) && (memcmp(m_pBuffer + index + HEADER_SIZE, message, keyLength) == 0))
+			{
+				match = index;
+				found = true;
+			}
+		}
+
+		if (!found)
+		{
+			return false;
+		}
+
+		unsigned int oldLength = readWord(match);
+		if (length == oldLength)
+		{
+			memcpy(m_pBuffer + match + HEADER_SIZE, message, length);
+		}
+		else if (length + HEADER_SIZE <= oldLength)
+		{
+			//shorter - keep the record's place in the queue and turn the space left over into a dead record
+			writeWord(match, length);
+			memcpy(m_pBuffer + match + HEADER_SIZE, message, length);
+			writeWord(match + HEADER_SIZE + length, (oldLength - length - HEADER_SIZE) | DEAD_FLAG);
+			++m_nRecords;
+		}
+		else
+		{
+			//does not fit in place - queue the new value at the end, then retire the old one
+			if (!push(message, length))
+			{
+				return false;
+			}
+			writeWord(match, oldLength | DEAD_FLAG);
+			--m_nCount;
+			discardDead();
+		}
+		return true;
+	}
+
+	bool MessageQueue::front(const char *&message, unsigned int &length) const
+	{
+		if (m_nCount == 0)
+		{
+			return false;
+		}
+
+		unsigned int index = frontIndex();
+		length = readWord(index);
+		message = (const char *)(m_pBuffer + index + HEADER_SIZE);
+		return true;
+	}
+
+	byte MessageQueue::frontBatch(const char *messages[], unsigned int lengths[], byte maxCount, unsigned int maxBytes) const
+	{
+		unsigned int index = frontIndex();
+		unsigned int total = 0;
+		unsigned int live = 0;
+		byte count = 0;
+
+		for (unsigned int i = 0; (i < m_nRecords) && (live < m_nCount) && (count < maxCount); ++i)
+		{
+			if (i > 0)
+			{
+				index = nextIndex(index);
+			}
+
+			unsigned int length = readWord(index);
+			if (length & DEAD_FLAG)
+			{
+				continue;
+			}
+			++live;
+
+			if ((count > 0) && (total + 1 + length > maxBytes))
+			{
+				break;
+			}
+			total += (count > 0 ? 1 : 0) + length;
+			messages[count] = (const char *)(m_pBuffer + index + HEADER_SIZE);
+			lengths[count] = length;
+			++count;
+		}
+		return count;
+	}
+
+	unsigned int MessageQueue::frontAge() const
+	{
+		if (m_nCount == 0)
+		{
+			return 0;
+		}
+
+		//only the low 16 bits of millis() are stored, which is plenty for measuring transmit pacing delays
+		return (unsigned int)((millis() - readWord(frontIndex() + 2)) & 0xFFFF);
+	}
+
+	void MessageQueue::pop()
+	{
+		if (m_nCount == 0)
+		{
+			return;
+		}
+
+		discardFront();
+		--m_nCount;
+		discardDead();
+	}
+
+	void MessageQueue::clear()
+	{
+		m_nHead = 0;
+		m_nTail = 0;
+		m_nUsed = 0;
+		m_nCount = 0;
+		m_nRecords = 0;
+	}
+}
@@ -0,0 +1,128 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - Message Queue
+//
+//	Summary:  st::MessageQueue is a fixed-capacity FIFO of variable length text
+//			  messages, stored as length-prefixed records in a caller supplied
+//			  byte buffer.  No heap memory is ever allocated.
+//
+//			  A record is never split across the end of the buffer.  When a new
+//			  record does not fit in the space remaining at the end, that space
+//			  is skipped and the record is written at the start of the buffer.
+//			  This guarantees front() always returns one contiguous message
+//			  which can be handed directly to a transport's send() routine.
+//
+//			  Each record is stored as [length (2 bytes)][enqueue millis (2 bytes)][message].
+//
+//			  coalesce() lets a newer message replace a pending one that starts with the
+//			  same key (e.g. "power1 ").  Replaced records are flagged dead in their length
+//			  and are skipped, never sent.
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  a00889920      Created to replace the Everything::Return_String buffer
+//	2026-10-16  a00889920      Records carry their enqueue time so the wait in the queue can be measured
+//	2026-10-16  a00889920      Added coalesce() to replace a pending message with a newer one for the same key
+//	2026-10-16  a00889920      Added frontBatch() to view several of the oldest messages at once
+//	2026-10-16  a00889920      Added a push() overload that joins several messages into one record
+//	2026-10-16  a00889920      Added a push() overload that writes a caller's header and message as one record
+//*******************************************************************************
+#ifndef __MESSAGEQUEUE_H__
+#define __MESSAGEQUEUE_H__
+
+#include <Arduino.h>
+
+namespace st
+{
+	class MessageQueue
+	{
+	private:
+		byte *m_pBuffer;			//caller supplied storage
+		unsigned int m_nSize;		//size of m_pBuffer in bytes
+		unsigned int m_nHead;		//index of the oldest record (or of the padding in front of it)
+		unsigned int m_nTail;		//index where the next record will be written
+		unsigned int m_nUsed;		//bytes in use, including any padding skipped at the end of the buffer
+		unsigned int m_nCount;		//number of messages waiting to be sent
+		unsigned int m_nRecords;	//number of records in the buffer, including dead (replaced) ones
+
+		unsigned int readWord(unsigned int index) const;
+		void writeWord(unsigned int index, unsigned int value);
+		unsigned int frontIndex() const;	//index of the oldest record, skipping any padding
+		unsigned int nextIndex(unsigned int index) const;	//index of the record after the one at index, skipping any padding
+		void discardFront();		//removes the oldest record, live or dead
+		void discardDead();			//removes dead records from the front so front() always sees a live message
+		bool pushParts(const char * const *parts, const unsigned int *lengths, byte count, const char *separator);	//joins the parts into one record, with *separator (if any) between them
+
+	public:
+		//size of the length and timestamp header stored in front of every record
+		static const unsigned int HEADER_SIZE = 4;
+
+		//*******************************************************************************
+		/// @brief  MessageQueue Constructor
+		///   @param[in] buffer - storage for the queued records (must outlive the queue)
+		///   @param[in] size - size of buffer in bytes
+		//*******************************************************************************
+		MessageQueue(byte *buffer, unsigned int size);
+
+		//*******************************************************************************
+		/// Adds a message to the end of the queue.  Returns false if it does not fit.
+		//*******************************************************************************
+		bool push(const char *message, unsigned int length);
+
+		//*******************************************************************************
+		/// Adds several messages to the end of the queue as one message, with separator
+		/// between them.  Returns false if it does not fit.
+		//*******************************************************************************
+		bool push(const char * const *messages, const unsigned int *lengths, byte count, char separator);
+
+		//*******************************************************************************
+		/// Adds header followed directly by message to the end of the queue as one message,
+		/// without copying them together first.  Returns false if it does not fit.
+		//*******************************************************************************
+		bool push(const char *header, unsigned int headerLength, const char *message, unsigned int length);
+
+		//*******************************************************************************
+		/// Replaces the newest pending message whose first keyLength bytes match message with
+		/// message.  The old message's place in the queue is kept if the new one fits,
+		/// otherwise the new message is added to the end.  Returns false if there was
+		/// no matching message, or the new message does not fit.
+		//*******************************************************************************
+		bool coalesce(const char *message, unsigned int length, unsigned int keyLength);
+
+		//*******************************************************************************
+		/// Returns a view of the oldest message.  Returns false if the queue is empty.
+		/// The view remains valid until pop() or clear() is called.
+		//*******************************************************************************
+		bool front(const char *&message, unsigned int &length) const;
+
+		//*******************************************************************************
+		/// Returns how long (ms) the oldest message has been queued (wraps after 65535)
+		//*******************************************************************************
+		unsigned int frontAge() const;
+
+		//*******************************************************************************
+		/// Returns views of the oldest messages, as many as fit in maxBytes when joined
+		/// with one separator byte between them (at most maxCount).  The oldest message is
+		/// always included, whatever its size.  Returns the number of views filled in.
+		/// The views remain valid until the same number of pop() calls, or clear().
+		//*******************************************************************************
+		byte frontBatch(const char *messages[], unsigned int lengths[], byte maxCount, unsigned int maxBytes) const;
+
+		//*******************************************************************************
+		/// Removes the oldest message from the queue
+		//*******************************************************************************
+		void pop();
+
+		//*******************************************************************************
+		/// Removes all messages from the queue
+		//*******************************************************************************
+		void clear();
+
+		bool isEmpty() const { return m_nCount == 0; }
+		unsigned int count() const { return m_nCount; }
+		unsigned int capacity() const { return m_nSize; }
+		unsigned int bytesUsed() const { return m_nUsed; }
+	};
+}
+#endif
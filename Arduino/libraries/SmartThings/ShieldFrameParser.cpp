@@ -0,0 +1,207 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - ThingShield Frame Parser
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  a00889920      Created to replace the line buffer and translatePayload() of SmartThingsThingShield
+//*******************************************************************************
+#include "ShieldFrameParser.h"
+
+namespace st
+{
+	static const char RX_PREFIX[] = "T????????:RX";		//'?' matches any character
+	static const byte RX_PREFIX_SIZE = sizeof(RX_PREFIX) - 1;
+	static const char NETINFO[] = "netinfo:";
+	static const byte NETINFO_SIZE = sizeof(NETINFO) - 1;
+
+//private
+	void ShieldFrameParser::startLine()
+	{
+		m_nColumn = 0;
+		m_bRxLine = true;
+		m_bInPayload = false;
+		m_bPayloadDone = false;
+		m_bOverflow = false;
+		m_nNibble = -1;
+		m_nPayload = 0;
+		m_nNetinfoMatch = 0;
+		m_nNetInfo = 0;
+	}
+
+	int ShieldFrameParser::hexValue(char c)
+	{
+		if ((c >= '0') && (c <= '9')) return c - '0';
+		if ((c >= 'A') && (c <= 'F')) return c - 'A' + 10;
+		if ((c >= 'a') && (c <= 'f')) return c - 'a' + 10;
+		return -1;
+	}
+
+	int ShieldFrameParser::hexByte(const char *p)
+	{
+		int high = hexValue(p[0]);
+		int low = hexValue(p[1]);
+		return ((high < 0) || (low < 0)) ? -1 : (high << 4) | low;
+	}
+
+	void ShieldFrameParser::feedRxLine(char c)
+	{
+		if (c == '[')
+		{
+			//the payload is the last [...] on the line - start again if there is another
+			m_bInPayload = true;
+			m_bPayloadDone = false;
+			m_bOverflow = false;
+			m_nNibble = -1;
+			m_nPayload = 0;
+			return;
+		}
+		if (!m_bInPayload)
+		{
+			return;
+		}
+		if (c == ']')
+		{
+			m_bInPayload = false;
+			m_bPayloadDone = true;
+			return;
+		}
+
+		//two hex digits make a byte - anything else (normally a space) separates bytes
+		int value = hexValue(c);
+		if (value < 0)
+		{
+			m_nNibble = -1;
+		}
+		else if (m_nNibble < 0)
+		{
+			m_nNibble = value;
+		}
+		else
+		{
+			if (m_nPayload < MAX_PAYLOAD_LENGTH + 1)
+			{
+				m_Payload[m_nPayload++] = (char)((m_nNibble << 4) | value);
+			}
+			else
+			{
+				m_bOverflow = true;
+			}
+			m_nNibble = -1;
+		}
+	}
+
+	void ShieldFrameParser::feedNetinfo(char c)
+	{
+		if (m_nNetinfoMatch < NETINFO_SIZE)
+		{
+			if (c == NETINFO[m_nNetinfoMatch])
+			{
+				m_nNetinfoMatch++;
+			}
+			else
+			{
+				m_nNetinfoMatch = (c == NETINFO[0]) ? 1 : 0;
+			}
+			m_nNetInfo = 0;
+		}
+		else if (m_nNetInfo < NETINFO_LENGTH)
+		{
+			m_NetInfo[m_nNetInfo++] = c;
+		}
+	}
+
+	bool ShieldFrameParser::parseNetinfo()
+	{
+		//EUI64 (16 hex digits), ',', node ID (4), ',', network state (2)
+		if ((m_nNetInfo < NETINFO_LENGTH) || (m_NetInfo[16] != ',') || (m_NetInfo[21] != ','))
+		{
+			return false;
+		}
+
+		int bytes[11];
+		const byte offsets[11] = { 0, 2, 4, 6, 8, 10, 12, 14, 17, 19, 22 };
+		for (byte i = 0; i < 11; i++)
+		{
+			bytes[i] = hexByte(m_NetInfo + offsets[i]);
+			if (bytes[i] < 0)
+			{
+				return false;
+			}
+		}
+
+		for (byte i = 0; i < 8; i++)
+		{
+			m_Eui64[7 - i] = bytes[i];
+		}
+		m_nNodeID = (bytes[8] << 8) | bytes[9];
+		m_nNetworkState = bytes[10];
+		return true;
+	}
+
+	ShieldFrameParser::Frame_t ShieldFrameParser::endLine()
+	{
+		Frame_t frame = FRAME_NONE;
+
+		//a message from the hub always starts with 0A, which is not part of it
+		if (m_bRxLine && m_bPayloadDone && (m_nPayload > 1) && (m_Payload[0] == 0x0A))
+		{
+			m_Payload[m_nPayload] = 0;
+			frame = FRAME_PAYLOAD;
+		}
+		else if ((m_nNetinfoMatch == NETINFO_SIZE) && parseNetinfo())
+		{
+			frame = FRAME_NETINFO;
+		}
+
+		bool overflow = m_bOverflow;
+		byte length = m_nPayload;
+		startLine();
+
+		//the payload stays readable until the next byte is fed
+		m_bOverflow = overflow;
+		m_nPayload = (frame == FRAME_PAYLOAD) ? length : 0;
+		return frame;
+	}
+
+//public
+	ShieldFrameParser::ShieldFrameParser() :
+		m_nNodeID(0),
+		m_nNetworkState(0)
+	{
+		memset(m_Eui64, 0, sizeof(m_Eui64));
+		m_Payload[1] = 0;
+		startLine();
+	}
+
+	ShieldFrameParser::Frame_t ShieldFrameParser::feed(char c)
+	{
+		if ((c == '\r') || (c == '\n'))
+		{
+			return (m_nColumn > 0) ? endLine() : FRAME_NONE;
+		}
+
+		if (m_nColumn < RX_PREFIX_SIZE)
+		{
+			if ((RX_PREFIX[m_nColumn] != '?') && (RX_PREFIX[m_nColumn] != c))
+			{
+				m_bRxLine = false;
+			}
+		}
+		if (m_nColumn < 255)
+		{
+			m_nColumn++;
+		}
+
+		if (m_bRxLine && (m_nColumn > RX_PREFIX_SIZE))
+		{
+			feedRxLine(c);
+		}
+		else
+		{
+			feedNetinfo(c);
+		}
+		return FRAME_NONE;
+	}
+}
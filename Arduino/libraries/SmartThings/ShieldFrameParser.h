@@ -0,0 +1,104 @@
+//*******************************************************************************
+//	SmartThings Arduino Library - ThingShield Frame Parser
+//
+//	Summary:  st::ShieldFrameParser reads the lines the ThingShield prints on its
+//			  serial port, one byte at a time, as they are taken out of the serial
+//			  driver's receive buffer.  Two kinds of line are understood:
+//
+//			  T00000000:RX ... [0A 73 77 69 74 63 68 31 20 6F 6E]
+//				  a message from the hub - the hex bytes between the brackets are
+//				  decoded as they arrive ("switch1 on"), the leading 0A is dropped
+//			  netinfo:0022A3000000B675,E30E,02
+//				  the reply to "custom netinfo" - EUI64, node ID and network state
+//
+//			  Any other line is ignored.  Only the decoded payload is kept, so no
+//			  buffer for the whole line is needed.
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  a00889920      Created to replace the line buffer and translatePayload() of SmartThingsThingShield
+//*******************************************************************************
+#ifndef __SHIELDFRAMEPARSER_H__
+#define __SHIELDFRAMEPARSER_H__
+
+#include <Arduino.h>
+
+namespace st
+{
+	class ShieldFrameParser
+	{
+	public:
+		//longest message kept - longer messages are truncated (and reported by overflowed())
+		static const byte MAX_PAYLOAD_LENGTH = 80;
+
+		typedef enum
+		{
+			FRAME_NONE,			//nothing complete yet, or a line that is ignored
+			FRAME_PAYLOAD,		//a message from the hub - see payload()
+			FRAME_NETINFO		//network information - see eui64(), nodeID() and networkState()
+		} Frame_t;
+
+	private:
+		static const byte NETINFO_LENGTH = 24;	//"0022A3000000B675,E30E,02"
+
+		byte m_nColumn;				//characters so far on the current line (stops counting at 255)
+		bool m_bRxLine;				//the line so far matches "T????????:RX"
+		bool m_bInPayload;			//between '[' and ']'
+		bool m_bPayloadDone;		//']' seen
+		bool m_bOverflow;
+		int8_t m_nNibble;			//first hex digit of a byte, -1 if none
+		char m_Payload[MAX_PAYLOAD_LENGTH + 2];	//the leading 0A, the message, and a terminating null
+		byte m_nPayload;
+
+		byte m_nNetinfoMatch;		//characters of "netinfo:" matched, NETINFO_LENGTH more are then kept
+		char m_NetInfo[NETINFO_LENGTH];
+		byte m_nNetInfo;
+
+		uint8_t m_Eui64[8];
+		uint16_t m_nNodeID;
+		uint8_t m_nNetworkState;
+
+		void startLine();
+		void feedRxLine(char c);
+		void feedNetinfo(char c);
+		Frame_t endLine();
+		bool parseNetinfo();
+		static int hexValue(char c);
+		static int hexByte(const char *p);
+
+	public:
+		ShieldFrameParser();
+
+		//*******************************************************************************
+		/// Forgets any partly parsed line
+		//*******************************************************************************
+		void reset() { startLine(); }
+
+		//*******************************************************************************
+		/// Parses one byte.  Returns what the line it completes carried - the payload or
+		/// network information is then valid until the next call to feed() or reset().
+		//*******************************************************************************
+		Frame_t feed(char c);
+
+		//*******************************************************************************
+		/// The decoded message (null terminated)
+		//*******************************************************************************
+		const char *payload() const { return m_Payload + 1; }
+		byte payloadLength() const { return m_nPayload ? m_nPayload - 1 : 0; }
+
+		//*******************************************************************************
+		/// true if the message was longer than MAX_PAYLOAD_LENGTH and was truncated
+		//*******************************************************************************
+		bool overflowed() const { return m_bOverflow; }
+
+		//*******************************************************************************
+		/// Network information from the last FRAME_NETINFO (eui64()[0] is the low byte)
+		//*******************************************************************************
+		const uint8_t *eui64() const { return m_Eui64; }
+		uint16_t nodeID() const { return m_nNodeID; }
+		uint8_t networkState() const { return m_nNetworkState; }
+	};
+}
+#endif
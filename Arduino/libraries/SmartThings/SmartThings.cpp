@@ -6,6 +6,11 @@
 //
 //	History
 //	2017-02-04  Dan Ogorchock  Created
+//  2026-10-16  a00889920      Added send() overload taking a message buffer and length
+//  2026-10-16  a00889920      Added token bucket transmit pacing (transmitInterval = sustained rate, plus a burst size)
+//  2026-10-16  a00889920      Added sendBatch() and setMaxBatchSize() to send several messages in one transmission
+//  2026-10-16  a00889920      Added reportSendResult() for transports that send in the background
+//  2026-10-16  a00889920      Added deliverCommand() for transports that parse requests in place
 //*******************************************************************************
 #include <SmartThings.h>
 
@@ -16,13 +21,131 @@ namespace st
 	//*******************************************************************************
 	SmartThings::SmartThings(SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) :
 		_calloutFunction(callout),
+		_sendCalloutFunction(0),
+		_commandCalloutFunction(0),
 		_shieldType(shieldType),
 		_isDebugEnabled(enableDebug),
-		m_nTransmitInterval(transmitInterval)
+		m_nTransmitInterval(transmitInterval),
+		m_nTransmitBurst(1),
+		m_nTransmitTokens(1),
+		m_lTransmitRefillMillis(0),
+		m_nMaxBatchSize(0)
 	{
 
 	}
 
+	//*******************************************************************************
+	// Token bucket transmit pacing - one token is added every m_nTransmitInterval ms
+	//*******************************************************************************
+	void SmartThings::refillTransmitTokens()
+	{
+		unsigned long now = millis();
+
+		if (m_nTransmitTokens >= m_nTransmitBurst || m_nTransmitInterval <= 0)
+		{
+			m_nTransmitTokens = m_nTransmitBurst;
+			m_lTransmitRefillMillis = now;	//a full bucket does not bank any more credit
+			return;
+		}
+
+		unsigned long tokens = (now - m_lTransmitRefillMillis) / m_nTransmitInterval;
+		if (tokens > 0)
+		{
+			if (tokens >= (unsigned long)(m_nTransmitBurst - m_nTransmitTokens))
+			{
+				m_nTransmitTokens = m_nTransmitBurst;
+				m_lTransmitRefillMillis = now;
+			}
+			else
+			{
+				m_nTransmitTokens += tokens;
+				m_lTransmitRefillMillis += tokens * m_nTransmitInterval;
+			}
+		}
+	}
+
+	void SmartThings::setTransmitBurst(byte burst)
+	{
+		m_nTransmitBurst = (burst > 0) ? burst : 1;
+		if (m_nTransmitTokens > m_nTransmitBurst)
+		{
+			m_nTransmitTokens = m_nTransmitBurst;
+		}
+	}
+
+	unsigned long SmartThings::getTransmitDelay()
+	{
+		refillTransmitTokens();
+		if (m_nTransmitTokens > 0)
+		{
+			return 0;
+		}
+		unsigned long elapsed = millis() - m_lTransmitRefillMillis;
+		return (elapsed < (unsigned long)m_nTransmitInterval) ? m_nTransmitInterval - elapsed : 1;
+	}
+
+	bool SmartThings::acquireTransmitSlot()
+	{
+		refillTransmitTokens();
+		if (m_nTransmitTokens == 0)
+		{
+			return false;
+		}
+		--m_nTransmitTokens;
+		return true;
+	}
+
+	//*******************************************************************************
+	// Default send() of a message buffer - used by transports without a native version
+	//*******************************************************************************
+	void SmartThings::send(const char *message, unsigned int length)
+	{
+		String str;
+		str.reserve(length);
+		for (unsigned int i = 0; i < length; i++)
+		{
+			str += message[i];
+		}
+		send(str);
+	}
+
+	//*******************************************************************************
+	// reportSendResult() - tells the owner of the send callout how a background send ended
+	//*******************************************************************************
+	void SmartThings::reportSendResult(const char *message, unsigned int length, SmartThingsSendResult_t result)
+	{
+		if (_sendCalloutFunction)
+		{
+			_sendCalloutFunction(message, length, result);
+		}
+	}
+
+	//*******************************************************************************
+	// deliverCommand() - hands a command from the hub to the sketch
+	//*******************************************************************************
+	void SmartThings::deliverCommand(const char *command, unsigned int length)
+	{
+		if (_commandCalloutFunction)
+		{
+			_commandCalloutFunction(command, length);
+		}
+		else
+		{
+			_calloutFunction(String(command));
+		}
+	}
+
+	//*******************************************************************************
+	// Default sendBatch() - used by transports that can only send one message at a time
+	//*******************************************************************************
+	void SmartThings::sendBatch(const char * const *messages, const unsigned int *lengths, byte count)
+	{
+		for (byte i = 0; i < count; i++)
+		{
+			send(messages[i], lengths[i]);
+		}
+	}
+
 	//*****************************************************************************
 	//SmartThings::~SmartThings()
 	//*****************************************************************************
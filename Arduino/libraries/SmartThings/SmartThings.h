@@ -7,6 +7,12 @@
 //	History
 //	2017-02-04  Dan Ogorchock  Created
 //  2020-08-22  a00889920      Added deepSleep() function
+//  2026-10-16  a00889920      Added send() overload taking a message buffer and length
+//  2026-10-16  a00889920      Added token bucket transmit pacing (transmitInterval = sustained rate, plus a burst size)
+//  2026-10-16  a00889920      Added sendBatch() and setMaxBatchSize() to send several messages in one transmission
+//  2026-10-16  a00889920      Added a send result callout for transports that send in the background
+//  2026-10-16  a00889920      Added an optional command callout that receives a const char* view instead of a String
+//  2026-10-16  a00889920      Added isReady() for transports whose init() returns before the network is up
 //*******************************************************************************
 #ifndef __SMARTTHINGS_H__ 
 #define __SMARTTHINGS_H__
@@ -18,6 +24,27 @@
 //*******************************************************************************
 typedef void SmartThingsCallout_t(String message);
 
+//*******************************************************************************
+// Send Result Callout Function Definition - called by transports that send in the
+// background, once the hub has accepted a message or the send has failed
+//*******************************************************************************
+typedef enum
+{
+	STSEND_OK,			//the hub replied with a 2xx status
+	STSEND_TIMEOUT,		//no reply from the hub in time
+	STSEND_REFUSED,		//could not connect to the hub, or the hub rejected the message
+	STSEND_OVERFLOW		//no room to queue the message for sending
+} SmartThingsSendResult_t;
+
+typedef void SmartThingsSendCallout_t(const char *message, unsigned int length, SmartThingsSendResult_t result);
+
+//*******************************************************************************
+// Command Callout Function Definition - alternative to SmartThingsCallout_t that
+// receives the command without building a String (command is null terminated and
+// only valid during the call)
+//*******************************************************************************
+typedef void SmartThingsCommandCallout_t(const char *command, unsigned int length);
+
 namespace st
 {
 	class SmartThings
@@ -26,9 +53,28 @@ namespace st
 
 	protected:
 		SmartThingsCallout_t *_calloutFunction;
+		SmartThingsSendCallout_t *_sendCalloutFunction;
+		SmartThingsCommandCallout_t *_commandCalloutFunction;
 		bool _isDebugEnabled;
 		String _shieldType;
 		int m_nTransmitInterval;
+		byte m_nTransmitBurst;					//maximum number of messages that may be sent back to back
+		byte m_nTransmitTokens;					//messages that may be sent right now
+		unsigned long m_lTransmitRefillMillis;	//time the last token was added to m_nTransmitTokens
+		unsigned int m_nMaxBatchSize;			//largest message body sendBatch() may be asked to send (0 = batching disabled)
+
+		void refillTransmitTokens();
+
+		//*******************************************************************************
+		/// Passes the result of a background send to the send result callout, if set
+		//*******************************************************************************
+		void reportSendResult(const char *message, unsigned int length, SmartThingsSendResult_t result);
+
+		//*******************************************************************************
+		/// Passes a command received from the hub to the command callout if one is set,
+		/// otherwise to the callout given to the constructor (as a String)
+		//*******************************************************************************
+		void deliverCommand(const char *command, unsigned int length);
 
 	public:
 
@@ -57,11 +103,69 @@ namespace st
 		//*******************************************************************************
 		virtual void send(String message) = 0; //all derived classes must implement this pure virtual function
 
+		//*******************************************************************************
+		/// Send Message to the Hub - message need not be null terminated
+		///   Default implementation copies the message into a String and calls send(String).
+		///   Derived classes should override this to avoid the temporary String.
+		//*******************************************************************************
+		virtual void send(const char *message, unsigned int length);
+
+		//*******************************************************************************
+		/// Send several Messages to the Hub - sent as one message body, one message per line
+		///   Default implementation sends each message on its own with send().
+		///   Derived classes that can send one body with several lines should override this.
+		//*******************************************************************************
+		virtual void sendBatch(const char * const *messages, const unsigned int *lengths, byte count);
+
+		//*******************************************************************************
+		/// Sets the largest body (bytes, including the newlines between messages) that may be
+		/// sent with sendBatch().  0 (default) disables batching.  The hub's parent device
+		/// handler must understand multi-line messages before batching is enabled.
+		//*******************************************************************************
+		void setMaxBatchSize(unsigned int size) { m_nMaxBatchSize = size; }
+		unsigned int getMaxBatchSize() const { return m_nMaxBatchSize; }
+
+		//*******************************************************************************
+		/// Sets the function called with the result of each message sent in the background.
+		/// Transports that send before send() returns never call it.
+		//*******************************************************************************
+		void setSendCallout(SmartThingsSendCallout_t *callout) { _sendCalloutFunction = callout; }
+
+		//*******************************************************************************
+		/// Sets a function to receive commands from the hub as a const char* view, in place
+		/// of the String callout given to the constructor.  Only transports that parse
+		/// requests in place (ESP8266, ESP32, WiFiNINA, WiFi101, ThingShield) use it.
+		//*******************************************************************************
+		void setCommandCallout(SmartThingsCommandCallout_t *callout) { _commandCalloutFunction = callout; }
+
 		//*******************************************************************************
 		/// Send Message to the Hub 
 		//*******************************************************************************
 		virtual int getTransmitInterval() const { return m_nTransmitInterval; }
 
+		//*******************************************************************************
+		/// Sets the number of messages that may be sent back to back before pacing to
+		/// one message per transmitInterval kicks in (default 1)
+		//*******************************************************************************
+		void setTransmitBurst(byte burst);
+		byte getTransmitBurst() const { return m_nTransmitBurst; }
+
+		//*******************************************************************************
+		/// Returns the number of milliseconds until the next message may be sent (0 = now)
+		//*******************************************************************************
+		unsigned long getTransmitDelay();
+
+		//*******************************************************************************
+		/// Takes one transmit slot if available.  Returns false if the caller must wait.
+		//*******************************************************************************
+		bool acquireTransmitSlot();
+
+		//*******************************************************************************
+		/// False while the transport is still bringing up its network connection after
+		/// init() - messages are best kept by the caller until then.  Default: true.
+		//*******************************************************************************
+		virtual bool isReady() { return true; }
+
 		//*******************************************************************************
 		/// Puts device into Deepsleep 
 		//*******************************************************************************
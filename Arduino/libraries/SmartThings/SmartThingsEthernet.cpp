@@ -6,6 +6,19 @@
 //
 //	History
 //	2017-02-04  Dan Ogorchock  Created
+//  2026-10-16  a00889920      Added postMessage() so all transports share one HTTP POST routine
+//  2026-10-16  a00889920      postMessage() became postMessages(), which can POST several messages as one multi-line body
+//  2026-10-16  a00889920      Added optional HTTP keep-alive - postToHub(), releaseConnection() and checkConnection()
+//  2026-10-16  a00889920      Added serviceRequest() - incremental parsing of the hub's requests with st::HttpRequestParser
+//  2026-10-16  a00889920      Added sendDatagrams() and serviceDatagrams() for the optional st::DatagramLink
+//  2026-10-16  a00889920      Added holdForJournal(), journalFailed() and replayJournal() for the optional st::EventJournal
+//  2026-10-16  a00889920      Shared retry queue with exponential backoff and a circuit breaker - retryLater() and serviceRetries()
+//                             replace the transports' "resend missed data" blocks, and absorb the journal functions
+//  2026-10-16  a00889920      Added setRetryQueue() - the retry queue's buffer is supplied by the sketch
+//  2026-10-16  a00889920      Without a retry queue or journal, a failed message is resent once straight away (sendAgain()),
+//                             and new messages still try the hub while the circuit breaker is open
+//  2026-10-16  a00889920      queueRetry() writes the retry header straight into the retry queue, and the journal's replay
+//                             buffer moved to resendJournalFront() - neither is on the stack of an ordinary send
 //*******************************************************************************
 
 #include "SmartThingsEthernet.h"
@@ -24,8 +37,32 @@ namespace st
 		st_hubIP(hubIP),
 		st_serverPort(serverPort),
 		st_hubPort(hubPort),
-		st_DHCP(DHCP)
+		st_DHCP(DHCP),
+		m_bKeepAlive(false),
+		m_lKeepAliveTimeout(5000),
+		m_lLastPostMillis(0),
+		m_bConnectionOpen(false),
+		m_pDatagramLink(0),
+		m_pJournal(0),
+		m_lReplayInterval(200),
+		m_RetryQueue(0, 0),
+		m_nFrontTries(0),
+		m_nJournalRefusals(0),
+		m_nRetryBudget(5),
+		m_lBackoffBase(1000),
+		m_lBackoffMax(60000),
+		m_nHubFailures(0),
+		m_lHubFailedMillis(0),
+		m_lHubBackoff(0),
+		m_lLastResendMillis(0),
+		m_lResendWait(0),
+		m_bResending(false),
+		m_bResendFailed(false),
+		m_bResendDeferred(false),
+		m_bResendFromJournal(false),
+		m_bSendingAgain(false)
 	{
+		memset(&m_RetryStats, 0, sizeof(m_RetryStats));
 
 	}
 
@@ -38,8 +75,32 @@ namespace st
 		st_hubIP(hubIP),
 		st_serverPort(serverPort),
 		st_hubPort(hubPort),
-		st_DHCP(DHCP)
+		st_DHCP(DHCP),
+		m_bKeepAlive(false),
+		m_lKeepAliveTimeout(5000),
+		m_lLastPostMillis(0),
+		m_bConnectionOpen(false),
+		m_pDatagramLink(0),
+		m_pJournal(0),
+		m_lReplayInterval(200),
+		m_RetryQueue(0, 0),
+		m_nFrontTries(0),
+		m_nJournalRefusals(0),
+		m_nRetryBudget(5),
+		m_lBackoffBase(1000),
+		m_lBackoffMax(60000),
+		m_nHubFailures(0),
+		m_lHubFailedMillis(0),
+		m_lHubBackoff(0),
+		m_lLastResendMillis(0),
+		m_lResendWait(0),
+		m_bResending(false),
+		m_bResendFailed(false),
+		m_bResendDeferred(false),
+		m_bResendFromJournal(false),
+		m_bSendingAgain(false)
 	{
+		memset(&m_RetryStats, 0, sizeof(m_RetryStats));
 
 	}
 
@@ -51,11 +112,673 @@ namespace st
 		st_hubIP(hubIP),
 		st_serverPort(serverPort),
 		st_hubPort(hubPort),
-		st_DHCP(DHCP)
+		st_DHCP(DHCP),
+		m_bKeepAlive(false),
+		m_lKeepAliveTimeout(5000),
+		m_lLastPostMillis(0),
+		m_bConnectionOpen(false),
+		m_pDatagramLink(0),
+		m_pJournal(0),
+		m_lReplayInterval(200),
+		m_RetryQueue(0, 0),
+		m_nFrontTries(0),
+		m_nJournalRefusals(0),
+		m_nRetryBudget(5),
+		m_lBackoffBase(1000),
+		m_lBackoffMax(60000),
+		m_nHubFailures(0),
+		m_lHubFailedMillis(0),
+		m_lHubBackoff(0),
+		m_lLastResendMillis(0),
+		m_lResendWait(0),
+		m_bResending(false),
+		m_bResendFailed(false),
+		m_bResendDeferred(false),
+		m_bResendFromJournal(false),
+		m_bSendingAgain(false)
 	{
+		memset(&m_RetryStats, 0, sizeof(m_RetryStats));
 
 	}
 
+	//*******************************************************************************
+	// postMessages() - HTTP POST of one or more message buffers to the hub, one per line
+	//*******************************************************************************
+	bool SmartThingsEthernet::postMessages(Client &client, const char * const *messages, const unsigned int *lengths, byte count, bool closeConnection)
+	{
+		size_t written = 0;
+		size_t expected = 0;
+
+		unsigned int length = (count > 0) ? count - 1 : 0;	//newlines between the messages
+		for (byte i = 0; i < count; i++)
+		{
+			length += lengths[i];
+		}
+
+		client.println(F("POST / HTTP/1.1"));
+		client.print(F("HOST: "));
+		client.print(st_hubIP);
+		client.print(F(":"));
+		client.println(st_hubPort);
+		client.println(F("CONTENT-TYPE: text"));
+		if (closeConnection && !m_bKeepAlive)
+		{
+			client.println(F("CONNECTION: CLOSE"));
+		}
+		client.print(F("CONTENT-LENGTH: "));
+		client.println(length);
+		client.println();
+		for (byte i = 0; i < count; i++)
+		{
+			if (i > 0)
+			{
+				written += client.write('\n');
+				++expected;
+			}
+			written += client.write((const uint8_t *)messages[i], lengths[i]);
+			expected += lengths[i];
+		}
+		written += client.println();
+		expected += 2;
+
+		//writes to a socket the hub has closed fail
+		return written == expected;
+	}
+
+	//*******************************************************************************
+	// drainResponse() - discards whatever the hub has sent back so far (replies are not used)
+	//*******************************************************************************
+	void SmartThingsEthernet::drainResponse(Client &client)
+	{
+		while (client.available())
+		{
+			client.read();
+		}
+	}
+
+	//*******************************************************************************
+	// postToHub() - POST on the kept-alive connection if it is still open, else on a new one
+	//*******************************************************************************
+	bool SmartThingsEthernet::postToHub(Client &client, const char * const *messages, const unsigned int *lengths, byte count, bool closeConnection)
+	{
+		bool reused = false;
+
+		if (m_bKeepAlive)
+		{
+			//the previous reply is read here rather than waited for after the POST; once it has been read, a
+			//connection the hub has half-closed reports connected() == false
+			drainResponse(client);
+			reused = m_bConnectionOpen && client.connected() && (millis() - m_lLastPostMillis < m_lKeepAliveTimeout);
+		}
+
+		if (!reused)
+		{
+			//Make sure the client is stopped, to free up socket for new connection
+			client.stop();
+			if (!client.connect(st_hubIP, st_hubPort))
+			{
+				hubFailed();
+				return false;
+			}
+		}
+
+		m_lLastPostMillis = millis();
+		if (postMessages(client, messages, lengths, count, closeConnection))
+		{
+			hubReached();
+			return true;
+		}
+		if (!reused)
+		{
+			//the hub accepted the connection but the request could not be written - not delivered
+			client.stop();
+			hubFailed();
+			return false;
+		}
+
+		//the hub closed the kept-alive connection after it was checked above - send it again on a new connection
+		if (_isDebugEnabled)
+		{
+			Serial.println(F("SmartThings.send() - kept-alive connection was closed by the hub, reconnecting"));
+		}
+		client.stop();
+		bool sent = client.connect(st_hubIP, st_hubPort) && postMessages(client, messages, lengths, count, closeConnection);
+		if (sent)
+		{
+			hubReached();
+		}
+		else
+		{
+			hubFailed();
+		}
+		return sent;
+	}
+
+	//*******************************************************************************
+	// releaseConnection() - end of a send
+	//*******************************************************************************
+	void SmartThingsEthernet::releaseConnection(Client &client)
+	{
+		// read any data returned from the POST
+		drainResponse(client);
+
+		m_bConnectionOpen = m_bKeepAlive && client.connected();
+		if (!m_bConnectionOpen)
+		{
+			delay(1);
+			client.stop();
+		}
+	}
+
+	//*******************************************************************************
+	// checkConnection() - closes an idle or half-closed kept-alive connection
+	//*******************************************************************************
+	void SmartThingsEthernet::checkConnection(Client &client)
+	{
+		if (!m_bConnectionOpen)
+		{
+			return;
+		}
+
+		drainResponse(client);
+		if (!client.connected() || (millis() - m_lLastPostMillis >= m_lKeepAliveTimeout))
+		{
+			//idle too long, or the hub closed its end - release the socket now rather than on the next send
+			client.stop();
+			m_bConnectionOpen = false;
+		}
+	}
+
+	//*******************************************************************************
+	// sendDatagrams() - hands the messages to the datagram link, if one is set
+	//*******************************************************************************
+	bool SmartThingsEthernet::sendDatagrams(const char * const *messages, const unsigned int *lengths, byte count)
+	{
+		if (!m_pDatagramLink)
+		{
+			return false;
+		}
+
+		if (!m_pDatagramLink->isStarted())
+		{
+			m_pDatagramLink->begin(st_hubIP, st_hubPort, st_serverPort);	//the hub's acknowledgements come back to the server's port number
+		}
+		m_pDatagramLink->send(messages, lengths, count, _sendCalloutFunction);
+		return true;
+	}
+
+	//*******************************************************************************
+	// serviceDatagrams() - moves the datagram link along, if one is set
+	//*******************************************************************************
+	void SmartThingsEthernet::serviceDatagrams()
+	{
+		if (m_pDatagramLink)
+		{
+			m_pDatagramLink->run(_sendCalloutFunction);
+		}
+	}
+
+	//*******************************************************************************
+	// hubReached() - the hub accepted a connection - closes the circuit breaker
+	//*******************************************************************************
+	void SmartThingsEthernet::hubReached()
+	{
+		if ((m_nHubFailures >= BREAKER_THRESHOLD) && _isDebugEnabled)
+		{
+			Serial.println(F("SmartThings.send() - hub reachable again"));
+		}
+		m_nHubFailures = 0;
+		m_lHubBackoff = 0;
+	}
+
+	//*******************************************************************************
+	// hubFailed() - the hub could not be reached - backs off, and opens the circuit breaker after several failures in a row
+	//*******************************************************************************
+	void SmartThingsEthernet::hubFailed()
+	{
+		if (m_nHubFailures < 255)
+		{
+			++m_nHubFailures;
+		}
+		if (m_nHubFailures == BREAKER_THRESHOLD)
+		{
+			++m_RetryStats.breakerTrips;
+			if (_isDebugEnabled)
+			{
+				Serial.println(F("SmartThings.send() - hub unreachable, pausing connection attempts"));
+			}
+		}
+
+		//equal jitter - boards that lost the hub at the same time do not all come back at the same moment
+		unsigned long backoffMs = backoffDelay(m_nHubFailures);
+		m_lHubBackoff = backoffMs / 2 + random(backoffMs / 2 + 1);
+		m_lHubFailedMillis = millis();
+	}
+
+	//*******************************************************************************
+	// hubBlocked() - true while backing off after a failure to reach the hub
+	//*******************************************************************************
+	bool SmartThingsEthernet::hubBlocked() const
+	{
+		return (m_nHubFailures > 0) && (millis() - m_lHubFailedMillis < m_lHubBackoff);
+	}
+
+	//*******************************************************************************
+	// backoffDelay() - base delay doubled for each attempt after the first, up to the maximum
+	//*******************************************************************************
+	unsigned long SmartThingsEthernet::backoffDelay(byte attempts) const
+	{
+		unsigned long backoffMs = m_lBackoffBase;
+		for (byte i = 1; (i < attempts) && (backoffMs < m_lBackoffMax); i++)
+		{
+			backoffMs <<= 1;
+		}
+		return (backoffMs < m_lBackoffMax) ? backoffMs : m_lBackoffMax;
+	}
+
+	//*******************************************************************************
+	// loadFrontTries() - attempts already made at the message now at the front of the retry queue
+	//*******************************************************************************
+	void SmartThingsEthernet::loadFrontTries()
+	{
+		const char *record;
+		unsigned int length;
+
+		m_nFrontTries = m_RetryQueue.front(record, length) ? (byte)record[0] : 0;
+	}
+
+	//*******************************************************************************
+	// setRetryQueue() - gives the retry queue its storage, discarding anything waiting in the old one
+	//*******************************************************************************
+	void SmartThingsEthernet::setRetryQueue(byte *buffer, unsigned int size)
+	{
+		m_RetryQueue = MessageQueue(buffer, buffer ? size : 0);
+		m_nFrontTries = 0;
+	}
+
+	//*******************************************************************************
+	// queueRetry() - adds a message to the retry queue, making room if it is full
+	//*******************************************************************************
+	void SmartThingsEthernet::queueRetry(const char *message, unsigned int length, byte tries)
+	{
+		char header[RETRY_HEADER_SIZE];		//[tries][first failure millis] - written in front of the message, not copied with it
+		uint32_t now = millis();
+
+		++m_RetryStats.queued;
+		if (length > EventJournal::MAX_MESSAGE_LENGTH)
+		{
+			if (!m_pJournal || !m_pJournal->append(message, length))
+			{
+				++m_RetryStats.dropped;
+				reportSendResult(message, length, STSEND_OVERFLOW);
+			}
+			return;
+		}
+		header[0] = tries;
+		memcpy(header + 1, &now, 4);
+
+		for (;;)
+		{
+			bool wasEmpty = m_RetryQueue.isEmpty();
+			if (m_RetryQueue.push(header, RETRY_HEADER_SIZE, message, length))
+			{
+				if (wasEmpty)
+				{
+					m_nFrontTries = tries;
+				}
+				return;
+			}
+
+			const char *oldest;
+			unsigned int oldestLength;
+			if (!m_RetryQueue.front(oldest, oldestLength))
+			{
+				//larger than the whole queue, or there is no retry queue - the journal is served after it, so order is kept
+				if (!m_pJournal || !m_pJournal->append(message, length))
+				{
+					++m_RetryStats.dropped;
+					reportSendResult(message, length, STSEND_OVERFLOW);
+				}
+				return;
+			}
+			if (m_pJournal)
+			{
+				//nothing is lost - the journal takes the lot, in order, and the new message goes in behind them
+				spillToJournal();
+				if (!m_pJournal->append(message, length))
+				{
+					++m_RetryStats.dropped;
+					reportSendResult(message, length, STSEND_OVERFLOW);
+				}
+				return;
+			}
+			else
+			{
+				++m_RetryStats.dropped;		//the oldest message makes way for the newest
+				reportSendResult(oldest + RETRY_HEADER_SIZE, oldestLength - RETRY_HEADER_SIZE, STSEND_OVERFLOW);
+				m_RetryQueue.pop();
+				loadFrontTries();
+			}
+		}
+	}
+
+	//*******************************************************************************
+	// spillToJournal() - moves every message in the retry queue to the end of the journal
+	//*******************************************************************************
+	void SmartThingsEthernet::spillToJournal()
+	{
+		const char *record;
+		unsigned int length;
+
+		while (m_RetryQueue.front(record, length))
+		{
+			//stamped with when it first failed, so the age sent with it on replay covers its time in the retry queue too
+			uint32_t firstFailed;
+			memcpy(&firstFailed, record + 1, 4);
+			if (!m_pJournal->append(record + RETRY_HEADER_SIZE, length - RETRY_HEADER_SIZE, firstFailed))
+			{
+				++m_RetryStats.dropped;
+				reportSendResult(record + RETRY_HEADER_SIZE, length - RETRY_HEADER_SIZE, STSEND_OVERFLOW);
+			}
+			m_RetryQueue.pop();
+		}
+		m_nFrontTries = 0;
+	}
+
+	//*******************************************************************************
+	// giveUpFront() - the message at the front of the retry queue has used its retry budget
+	//*******************************************************************************
+	void SmartThingsEthernet::giveUpFront()
+	{
+		const char *record;
+		unsigned int length;
+
+		++m_RetryStats.givenUp;
+		if (m_pJournal)
+		{
+			spillToJournal();	//the hub has been away for a while - keep everything for later, in order
+			return;
+		}
+
+		if (m_RetryQueue.front(record, length))
+		{
+			if (_isDebugEnabled)
+			{
+				Serial.println(F("SmartThings.send() - retries used up, message dropped"));
+			}
+			reportSendResult(record + RETRY_HEADER_SIZE, length - RETRY_HEADER_SIZE, STSEND_TIMEOUT);
+			m_RetryQueue.pop();
+			loadFrontTries();
+		}
+	}
+
+	//*******************************************************************************
+	// holdMessages() - keeps new messages behind the ones already waiting to be resent
+	//*******************************************************************************
+	bool SmartThingsEthernet::holdMessages(const char * const *messages, const unsigned int *lengths, byte count)
+	{
+		if (m_bResending || m_bSendingAgain)
+		{
+			return false;
+		}
+
+		if (m_pJournal && (!m_pJournal->isEmpty() || (m_bResendDeferred && m_bResendFromJournal)))
+		{
+			for (byte i = 0; i < count; i++)
+			{
+				if (!m_pJournal->append(messages[i], lengths[i]))
+				{
+					reportSendResult(messages[i], lengths[i], STSEND_OVERFLOW);
+				}
+			}
+			return true;
+		}
+
+		//with nowhere to keep them, new messages still try the hub - holding them would only drop them
+		bool breakerOpen = (m_nHubFailures >= BREAKER_THRESHOLD) && hubBlocked() && canKeepMessages();
+		if (!m_RetryQueue.isEmpty() || m_bResendDeferred || breakerOpen)
+		{
+			for (byte i = 0; i < count; i++)
+			{
+				queueRetry(messages[i], lengths[i], 0);
+			}
+			return true;
+		}
+		return false;
+	}
+
+	//*******************************************************************************
+	// retryLater() - queues messages that could not be sent, to be retried from run()
+	//*******************************************************************************
+	void SmartThingsEthernet::retryLater(const char * const *messages, const unsigned int *lengths, byte count)
+	{
+		if (m_bResending)
+		{
+			m_bResendFailed = true;		//still at the front of its queue - tried again later
+			return;
+		}
+
+		if (_isDebugEnabled)
+		{
+			Serial.println(F("SmartThings.send() - message queued to be retried"));
+		}
+		for (byte i = 0; i < count; i++)
+		{
+			if ((m_nRetryBudget > 1) && (m_RetryQueue.capacity() > 0))
+			{
+				queueRetry(messages[i], lengths[i], 1);
+			}
+			else if (m_pJournal)
+			{
+				if (!m_pJournal->append(messages[i], lengths[i]))
+				{
+					++m_RetryStats.dropped;
+					reportSendResult(messages[i], lengths[i], STSEND_OVERFLOW);
+				}
+			}
+			else if ((m_nRetryBudget > 1) && !m_bSendingAgain)
+			{
+				sendAgain(messages[i], lengths[i]);		//no setRetryQueue() - nowhere to keep it for later
+			}
+			else
+			{
+				++m_RetryStats.givenUp;		//setRetryPolicy(1), or the second attempt failed too
+				reportSendResult(messages[i], lengths[i], STSEND_TIMEOUT);
+			}
+		}
+	}
+
+	//*******************************************************************************
+	// sendAgain() - one more attempt straight away, for a message there is nowhere to keep
+	//*******************************************************************************
+	void SmartThingsEthernet::sendAgain(const char *message, unsigned int length)
+	{
+		if (_isDebugEnabled)
+		{
+			Serial.println(F("SmartThings.send() - attempting to resend missed data"));
+		}
+		++m_RetryStats.resent;
+		m_bSendingAgain = true;
+		sendBatch(&message, &length, 1);	//if this fails too, retryLater() gives up on it
+		m_bSendingAgain = false;
+	}
+
+	//*******************************************************************************
+	// serviceRetries() - resends the oldest waiting message, from the retry queue or the journal
+	//*******************************************************************************
+	void SmartThingsEthernet::serviceRetries()
+	{
+		const char *message;
+		unsigned int length;
+
+		if (m_bResending || m_bResendDeferred || hubBlocked() || (millis() - m_lLastResendMillis < m_lResendWait) || !readyToResend())
+		{
+			return;
+		}
+
+		if (m_RetryQueue.front(message, length))
+		{
+			resend(message + RETRY_HEADER_SIZE, length - RETRY_HEADER_SIZE, false);
+			return;
+		}
+
+		if (m_pJournal)
+		{
+			resendJournalFront();
+		}
+	}
+
+	//*******************************************************************************
+	// resendJournalFront() - resends the oldest message in the journal, with its age
+	//*******************************************************************************
+	void SmartThingsEthernet::resendJournalFront()
+	{
+		const char *message;
+		unsigned int length;
+		unsigned long capturedMillis;
+		bool thisBoot;
+		if (!m_pJournal->front(message, length, capturedMillis, thisBoot))
+		{
+			return;
+		}
+
+		//the value is followed by how long ago it was captured - millis() from before a reset means nothing now
+		char text[EventJournal::MAX_MESSAGE_LENGTH + 16];
+		memcpy(text, message, length);
+		if (thisBoot)
+		{
+			length += snprintf(text + length, 16, " age=%lu", (millis() - capturedMillis) / 1000);
+		}
+		resend(text, length, true);
+	}
+
+	//*******************************************************************************
+	// resend() - sends one waiting message through the transport's sendBatch()
+	//*******************************************************************************
+	void SmartThingsEthernet::resend(const char *message, unsigned int length, bool fromJournal)
+	{
+		m_lLastResendMillis = millis();
+		m_bResendFromJournal = fromJournal;
+		++m_RetryStats.resent;
+
+		m_bResending = true;
+		m_bResendFailed = false;
+		sendBatch(&message, &length, 1);
+		m_bResending = false;
+
+		if (!m_bResendDeferred)
+		{
+			resendFinished(!m_bResendFailed);
+		}
+	}
+
+	//*******************************************************************************
+	// resendFinished() - removes the message once it has been delivered, else counts the attempt against its budget
+	//*******************************************************************************
+	void SmartThingsEthernet::resendFinished(bool delivered)
+	{
+		m_bResendDeferred = false;
+		if (m_bResending)
+		{
+			m_bResendFailed = m_bResendFailed || !delivered;	//finished within sendBatch() - resend() takes it from here
+			return;
+		}
+
+		if (delivered)
+		{
+			m_lResendWait = m_lReplayInterval;
+			if (m_bResendFromJournal)
+			{
+				m_nJournalRefusals = 0;
+				if (m_pJournal)
+				{
+					m_pJournal->pop();
+				}
+			}
+			else
+			{
+				++m_RetryStats.recovered;
+				m_RetryQueue.pop();
+				loadFrontTries();
+			}
+			return;
+		}
+
+		//an unreachable hub is waited out by hubBlocked() - this per-message backoff covers a hub that answers but refuses
+		bool refused = !hubBlocked();
+		if (m_bResendFromJournal)
+		{
+			//the journal keeps a message for as long as the hub is away, but not one the hub keeps refusing
+			if (refused && (++m_nJournalRefusals >= m_nRetryBudget) && m_pJournal)
+			{
+				++m_RetryStats.givenUp;
+				m_pJournal->pop();
+				m_nJournalRefusals = 0;
+			}
+			m_lResendWait = refused ? backoffDelay(m_nJournalRefusals) : 0;
+			return;
+		}
+
+		if (m_nFrontTries < 255)
+		{
+			++m_nFrontTries;
+		}
+		m_lResendWait = refused ? backoffDelay(m_nFrontTries) : 0;
+		if (m_nFrontTries >= m_nRetryBudget)
+		{
+			giveUpFront();
+		}
+	}
+
+	//*******************************************************************************
+	// serviceRequest() - reads, answers and delivers the hub's requests on one connection
+	//*******************************************************************************
+	bool SmartThingsEthernet::serviceRequest(Client &client, InboundRequest &request)
+	{
+		for (unsigned int n = 0; (n < INBOUND_READ_LIMIT) && client.available(); n++)
+		{
+			request.lastMillis = millis();
+			if (!request.parser.feed(client.read()))
+			{
+				continue;
+			}
+
+			request.answered = true;
+			if (request.parser.commandLength() > 0)
+			{
+				client.print(F("HTTP/1.1 200 OK\r\nCONTENT-LENGTH: 0\r\n\r\n"));
+
+				if (_isDebugEnabled)
+				{
+					Serial.print(F("Handling request from ST. command = "));
+					Serial.println(request.parser.command());
+					if (request.parser.overflowed())
+					{
+						Serial.println(F("SmartThings.run() - command truncated"));
+					}
+				}
+				//Pass the message to user's SmartThings callout function
+				deliverCommand(request.parser.command(), request.parser.commandLength());
+			}
+			else
+			{
+				client.print(F("HTTP/1.1 204 No Content\r\nCONTENT-LENGTH: 0\r\n\r\n"));
+				if (_isDebugEnabled)
+				{
+					Serial.println(F("No Valid Data Received"));
+				}
+			}
+		}
+
+		if (client.available())
+		{
+			return false;	//more to read on the next pass
+		}
+
+		//the hub waits for the connection to close after each reply, unless it pipelined another request behind it
+		return (request.answered && request.parser.isIdle()) || !client.connected() || (millis() - request.lastMillis >= INBOUND_TIMEOUT);
+	}
+
 	//*****************************************************************************
 	//SmartThingsEthernet::~SmartThingsEthernet()
 	//*****************************************************************************
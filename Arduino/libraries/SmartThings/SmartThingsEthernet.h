@@ -10,12 +10,27 @@
 //  2018-01-06  Dan Ogorchock  Added RSSI Interval as user-definable interval
 //  2020-07-26  Dan Ogorchock  Changed the final RSSI interval from 60 seconds to 900 seconds
 //  2020-08-22  a00889920      Added deepSleep() function
+//  2026-10-16  a00889920      Added postMessage() so all transports share one HTTP POST routine
+//  2026-10-16  a00889920      postMessage() became postMessages(), which can POST several messages as one multi-line body
+//  2026-10-16  a00889920      Added optional HTTP keep-alive - postToHub() reuses the connection to the hub between sends
+//  2026-10-16  a00889920      Added serviceInbound() - non-blocking handling of several hub connections with st::HttpRequestParser
+//  2026-10-16  a00889920      Added setDatagramLink() - optionally send to the hub as acknowledged UDP datagrams (st::DatagramLink)
+//  2026-10-16  a00889920      Added setJournal() - messages that cannot be sent are kept in an st::EventJournal and sent later
+//  2026-10-16  a00889920      Added a shared retry queue with exponential backoff and a circuit breaker (setRetryPolicy, getRetryStats)
+//  2026-10-16  a00889920      The retry queue's buffer is supplied by the sketch (setRetryQueue) - none by default
+//  2026-10-16  a00889920      Retry records carry the millis() of the first failure, passed on to the journal
+//  2026-10-16  a00889920      Without a retry queue or journal, a failed message is resent once straight away (isSendingAgain)
+//  2026-10-16  a00889920      Added canKeepMessages() for transports with their own send queue
 //*******************************************************************************
 
 #ifndef __SMARTTHINGSETHERNET_H__ 
 #define __SMARTTHINGSETHERNET_H__
 
 #include "SmartThings.h"
+#include "MessageQueue.h"
+#include "HttpRequestParser.h"
+#include "DatagramLink.h"
+#include "EventJournal.h"
 
 //Adjust the RSSI Transmit Interval below as you see fit (in milliseconds)
 //  Note:  When the board first boots, it transmits frequently, then slows over 
@@ -26,6 +41,7 @@
 // Using Ethernet Shield
 //*******************************************************************************
 #include <IPAddress.h>
+#include <Client.h>
 /*
 //#if defined ARDUINO_ARCH_AVR
 //#include <SPI.h>
@@ -38,7 +54,19 @@ namespace st
 {
 	class SmartThingsEthernet: public SmartThings
 	{
-	private:
+	public:
+		//*******************************************************************************
+		/// Counts kept by the retry queue, for diagnostics
+		//*******************************************************************************
+		struct RetryStats
+		{
+			unsigned long queued;		//messages queued to be retried
+			unsigned long resent;		//resend attempts, from the retry queue or the journal
+			unsigned long recovered;	//messages from the retry queue delivered by a resend
+			unsigned long givenUp;		//times a message used up its retries (moved to the journal, if one is set)
+			unsigned long dropped;		//messages lost because the retry queue or journal was full
+			unsigned long breakerTrips;	//times the hub was found unreachable and new messages stopped trying it
+		};
 
 	protected:
 		IPAddress st_localIP;
@@ -50,6 +78,225 @@ namespace st
 		uint16_t st_hubPort;
 		bool st_DHCP;
 
+	private:
+		bool m_bKeepAlive;						//true to keep the connection to the hub open between sends
+		unsigned long m_lKeepAliveTimeout;		//ms an idle kept-alive connection stays open
+		unsigned long m_lLastPostMillis;		//time of the last POST on the kept-alive connection
+		bool m_bConnectionOpen;					//true while a kept-alive connection is being held open
+		DatagramLink *m_pDatagramLink;			//when set, messages are sent as UDP datagrams instead of HTTP POSTs
+		EventJournal *m_pJournal;				//when set, messages whose retries are used up are kept here and sent later
+		unsigned long m_lReplayInterval;		//ms between messages resent from the retry queue or the journal
+
+		MessageQueue m_RetryQueue;				//messages waiting to be retried, oldest first - each record is [tries][first failure millis (4 bytes)][message]
+		byte m_nFrontTries;						//attempts made at the message at the front of m_RetryQueue
+		byte m_nJournalRefusals;				//times the hub refused the message at the front of the journal
+		byte m_nRetryBudget;					//attempts per message before it is given up (or moved to the journal)
+		unsigned long m_lBackoffBase;			//ms to wait after the first failure - doubled after each one in a row
+		unsigned long m_lBackoffMax;			//longest wait between attempts
+
+		byte m_nHubFailures;					//failed attempts in a row to reach the hub
+		unsigned long m_lHubFailedMillis;		//time of the last of them
+		unsigned long m_lHubBackoff;			//ms after it before the hub is tried again (jittered)
+
+		unsigned long m_lLastResendMillis;		//time of the last resend
+		unsigned long m_lResendWait;			//ms after it before the next one
+		bool m_bResending;						//true while sendBatch() is resending a waiting message
+		bool m_bResendFailed;					//set by retryLater() while resending
+		bool m_bResendDeferred;					//the resent message was queued by the transport - resendFinished() gives the result
+		bool m_bResendFromJournal;				//the resent message came from the journal, not the retry queue
+		bool m_bSendingAgain;					//true while sendBatch() is making the one immediate resend of a message there is nowhere to keep
+		RetryStats m_RetryStats;
+
+		static const byte BREAKER_THRESHOLD = 3;	//failures in a row before new messages stop trying the hub
+		static const byte RETRY_HEADER_SIZE = 5;	//bytes in front of the message in a retry record
+
+		void drainResponse(Client &client);		//discards any reply data the hub has sent
+		bool hubBlocked() const;				//true while backing off after failing to reach the hub
+		unsigned long backoffDelay(byte attempts) const;
+		void loadFrontTries();
+		void queueRetry(const char *message, unsigned int length, byte tries);
+		void spillToJournal();
+		void giveUpFront();
+		void resend(const char *message, unsigned int length, bool fromJournal);
+		void resendJournalFront() __attribute__((noinline));	//kept out of serviceRetries() so its text buffer is only on the stack while replaying
+		void sendAgain(const char *message, unsigned int length);
+
+	protected:
+		//*******************************************************************************
+		/// Writes an HTTP POST of the messages to the hub on an already connected client
+		///   @param[in] client - connected TCP client
+		///   @param[in] messages - messages to send (need not be null terminated), one per line of the body
+		///   @param[in] lengths - number of characters in each message
+		///   @param[in] count - number of messages
+		///   @param[in] closeConnection (optional) - add a "CONNECTION: CLOSE" header (never added in keep-alive mode)
+		///   @return true if the whole request was written
+		//*******************************************************************************
+		bool postMessages(Client &client, const char * const *messages, const unsigned int *lengths, byte count, bool closeConnection = false);
+
+		//*******************************************************************************
+		/// Connects to the hub (or reuses the kept-alive connection) and POSTs the messages.
+		/// A kept-alive connection the hub has closed is detected, and the POST is sent
+		/// again on a new connection.  Returns false if the hub could not be reached, or
+		/// the request could not be written to a new connection.
+		//*******************************************************************************
+		bool postToHub(Client &client, const char * const *messages, const unsigned int *lengths, byte count, bool closeConnection = false);
+
+		//*******************************************************************************
+		/// Called after each send - discards the hub's reply and closes the connection,
+		/// unless keep-alive is enabled
+		//*******************************************************************************
+		void releaseConnection(Client &client);
+
+		//*******************************************************************************
+		/// Called from run() - closes a kept-alive connection that has been idle too long
+		/// or that the hub has closed, to free the socket
+		//*******************************************************************************
+		void checkConnection(Client &client);
+
+		//*******************************************************************************
+		/// Called at the start of sendBatch() - sends the messages through the datagram
+		/// link if one is set.  Returns false if the transport should POST them as usual.
+		//*******************************************************************************
+		bool sendDatagrams(const char * const *messages, const unsigned int *lengths, byte count);
+
+		//*******************************************************************************
+		/// Called from run() - reads the hub's acknowledgements and resends overdue datagrams
+		//*******************************************************************************
+		void serviceDatagrams();
+
+		//*******************************************************************************
+		/// Called at the start of sendBatch() - while messages are waiting to be retried
+		/// (or the hub is known to be unreachable), new ones are queued behind them so the
+		/// hub receives everything in order.  Returns true if the messages were queued
+		/// and must not be sent now.
+		//*******************************************************************************
+		bool holdMessages(const char * const *messages, const unsigned int *lengths, byte count);
+
+		//*******************************************************************************
+		/// Called when the messages could not be sent - queues them to be retried from run().
+		/// With no retry queue and no journal, each one is sent again straight away instead,
+		/// once (through sendBatch(), while isSendingAgain()).
+		//*******************************************************************************
+		void retryLater(const char * const *messages, const unsigned int *lengths, byte count);
+
+		//*******************************************************************************
+		/// Called from run() - resends the oldest waiting message once its backoff has
+		/// passed, from the retry queue first, then the journal.  Never waits, apart from
+		/// the transport's own connect.
+		//*******************************************************************************
+		void serviceRetries();
+
+		//*******************************************************************************
+		/// Called by postToHub(), and by transports that detect a failure later - keep the
+		/// backoff and circuit breaker up to date
+		//*******************************************************************************
+		void hubReached();
+		void hubFailed();
+
+		//*******************************************************************************
+		/// For transports that send in the background - while isResending(), a message
+		/// queued by sendBatch() is a resend.  The transport calls deferResend() when it
+		/// queues it, and resendFinished() once it knows whether it was delivered.
+		//*******************************************************************************
+		bool isResending() const { return m_bResending; }
+		void deferResend() { m_bResendDeferred = true; }
+		void resendFinished(bool delivered);
+
+		//*******************************************************************************
+		/// True while sendBatch() is called for the one immediate resend of a message there is
+		/// nowhere to keep - a transport that sends in the background must send it now
+		//*******************************************************************************
+		bool isSendingAgain() const { return m_bSendingAgain; }
+
+		//*******************************************************************************
+		/// True if there is a retry queue or a journal to keep messages in for later - a
+		/// transport with its own send queue can hand its messages on when it cannot send them
+		//*******************************************************************************
+		bool canKeepMessages() const { return (m_RetryQueue.capacity() > 0) || m_pJournal; }
+
+		//*******************************************************************************
+		/// Returns false while the transport is busy sending - serviceRetries() waits for it
+		//*******************************************************************************
+		virtual bool readyToResend() { return true; }
+
+		//*******************************************************************************
+		/// State of one connection from the hub to the device's server
+		//*******************************************************************************
+		struct InboundRequest
+		{
+			HttpRequestParser parser;
+			unsigned long lastMillis;	//time data last arrived
+			bool answered;				//at least one request has been answered on this connection
+		};
+
+		template<class ClientT> struct InboundSlot : InboundRequest
+		{
+			ClientT client;
+		};
+
+		static const unsigned long INBOUND_TIMEOUT = 2000;	//ms an inbound connection may sit without data before it is closed
+		static const unsigned int INBOUND_READ_LIMIT = 256;	//most bytes read from one connection per run()
+
+		//*******************************************************************************
+		/// Reads what has arrived on an inbound connection, answers and delivers every
+		/// complete request.  Never waits.  Returns true when the connection should be
+		/// closed - all requests answered, closed by the hub, or idle too long.
+		//*******************************************************************************
+		bool serviceRequest(Client &client, InboundRequest &request);
+
+		//*******************************************************************************
+		/// Called from run() - accepts a new connection from the hub into a free slot, and
+		/// services every open slot.  Replaces the blocking, String based request loop.
+		//*******************************************************************************
+		template<class ServerT, class ClientT, byte SLOTS> void serviceInbound(ServerT &server, InboundSlot<ClientT> (&slots)[SLOTS])
+		{
+			ClientT client = server.available();
+			if (client)
+			{
+				//some servers (WiFiNINA, WiFi101) return a connection every time it has data - only new ones take a slot
+				byte free = SLOTS;
+				bool known = false;
+				for (byte i = 0; i < SLOTS; i++)
+				{
+					if (slots[i].client)
+					{
+						known = known || ((slots[i].client.remoteIP() == client.remoteIP()) && (slots[i].client.remotePort() == client.remotePort()));
+					}
+					else if (free == SLOTS)
+					{
+						free = i;
+					}
+				}
+
+				if (!known)
+				{
+					if (free < SLOTS)
+					{
+						slots[free].client = client;
+						slots[free].parser.reset();
+						slots[free].lastMillis = millis();
+						slots[free].answered = false;
+					}
+					else
+					{
+						if (_isDebugEnabled)
+						{
+							Serial.println(F("SmartThings.run() - no free slot for the hub's connection, closing it"));
+						}
+						client.stop();
+					}
+				}
+			}
+
+			for (byte i = 0; i < SLOTS; i++)
+			{
+				if (slots[i].client && serviceRequest(slots[i].client, slots[i]))
+				{
+					slots[i].client.stop();
+				}
+			}
+		}
+
 	public:
 
 		//*******************************************************************************
@@ -86,6 +333,57 @@ namespace st
 		//*******************************************************************************
 		~SmartThingsEthernet();
 
+		//*******************************************************************************
+		/// Keeps the HTTP connection to the hub open between sends, saving a TCP connect
+		/// and close per message.  The connection is closed after idleTimeout ms without
+		/// a send.  Off by default.
+		//*******************************************************************************
+		void setKeepAlive(bool enable, unsigned long idleTimeout = 5000) { m_bKeepAlive = enable; m_lKeepAliveTimeout = idleTimeout; }
+		bool getKeepAlive() const { return m_bKeepAlive; }
+
+		//*******************************************************************************
+		/// Sends messages to the hub as UDP datagrams through link instead of as HTTP
+		/// POSTs (0 to go back to HTTP).  The hub's parent device handler must support
+		/// datagrams.  Commands from the hub still arrive over HTTP.
+		//*******************************************************************************
+		void setDatagramLink(DatagramLink *link) { m_pDatagramLink = link; }
+		DatagramLink *getDatagramLink() const { return m_pDatagramLink; }
+
+		//*******************************************************************************
+		/// Keeps messages whose retries are used up in journal (st::RamJournal or
+		/// st::FlashJournal), and sends them in order, one every replayInterval ms, once
+		/// the hub can be reached again (0 to stop journaling).  A message captured
+		/// since the board started is sent with its age in seconds after the value,
+		/// e.g. "temperature1 72.5 age=312" - the hub only reads the name and value.
+		//*******************************************************************************
+		void setJournal(EventJournal *journal, unsigned long replayInterval = 200) { m_pJournal = journal; m_lReplayInterval = replayInterval; }
+		EventJournal *getJournal() const { return m_pJournal; }
+
+		//*******************************************************************************
+		/// Gives the retry queue buffer (size bytes, must outlive the transport) to hold
+		/// messages that could not be sent until they are retried.  Without one, a message
+		/// that could not be sent goes straight to the journal, or is sent once more
+		/// straight away and reported as STSEND_TIMEOUT if that fails too.  A message
+		/// takes its length + 9 bytes - 128 suits an UNO.
+		///   e.g.  static byte retryBuffer[128];
+		///         st::SmartThingsEthernetW5x00 *transport = new st::SmartThingsEthernetW5x00(...);
+		///         transport->setRetryQueue(retryBuffer, sizeof(retryBuffer));
+		///         st::Everything::SmartThing = transport;
+		//*******************************************************************************
+		void setRetryQueue(byte *buffer, unsigned int size);
+
+		//*******************************************************************************
+		/// Messages that could not be sent are retried from run() up to maxTries times,
+		/// waiting baseDelay ms after the first failure, doubling (with jitter) up to
+		/// maxDelay.  After 3 failures in a row the hub is treated as unreachable and new
+		/// messages wait in the queue too, until a retry gets through.  Defaults: 5 tries,
+		/// 1 s, 60 s.
+		//*******************************************************************************
+		void setRetryPolicy(byte maxTries, unsigned long baseDelay = 1000, unsigned long maxDelay = 60000) { m_nRetryBudget = maxTries ? maxTries : 1; m_lBackoffBase = baseDelay; m_lBackoffMax = maxDelay; }
+		const RetryStats &getRetryStats() const { return m_RetryStats; }
+		bool isHubReachable() const { return m_nHubFailures < BREAKER_THRESHOLD; }
+		byte getRetryQueueLength() const { return m_RetryQueue.count(); }
+
 		//*******************************************************************************
 		/// Initialize SmartThings Library 
 		//*******************************************************************************
@@ -30,239 +30,115 @@
 /// 	-2016-06-04  Dan Ogorchock  Added improved support for Arduino Leonardo
 ///		-2017-02-04  Dan Ogorchock  Modified to be a subclass of new SmartThings base class
 ///		-2017-02-08  Dan Ogorchock  Cleaned up.  Now uses HardwareSerial* objects directly.
+///		-2026-10-16  a00889920      Received bytes are parsed as they are read; sendBatch() packs several messages per frame
 //*******************************************************************************
 #include "SmartThingsThingShield.h"
 
 namespace st
 {
 	//*****************************************************************************
-	void SmartThingsThingShield::debugPrintBuffer(String prefix, uint8_t * pBuf, uint_fast8_t nBuf)
+	void SmartThingsThingShield::_process(void)
 	{
-		if (_isDebugEnabled)
-		{
-			Serial.print(prefix);
-			for (uint_fast8_t i = 0; i < nBuf; i++)
-			{
-				Serial.print(char(pBuf[i]));
-			}
-			Serial.println();
-		}
-	}
+		uint32_t nowMilliseconds = millis();
 
-	//*****************************************************************************
-	bool SmartThingsThingShield::isRxLine(uint8_t * pLine)
-	{
-		// line starts with "T00000000:RX"
-		return ((pLine[0] == 'T') && (pLine[9] == ':') && (pLine[10] == 'R') && (pLine[11] == 'X'));
-	}
+		//once joined the network state rarely changes - ask for it once a minute instead of every 5 s
+		uint32_t netinfoInterval = (_networkState == STATE_JOINED) ? 60000 : 5000;
 
-	//*******************************************************************************
-	bool SmartThingsThingShield::isAsciiHex(uint8_t ascii)
-	{
-		bool retVal = false;
-		if (
-			((ascii >= 'A') && (ascii <= 'F')) ||
-			((ascii >= 'a') && (ascii <= 'f')) ||
-			((ascii >= '0') && (ascii <= '9'))
-			)
+		if ((nowMilliseconds < _lastShieldMS) || ((nowMilliseconds - _lastShieldMS) > netinfoInterval))
 		{
-			retVal = true;
+			_shieldGetNetworkInfo();
+			_lastShieldMS = nowMilliseconds;
+		}
+		else if ((_networkState == STATE_JOINED) &&
+			((nowMilliseconds < _lastPingMS) || ((nowMilliseconds - _lastPingMS) > 60000)))
+		{ // ping if nothing has been sent for a minute, or on rollover
+			send("ping");
 		}
-		return retVal;
-	}
-
-	//*******************************************************************************
-	/// @note this function doesn't check for hex validity before converting
-	//*******************************************************************************
-	uint8_t SmartThingsThingShield::asciiToHexU8(uint8_t pAscii[2])
-	{
-		uint8_t hex;
-		hex = ((pAscii[0] - (((pAscii[0] >> 6) & 0x1) * 0x37)) & 0xF);
-		hex <<= 4;
-		hex |= ((pAscii[1] - (((pAscii[1] >> 6) & 0x1) * 0x37)) & 0xF);
-		return hex;
 	}
 
 	//*****************************************************************************
-	uint_fast8_t SmartThingsThingShield::translatePayload(uint8_t *pBuf, uint_fast8_t nBuf)
+	void SmartThingsThingShield::handleFrame(ShieldFrameParser::Frame_t frame)
 	{
-		uint_fast8_t payloadLength = 0; // return value
-		uint_fast8_t payloadStart = 0;
-		uint_fast8_t payloadEnd = 0;
-
-		uint_fast8_t i;
-
-		// find [ ] message from the back of the message
-		for (i = nBuf - 1; i > 0; i--)
+		if (frame == ShieldFrameParser::FRAME_PAYLOAD)
 		{
-			if (pBuf[i] == ']')
-			{
-				payloadEnd = i;
-			}
-			else if (pBuf[i] == '[')
+			if (_isDebugEnabled)
 			{
-				payloadStart = i;
-				break;
+				Serial.print(F("->| payload :: "));
+				Serial.println(_parser.payload());
+				if (_parser.overflowed())
+				{
+					Serial.println(F("->| payload truncated"));
+				}
 			}
+			deliverCommand(_parser.payload(), _parser.payloadLength());  // call out to main application
 		}
-
-		if (_isDebugEnabled)
+		else if (frame == ShieldFrameParser::FRAME_NETINFO)
 		{
-			Serial.print(F("payload start: "));
-			Serial.print(payloadStart);
-			Serial.print(F(" end: "));
-			Serial.print(payloadEnd);
-			Serial.print(F(" : "));
-			for (i = payloadStart + 1; i < payloadEnd; i++)
+			if (_parser.networkState() <= STATE_LEAVING) // make sure it maps to the enum
 			{
-				Serial.print(pBuf[i]);
-				Serial.print(' ');
-			}
-			Serial.println();
-		}
+				_networkState = (SmartThingsNetworkState_t)_parser.networkState();
+				_nodeID = _parser.nodeID();
+				memcpy(_eui64, _parser.eui64(), sizeof(_eui64));
 
-		if ((payloadStart != 0) && (payloadEnd != 0) && (payloadEnd - payloadStart > 4) && (pBuf[payloadStart + 1] == '0') && (pBuf[payloadStart + 2] == 'A'))
-		{ // if valid message then parse
-			i = payloadStart + 4; // start+3 should be ' '  
-			while (i < payloadEnd)
-			{
-				if (pBuf[i] != ' ')
+				if (_isDebugEnabled)
 				{
-					if (isAsciiHex(pBuf[i]) && isAsciiHex(pBuf[i + 1]))
-					{
-						pBuf[payloadLength++] = asciiToHexU8(&(pBuf[i++]));
-					}
+					Serial.print(F("  |~> netinfo state "));
+					Serial.print(_networkState);
+					Serial.print(F(" node "));
+					Serial.println(_nodeID, HEX);
 				}
-				i++;
 			}
 		}
-
-		pBuf[payloadLength] = 0x0; // null-terminate the string
-		return payloadLength;
 	}
 
 	//*****************************************************************************
-	void SmartThingsThingShield::_process(void)
+	void SmartThingsThingShield::writeHex(uint8_t value)
 	{
-		uint32_t nowMilliseconds = millis();
+		static const char digits[] = "0123456789ABCDEF";
+		char hex[3] = { digits[value >> 4], digits[value & 0x0F], ' ' };
+		_mySerial->write((const uint8_t *)hex, 3);
 
-		if ((nowMilliseconds < _lastShieldMS) || ((nowMilliseconds - _lastShieldMS) > 5000))
+		if (_isDebugEnabled)
 		{
-			_shieldGetNetworkInfo();
-			_lastShieldMS = nowMilliseconds;
-		}
-		else if ((_networkState == STATE_JOINED) &&
-			((nowMilliseconds < _lastPingMS) || ((nowMilliseconds - _lastPingMS) > 60000)))
-		{ // ping every minutes or on rollover
-			send("ping");
-			_lastPingMS = nowMilliseconds;
+			Serial.write((const uint8_t *)hex, 3);
 		}
 	}
 
 	//*****************************************************************************
-	void SmartThingsThingShield::handleLine(void)
+	// sendFrame() - one ZigBee frame carrying the messages, separated by 0A
+	//*****************************************************************************
+	void SmartThingsThingShield::sendFrame(const char * const *messages, const unsigned int *lengths, byte count)
 	{
-		if (_nBufRX > 0)
+		// e.g. thing.print("raw 0x0 {00 00 0A 0A 62 75 74 74 6f 6e 20 64 6f 77 6e }");
+		_mySerial->print(F("raw 0x0 { 00 00 0A 0A "));
+
+		if (_isDebugEnabled)
 		{
-			if (isRxLine(_pBufRX))
+			Serial.print(F("<-| raw 0x0 { 00 00 0A 0A "));
+		}
+
+		for (byte m = 0; m < count; m++)
+		{
+			if (m > 0)
 			{
-				debugPrintBuffer("->| ", _pBufRX, _nBufRX);
-				{
-					uint_fast8_t messageBufLength = translatePayload(_pBufRX, _nBufRX);
-
-					if (messageBufLength > 0)
-					{
-						debugPrintBuffer("->| payload :: ", (uint8_t *)_pBufRX, messageBufLength);
-
-						_calloutFunction(String((char *)_pBufRX));  // call out to main application
-					}
-					else
-					{
-						debugPrintBuffer("->| no payload from :: ", _pBufRX, _nBufRX);
-					}
-				}
+				writeHex('\n');
 			}
-			else
-			{ //XXX Totally slapped together since this is temp-- will go away with command set change 
-				uint_fast8_t i = 0;
-				bool found = false;
-				if (_nBufRX >= 32) //netinfo:0022A3000000B675,E30E,02 
-				{
-					while (i < _nBufRX)
-					{
-						if (
-							(_pBufRX[i] == 'n') &&
-							(_pBufRX[i + 1] == 'e') &&
-							(_pBufRX[i + 2] == 't') &&
-							(_pBufRX[i + 3] == 'i') &&
-							(_pBufRX[i + 4] == 'n') &&
-							(_pBufRX[i + 5] == 'f') &&
-							(_pBufRX[i + 6] == 'o') &&
-							(_pBufRX[i + 7] == ':') &&
-							(_pBufRX[i + 24] == ',') &&
-							(_pBufRX[i + 29] == ',')
-							)
-						{
-							// parse off EUI 
-							if (
-								isAsciiHex(_pBufRX[i + 8]) &&
-								isAsciiHex(_pBufRX[i + 9]) &&
-								isAsciiHex(_pBufRX[i + 10]) &&
-								isAsciiHex(_pBufRX[i + 11]) &&
-								isAsciiHex(_pBufRX[i + 12]) &&
-								isAsciiHex(_pBufRX[i + 13]) &&
-								isAsciiHex(_pBufRX[i + 14]) &&
-								isAsciiHex(_pBufRX[i + 15]) &&
-								isAsciiHex(_pBufRX[i + 16]) &&
-								isAsciiHex(_pBufRX[i + 17]) &&
-								isAsciiHex(_pBufRX[i + 18]) &&
-								isAsciiHex(_pBufRX[i + 19]) &&
-								isAsciiHex(_pBufRX[i + 20]) &&
-								isAsciiHex(_pBufRX[i + 21]) &&
-								isAsciiHex(_pBufRX[i + 22]) &&
-								isAsciiHex(_pBufRX[i + 23]) &&
-
-								isAsciiHex(_pBufRX[i + 25]) &&
-								isAsciiHex(_pBufRX[i + 26]) &&
-								isAsciiHex(_pBufRX[i + 27]) &&
-								isAsciiHex(_pBufRX[i + 28]) &&
-
-								isAsciiHex(_pBufRX[i + 30]) &&
-								isAsciiHex(_pBufRX[i + 31])
-								)
-							{
-								uint8_t tempNetStat = asciiToHexU8(&(_pBufRX[i + 30]));
-								if (tempNetStat <= STATE_LEAVING) // make sure it maps to the enum
-								{
-									_networkState = (SmartThingsNetworkState_t)tempNetStat;
-
-									_nodeID = asciiToHexU8(&(_pBufRX[i + 25]));
-									_nodeID <<= 8;
-									_nodeID |= asciiToHexU8(&(_pBufRX[i + 27]));
-
-									_eui64[7] = asciiToHexU8(&(_pBufRX[i + 8]));
-									_eui64[6] = asciiToHexU8(&(_pBufRX[i + 10]));
-									_eui64[5] = asciiToHexU8(&(_pBufRX[i + 12]));
-									_eui64[4] = asciiToHexU8(&(_pBufRX[i + 14]));
-									_eui64[3] = asciiToHexU8(&(_pBufRX[i + 16]));
-									_eui64[2] = asciiToHexU8(&(_pBufRX[i + 18]));
-									_eui64[1] = asciiToHexU8(&(_pBufRX[i + 20]));
-									_eui64[0] = asciiToHexU8(&(_pBufRX[i + 22]));
-
-									debugPrintBuffer("  |~> ", &(_pBufRX[i]), 32);
-									found = true;
-								}
-							}
-						}
-						i++;
-					}
-				}
-				if (found == false)
-					debugPrintBuffer("->| IGNORING :: ", _pBufRX, _nBufRX);
+			for (unsigned int i = 0; i < lengths[m]; i++)
+			{
+				writeHex(messages[m][i]);
 			}
-			_nBufRX = 0;
 		}
+
+		_mySerial->print(F("}\nsend 0x0 1 1\n"));
+
+		if (_isDebugEnabled)
+		{
+			Serial.print(F("}\nsend 0x0 1 1\n"));
+		}
+
+		_lastPingMS = millis();	//anything sent tells the hub the shield is alive
 	}
+
 	//*****************************************************************************
 	void SmartThingsThingShield::_shieldGetNetworkInfo(void)
 	{
@@ -286,8 +162,7 @@ namespace st
 		//_SerialPort(SW_SERIAL),
 		_lastPingMS(0xFFFFFF00),
 		_lastShieldMS(0xFFFFFF00),
-		_networkState(STATE_UNKNOWN),
-		_nBufRX(0)
+		_networkState(STATE_UNKNOWN)
 	{
 		_mySerial = new SoftwareSerial(pinRX, pinTX);
 		_mySerial->begin(2400);
@@ -299,8 +174,7 @@ namespace st
 		_mySerial(hwSerialPort),
 		_lastPingMS(0xFFFFFF00),
 		_lastShieldMS(0xFFFFFF00),
-		_networkState(STATE_UNKNOWN),
-		_nBufRX(0)
+		_networkState(STATE_UNKNOWN)
 	{
 //		_isDebugEnabled = hwSerialPort != Serial ? enableDebug : false;	//Do not allow debug print statements if using Hardware Serial (pins 0,1) for ST Communications
 		_mySerial->begin(2400);
@@ -343,26 +217,15 @@ namespace st
 	//*****************************************************************************
 	void SmartThingsThingShield::run(void)
 	{
-		uint8_t readByte;
-
-		while ((_nBufRX < SMARTTHINGS_RX_BUFFER_SIZE) && _mySerial->available())
+		// the serial driver buffers bytes as they arrive - parse a bounded number per call so
+		// a burst from the shield can not hold up the sketch's loop()
+		for (uint_fast8_t n = 0; (n < SMARTTHINGS_SHIELD_READ_LIMIT) && _mySerial->available(); n++)
 		{
-
-			readByte = _mySerial->read();
-
-			if ((readByte == 0x0D) || (readByte == 0x0A))
-			{ // handle data from SmartThing Hub line-by-line, execute user's callback function for each line
-				handleLine();
-			}
-			else
+			ShieldFrameParser::Frame_t frame = _parser.feed(_mySerial->read());
+			if (frame != ShieldFrameParser::FRAME_NONE)
 			{
-				// keep track of everything that comes in until we reach a newline
-				// TODO(cwvh): validate bufferlength 1988-10-19
-				//if (_nBufRX > 200)
-				//  panic("too many characters!"); 
-				_pBufRX[_nBufRX++] = readByte;
+				handleFrame(frame);
 			}
-
 		}
 		_process();
 	}
@@ -370,31 +233,32 @@ namespace st
 	//*****************************************************************************
 	void SmartThingsThingShield::send(String message)
 	{
-		// e.g. thing.print("raw 0x0 {00 00 0A 0A 62 75 74 74 6f 6e 20 64 6f 77 6e }");
-		_mySerial->print(F("raw 0x0 { 00 00 0A 0A "));
+		send(message.c_str(), message.length());
+	}
 
-		if (_isDebugEnabled)
-		{
-			Serial.print(F("<-| raw 0x0 { 00 00 0A 0A "));
-		}
+	//*****************************************************************************
+	void SmartThingsThingShield::send(const char *message, unsigned int length)
+	{
+		sendFrame(&message, &length, 1);
+	}
 
-		for (int i = 0; i < message.length(); i++)
+	//*****************************************************************************
+	// sendBatch() - packs as many messages as fit into each ZigBee frame
+	//*****************************************************************************
+	void SmartThingsThingShield::sendBatch(const char * const *messages, const unsigned int *lengths, byte count)
+	{
+		byte first = 0;
+		while (first < count)
 		{
-			_mySerial->print(message[i], HEX);
-			_mySerial->print(' ');
-
-			if (_isDebugEnabled)
+			unsigned int payload = lengths[first];
+			byte n = 1;
+			while ((first + n < count) && (payload + 1 + lengths[first + n] <= SMARTTHINGS_SHIELD_MAX_PAYLOAD))
 			{
-				Serial.print(message[i], HEX);
-				Serial.print(' ');
+				payload += 1 + lengths[first + n];
+				n++;
 			}
-		}
-
-		_mySerial->print(F("}\nsend 0x0 1 1\n"));
-
-		if (_isDebugEnabled)
-		{
-			Serial.print(F("}\nsend 0x0 1 1\n"));
+			sendFrame(messages + first, lengths + first, n);
+			first += n;
 		}
 	}
 
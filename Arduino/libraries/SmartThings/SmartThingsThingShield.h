@@ -32,11 +32,15 @@
 ///		-2017-02-08  Dan Ogorchock  Cleaned up.  Now uses HardwareSerial* objects directly.
 ///     -2017-08-14  Dan Ogorchock  Disabled SoftwareSerial support if compiling ESP32 board
 //      -2020-08-22  a00889920      Added deepSleep() function
+//      -2026-10-16  a00889920      Received bytes are parsed as they are read (st::ShieldFrameParser) - no line buffer
+//      -2026-10-16  a00889920      Added send(const char*, length) and sendBatch() - several messages per ZigBee frame
+//      -2026-10-16  a00889920      Network info is polled every minute, not every 5 s, once the shield has joined
 //*******************************************************************************
 #ifndef __SMARTTHINGS_THINGSHIELD_H__
 #define __SMARTTHINGS_THINGSHIELD_H__
 
 #include "SmartThings.h"
+#include "ShieldFrameParser.h"
 
 //*******************************************************************************
 #define BOARD_TYPE_UNO       0
@@ -70,8 +74,9 @@
 #endif
 
 //*******************************************************************************
-#define SMARTTHINGS_RX_BUFFER_SIZE 256 // if > 255: change _nBufRX to u16 
 #define SMARTTHINGS_SHIELDTYPE_SIZE 32 // if > 255: change _shieldTypeLen to u16 
+#define SMARTTHINGS_SHIELD_MAX_PAYLOAD 64	// most message bytes sent in one ZigBee frame (after the 4 byte header)
+#define SMARTTHINGS_SHIELD_READ_LIMIT 64	// most received bytes parsed per call to run()
 
 namespace st
 {
@@ -106,18 +111,14 @@ namespace st
 		uint8_t _eui64[8];
 		uint16_t _nodeID;
 
-		uint8_t _pBufRX[SMARTTHINGS_RX_BUFFER_SIZE];
-		uint_fast8_t _nBufRX;
+		ShieldFrameParser _parser;	//the shield's output is parsed as it is read from the serial port
 
 		void _shieldGetNetworkInfo(void);
 		void _process(void);
 
-		void debugPrintBuffer(String prefix, uint8_t * pBuf, uint_fast8_t nBuf);
-		bool isRxLine(uint8_t * pLine);
-		bool isAsciiHex(uint8_t ascii);
-		uint8_t asciiToHexU8(uint8_t pAscii[2]);
-		uint_fast8_t translatePayload(uint8_t *pBuf, uint_fast8_t nBuf);
-		void handleLine(void);
+		void handleFrame(ShieldFrameParser::Frame_t frame);
+		void writeHex(uint8_t value);
+		void sendFrame(const char * const *messages, const unsigned int *lengths, byte count);
 
 	public:
 		//*******************************************************************************
@@ -161,6 +162,19 @@ namespace st
 		//*******************************************************************************
 		virtual void send(String message);
 
+		//*******************************************************************************
+		/// @brief Send Message out over ZigBee to the Hub - message need not be null terminated
+		//*******************************************************************************
+		virtual void send(const char *message, unsigned int length);
+
+		//*******************************************************************************
+		/// @brief Send several Messages to the Hub, packed into as few ZigBee frames as
+		///        SMARTTHINGS_SHIELD_MAX_PAYLOAD allows, one message per line.  The hub's
+		///        parent device handler must split the lines before batching is enabled
+		///        with setMaxBatchSize().
+		//*******************************************************************************
+		virtual void sendBatch(const char * const *messages, const unsigned int *lengths, byte count);
+
 		//*******************************************************************************
 		///  @brief Puts device into Deepsleep 
 		///  @param[uint64_t] time to sleep
@@ -13,6 +13,18 @@
 //  2018-02-03  Dan Ogorchock  Support for Hubitat
 //  2020-04-10  Dan Ogorchock  Improved network performance by disabling WiFi Sleep
 //  2020-06-20  Dan Ogorchock  Add user selectable host name (repurposing the old shieldType variable)
+//  2026-10-16  a00889920      Added send() overload taking a message buffer and length, uses shared postMessage()
+//  2026-10-16  a00889920      Added sendBatch() to POST several messages in one connection
+//  2026-10-16  a00889920      sendBatch() uses postToHub()/releaseConnection(), so setKeepAlive() can keep the hub connection open
+//  2026-10-16  a00889920      Asynchronous send - sendBatch() queues the messages, and run() advances a non-blocking send state machine
+//  2026-10-16  a00889920      run() uses serviceInbound() - hub requests are parsed as they arrive, without String or a blocking read loop
+//  2026-10-16  a00889920      sendBatch() and run() support the optional UDP datagram link (setDatagramLink)
+//  2026-10-16  a00889920      Messages that cannot be sent are kept in the optional journal (setJournal) and sent later from run()
+//  2026-10-16  a00889920      Failed sends go to the shared retry queue (backoff and circuit breaker) instead of one immediate resend
+//  2026-10-16  a00889920      Fast reconnect after deep sleep from an RTC memory cache (setFastReconnect), deepSleep() reports RunTime and WakeToSend
+//  2026-10-16  a00889920      The immediate resend of a message there is nowhere to keep is sent with postNow(), not queued
+//  2026-10-16  a00889920      With a retry queue or journal, m_SendQueue is handed to it while WiFi is down (spillSendQueue()),
+//                             and a message that does not fit in m_SendQueue goes to retryLater() instead of being dropped
 //
 //*******************************************************************************
 
@@ -21,13 +33,25 @@
 namespace st
 {
 	int SmartThingsESP32WiFi::disconnectCounter = 0;
+	RTC_DATA_ATTR SmartThingsESP32WiFi::WakeCache_t SmartThingsESP32WiFi::st_wakeCache;
 
 	//*******************************************************************************
 	// SmartThingsESP32WiFi Constructor - Static IP
 	//*******************************************************************************
 	SmartThingsESP32WiFi::SmartThingsESP32WiFi(String ssid, String password, IPAddress localIP, IPAddress localGateway, IPAddress localSubnetMask, IPAddress localDNSServer, uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) :
 		SmartThingsEthernet(localIP, localGateway, localSubnetMask, localDNSServer, serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, false),
-		st_server(serverPort)
+		st_server(serverPort),
+		m_bAsyncSend(true),
+		m_SendState(SEND_IDLE),
+		m_lSendStateMillis(0),
+		m_nInFlight(0),
+		m_nResponseBytes(0),
+		m_cResponseClass(0),
+		m_bResendQueued(false),
+		m_SendQueue(m_SendBuffer, SEND_BUFFER_SIZE),
+		m_bFastReconnect(false),
+		m_bWakeCacheUsed(false),
+		m_lWakeToSendMillis(0)
 	{
 		ssid.toCharArray(st_ssid, sizeof(st_ssid));
 		password.toCharArray(st_password, sizeof(st_password));
@@ -38,7 +62,18 @@ namespace st
 	//*******************************************************************************
 	SmartThingsESP32WiFi::SmartThingsESP32WiFi(String ssid, String password, uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) :
 		SmartThingsEthernet(serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, true),
-		st_server(serverPort)
+		st_server(serverPort),
+		m_bAsyncSend(true),
+		m_SendState(SEND_IDLE),
+		m_lSendStateMillis(0),
+		m_nInFlight(0),
+		m_nResponseBytes(0),
+		m_cResponseClass(0),
+		m_bResendQueued(false),
+		m_SendQueue(m_SendBuffer, SEND_BUFFER_SIZE),
+		m_bFastReconnect(false),
+		m_bWakeCacheUsed(false),
+		m_lWakeToSendMillis(0)
 	{
 		ssid.toCharArray(st_ssid, sizeof(st_ssid));
 		password.toCharArray(st_password, sizeof(st_password));
@@ -49,7 +84,18 @@ namespace st
 	//*******************************************************************************
 	SmartThingsESP32WiFi::SmartThingsESP32WiFi(uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) :
 		SmartThingsEthernet(serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, true),
-		st_server(serverPort)
+		st_server(serverPort),
+		m_bAsyncSend(true),
+		m_SendState(SEND_IDLE),
+		m_lSendStateMillis(0),
+		m_nInFlight(0),
+		m_nResponseBytes(0),
+		m_cResponseClass(0),
+		m_bResendQueued(false),
+		m_SendQueue(m_SendBuffer, SEND_BUFFER_SIZE),
+		m_bFastReconnect(false),
+		m_bWakeCacheUsed(false),
+		m_lWakeToSendMillis(0)
 	{
 		st_preExistingConnection = true;
 	}
@@ -100,11 +146,17 @@ namespace st
 	//*******************************************************************************
 	void SmartThingsESP32WiFi::init(void)
 	{
+		//after deep sleep, join the access point used last time instead of scanning for it
+		m_bWakeCacheUsed = m_bFastReconnect && !st_preExistingConnection && wakeCacheValid();
+
 		WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
 
 		// delete old config
 		WiFi.disconnect(true);
-		delay(1000);
+		if (!m_bWakeCacheUsed)
+		{
+			delay(1000);
+		}
 		WiFi.onEvent(SmartThingsESP32WiFi::WiFiEvent);
 
 
@@ -134,25 +186,62 @@ namespace st
 		Serial.print(F("setHostname returned "));
 		Serial.println(result);
 
+		bool leaseReused = false;
 		if (st_DHCP == false)
 		{
 			WiFi.config(st_localIP, st_localGateway, st_localSubnetMask, st_localDNSServer);
 		}
+		else if (m_bWakeCacheUsed && st_wakeCache.leased && (st_wakeCache.leaseAge < WAKE_CACHE_LEASE_SECONDS))
+		{
+			//skip DHCP - the address leased before sleeping is still ours
+			WiFi.config(IPAddress(st_wakeCache.localIP), IPAddress(st_wakeCache.gateway), IPAddress(st_wakeCache.subnet), IPAddress(st_wakeCache.dns));
+			leaseReused = true;
+		}
 
 		if (!st_preExistingConnection) {
 			Serial.println(F(""));
 			Serial.println(F("Initializing ESP32 WiFi network.  Please be patient..."));
-			//wait for ESP32 to be ready on startup
-			delay(1000); //may not be necessary, but seems to help my test board start up cleanly
 
-			// attempt to connect to WiFi network
-			WiFi.begin(st_ssid, st_password);
-			Serial.print(F("Attempting to connect to WPA SSID: "));
+			if (m_bWakeCacheUsed)
+			{
+				// attempt to connect to the access point used before sleeping
+				WiFi.begin(st_ssid, st_password, st_wakeCache.channel, st_wakeCache.bssid);
+				Serial.print(F("Attempting fast reconnect to WPA SSID: "));
+			}
+			else
+			{
+				//wait for ESP32 to be ready on startup
+				delay(1000); //may not be necessary, but seems to help my test board start up cleanly
+
+				// attempt to connect to WiFi network
+				WiFi.begin(st_ssid, st_password);
+				Serial.print(F("Attempting to connect to WPA SSID: "));
+			}
 			Serial.println(st_ssid);
 		}
 
+		unsigned long joinStart = millis();
 		int count =0;
 		while (WiFi.status() != WL_CONNECTED) {
+			if (m_bWakeCacheUsed && (millis() - joinStart > WAKE_CACHE_JOIN_TIMEOUT))
+			{
+				//the access point has moved channel, or is gone - forget it and join normally
+				Serial.println(F("Fast reconnect failed, scanning for the network"));
+				st_wakeCache.crc32 = ~st_wakeCache.crc32;
+				m_bWakeCacheUsed = false;
+				WiFi.disconnect();
+				if (leaseReused)
+				{
+					WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+					leaseReused = false;
+				}
+				WiFi.begin(st_ssid, st_password);
+			}
+			if (m_bWakeCacheUsed)
+			{
+				delay(10);
+				continue;
+			}
 			count++;
 			Serial.print(F("."));
 			delay(500);	// wait for connection:
@@ -162,6 +251,15 @@ namespace st
 			}
 		}
 
+		if (m_bFastReconnect && !st_preExistingConnection)
+		{
+			if (!leaseReused)
+			{
+				st_wakeCache.leased = 0;	//new addresses - recorded by saveWakeCache()
+			}
+			saveWakeCache();
+		}
+
 		Serial.println();
 
 		st_server.begin();
@@ -199,10 +297,17 @@ namespace st
 	//*****************************************************************************
 	void SmartThingsESP32WiFi::run(void)
 	{
-		String readString;
-		String tempString;
 		String strRSSI;
 
+		advanceSend();		//moves any background send along - never waits
+		serviceDatagrams();	//reads the hub's acknowledgements of UDP datagrams and resends any overdue
+		serviceRetries();	//resends messages that could not be sent, once their backoff has passed
+
+		if (m_SendState == SEND_IDLE)
+		{
+			checkConnection(st_client);	//closes a kept-alive connection to the hub once it is idle or closed by the hub
+		}
+
 		if (WiFi.isConnected() == false)
 		{
 			if (_isDebugEnabled)
@@ -236,84 +341,259 @@ namespace st
 			}
 		}
 
-		WiFiClient client = st_server.available();
-		if (client) {
-			boolean currentLineIsBlank = true;
-			while (client.connected()) {
-				if (client.available()) {
-					char c = client.read();
-					//read char by char HTTP request
-					if (readString.length() < 200) {
-						//store characters to string
-						readString += c;
-					}
-					else
+		serviceInbound(st_server, st_inbound);	//reads and answers the hub's requests as they arrive - never waits
+	}
+
+	//*******************************************************************************
+	/// Send Message out over Ethernet to the Hub
+	//*******************************************************************************
+	void SmartThingsESP32WiFi::send(String message)
+	{
+		send(message.c_str(), message.length());
+	}
+
+	//*******************************************************************************
+	/// Send Message out over Ethernet to the Hub - message need not be null terminated
+	//*******************************************************************************
+	void SmartThingsESP32WiFi::send(const char *message, unsigned int length)
+	{
+		sendBatch(&message, &length, 1);
+	}
+
+	//*******************************************************************************
+	/// Send several Messages out over Ethernet to the Hub in one HTTP POST, one message per line
+	//*******************************************************************************
+	void SmartThingsESP32WiFi::sendBatch(const char * const *messages, const unsigned int *lengths, byte count)
+	{
+		if (sendDatagrams(messages, lengths, count))
+		{
+			return;		//sent as a UDP datagram - acknowledged or resent from run()
+		}
+
+		if (holdMessages(messages, lengths, count))
+		{
+			return;		//sent from run() after the messages already waiting to be resent
+		}
+
+		if (!m_bAsyncSend || isSendingAgain())
+		{
+			postNow(messages, lengths, count);	//a second attempt from retryLater() is made now - it may come from inside finishSend()
+			return;
+		}
+
+		//the messages are copied - the caller's buffers may be reused as soon as this returns
+		for (byte i = 0; i < count; i++)
+		{
+			if (m_SendQueue.push(messages[i], lengths[i]))
+			{
+				if (isResending())
+				{
+					m_bResendQueued = true;
+					deferResend();		//taken out of its queue by finishSend() once the hub has accepted it
+				}
+			}
+			else if (isResending())
+			{
+				retryLater(&messages[i], &lengths[i], 1);	//left at the front of its queue for now
+			}
+			else if (canKeepMessages())
+			{
+				retryLater(&messages[i], &lengths[i], 1);	//resent once m_SendQueue has gone out - readyToResend() waits for it
+			}
+			else
+			{
+				if (_isDebugEnabled)
+				{
+					Serial.println(F("SmartThings.send() - send queue full, message dropped"));
+				}
+				reportSendResult(messages[i], lengths[i], STSEND_OVERFLOW);
+			}
+		}
+
+		advanceSend();	//connect and write now if nothing is in flight - the reply is read from run()
+	}
+
+	//*******************************************************************************
+	/// Background send state machine - each call does whatever can be done without waiting
+	//*******************************************************************************
+	void SmartThingsESP32WiFi::advanceSend()
+	{
+		switch (m_SendState)
+		{
+		case SEND_IDLE:
+		{
+			if (m_SendQueue.isEmpty())
+			{
+				return;
+			}
+			if (WiFi.isConnected() == false)
+			{
+				if (canKeepMessages())
+				{
+					hubFailed();		//no WiFi, no hub - backs off as a failed connect would
+					spillSendQueue();	//the retry queue or journal keeps them through an outage m_SendQueue would soon overflow in
+				}
+				return;		//otherwise keep the messages queued until WiFi reconnects
+			}
+
+			const char *messages[SEND_MAX_BATCH];
+			unsigned int lengths[SEND_MAX_BATCH];
+			if (getMaxBatchSize() > 0)
+			{
+				m_nInFlight = m_SendQueue.frontBatch(messages, lengths, SEND_MAX_BATCH, getMaxBatchSize());
+			}
+			else
+			{
+				m_nInFlight = m_SendQueue.frontBatch(messages, lengths, 1, 0);
+			}
+
+			//connecting to the hub on the LAN (or reusing the kept-alive connection) and handing the
+			//request to the TCP stack takes a few ms - it is the wait for the reply that is slow
+			if (!postToHub(st_client, messages, lengths, m_nInFlight, true))
+			{
+				if (_isDebugEnabled)
+				{
+					Serial.print(F("SmartThings.send() - Ethernet Connection Failed, hubIP = "));
+					Serial.print(st_hubIP);
+					Serial.print(F(" hubPort = "));
+					Serial.println(st_hubPort);
+				}
+				st_client.stop();
+				finishSend(STSEND_REFUSED, true);
+				return;
+			}
+
+			m_SendState = SEND_AWAITING_RESPONSE;
+			m_lSendStateMillis = millis();
+			m_nResponseBytes = 0;
+			m_cResponseClass = 0;
+			break;
+		}
+
+		case SEND_AWAITING_RESPONSE:
+			if (!st_client.available())
+			{
+				if (millis() - m_lSendStateMillis > SEND_RESPONSE_TIMEOUT)
+				{
+					if (_isDebugEnabled)
 					{
-						if (_isDebugEnabled)
-						{
-							Serial.println(F(""));
-							Serial.println(F("SmartThings.run() - Exceeded 200 character limit"));
-							Serial.println(F(""));
-						}
-					}
-					// if you've gotten to the end of the line (received a newline
-					// character) and the line is blank, the http request has ended,
-					// so you can send a reply
-					if (c == '\n' && currentLineIsBlank) {
-						//now output HTML data header
-						tempString = readString.substring(readString.indexOf('/') + 1, readString.indexOf('?'));
-
-						if (tempString.length() > 0) {
-							client.println(F("HTTP/1.1 200 OK")); //send new page
-							client.println();
-						}
-						else {
-							client.println(F("HTTP/1.1 204 No Content"));
-							client.println();
-							client.println();
-							if (_isDebugEnabled)
-							{
-								Serial.println(F("No Valid Data Received"));
-							}
-						}
-						break;
-					}
-					if (c == '\n') {
-						// you're starting a new line
-						currentLineIsBlank = true;
-					}
-					else if (c != '\r') {
-						// you've gotten a character on the current line
-						currentLineIsBlank = false;
+						Serial.println(F("Post request timed out"));
 					}
+					st_client.stop();
+					hubFailed();
+					finishSend(STSEND_TIMEOUT, true);
 				}
+				break;
 			}
+			m_SendState = SEND_DRAINING;
+			//fall through - the reply has started to arrive
 
-			delay(1);
-			//stopping client
-			client.stop();
+		case SEND_DRAINING:
+			for (byte n = 0; (n < SEND_DRAIN_CHUNK) && st_client.available(); n++)
+			{
+				char c = st_client.read();
+				if (m_nResponseBytes == 9)
+				{
+					m_cResponseClass = c;	//"HTTP/1.1 202 ..." - the status code starts at offset 9
+				}
+				if (m_nResponseBytes < 255)
+				{
+					m_nResponseBytes++;
+				}
+				if (_isDebugEnabled) { Serial.print(c); } //prints byte to serial monitor
+			}
 
-			//Handle the received data after cleaning up the network connection
-			if (tempString.length() > 0) {
-				if (_isDebugEnabled)
+			if (st_client.available())
+			{
+				break;		//more to read on the next pass
+			}
+			if ((m_nResponseBytes > 9) || !st_client.connected())
+			{
+				releaseConnection(st_client);
+				finishSend(m_cResponseClass == '2' ? STSEND_OK : STSEND_REFUSED);
+			}
+			else if (millis() - m_lSendStateMillis > SEND_RESPONSE_TIMEOUT)
+			{
+				st_client.stop();
+				hubFailed();
+				finishSend(STSEND_TIMEOUT, true);	//the status line never arrived in full
+			}
+			break;
+		}
+	}
+
+	//*******************************************************************************
+	/// Reports the result of the messages in flight and removes them from the queue.
+	/// If retry is true (the hub could not be reached, or did not reply), messages
+	/// that were not delivered are retried from run(), with the ones queued behind them.
+	//*******************************************************************************
+	void SmartThingsESP32WiFi::finishSend(SmartThingsSendResult_t result, bool retry)
+	{
+		for (byte i = 0; i < m_nInFlight; i++)
+		{
+			const char *message;
+			unsigned int length;
+			if (m_SendQueue.front(message, length))
+			{
+				reportSendResult(message, length, result);
+				if (m_bResendQueued)
 				{
-					Serial.print(F("Handling request from ST. tempString = "));
-					Serial.println(tempString);
+					//the retry queue (or journal) still holds the message - it is only taken out once the hub has accepted it
+					m_bResendQueued = false;
+					resendFinished(result == STSEND_OK);
+				}
+				else if (retry && (result != STSEND_OK))
+				{
+					retryLater(&message, &length, 1);
 				}
-				//Pass the message to user's SmartThings callout function
-				tempString.replace("%20", " ");  //Clean up for Hubitat
-				_calloutFunction(tempString);
 			}
+			m_SendQueue.pop();
+		}
+		if (m_nInFlight > 0)
+		{
+			firstSendDone(!retry);	//retry is only asked for when the hub could not be reached
+		}
+		m_nInFlight = 0;
+		m_SendState = SEND_IDLE;
+
+		//the messages queued behind ones that are now waiting to be retried wait with them, so the hub still sees them in order.
+		//After a success they are sent first - anything already waiting to be retried overflowed m_SendQueue after them.
+		const char *message;
+		unsigned int length;
+		while (retry && m_SendQueue.front(message, length) && holdMessages(&message, &length, 1))
+		{
+			m_SendQueue.pop();
+		}
+	}
 
-			readString = "";
-			tempString = "";
+	//*******************************************************************************
+	/// Hands every message in m_SendQueue (none are in flight) to retryLater(), oldest
+	/// first, so they are resent from run() in order once the hub can be reached
+	//*******************************************************************************
+	void SmartThingsESP32WiFi::spillSendQueue()
+	{
+		const char *message;
+		unsigned int length;
+		while (m_SendQueue.front(message, length))
+		{
+			if (m_bResendQueued)
+			{
+				//the retry queue (or journal) still holds the message being resent - it is tried again after its backoff
+				m_bResendQueued = false;
+				resendFinished(false);
+			}
+			else
+			{
+				retryLater(&message, &length, 1);
+			}
+			m_SendQueue.pop();
 		}
 	}
 
 	//*******************************************************************************
-	/// Send Message out over Ethernet to the Hub
+	/// Blocking send - connects, POSTs and waits up to a second for the hub's reply
 	//*******************************************************************************
-	void SmartThingsESP32WiFi::send(String message)
+	void SmartThingsESP32WiFi::postNow(const char * const *messages, const unsigned int *lengths, byte count)
 	{
 		if (WiFi.isConnected() == false)
 		{
@@ -330,24 +610,7 @@ namespace st
 
 		//WiFiClient st_client;
 
-		//Make sure the client is stopped, to free up socket for new connection
-		st_client.stop();
-
-		if (st_client.connect(st_hubIP, st_hubPort))
-		{
-			st_client.println(F("POST / HTTP/1.1"));
-			st_client.print(F("HOST: "));
-			st_client.print(st_hubIP);
-			st_client.print(F(":"));
-			st_client.println(st_hubPort);
-			st_client.println(F("CONTENT-TYPE: text"));
-            st_client.println(F("CONNECTION: CLOSE"));
-			st_client.print(F("CONTENT-LENGTH: "));
-			st_client.println(message.length());
-			st_client.println();
-			st_client.print(message);
-		}
-		else
+		if (!postToHub(st_client, messages, lengths, count, true))
 		{
 			//connection failed;
 			if (_isDebugEnabled)
@@ -369,30 +632,18 @@ namespace st
 			//WiFi.reconnect();
 			//init();      //Re-Init connection to get things working again
 
-			if (_isDebugEnabled)
-			{
-				Serial.println(F("***********************************************************"));
-				Serial.println(F("******        Attempting to resend missed data      *******"));
-				Serial.println(F("***********************************************************"));
-			}
-
-
-			st_client.flush();
 			st_client.stop();
-			if (st_client.connect(st_hubIP, st_hubPort))
-			{
-				st_client.println(F("POST / HTTP/1.1"));
-				st_client.print(F("HOST: "));
-				st_client.print(st_hubIP);
-				st_client.print(F(":"));
-				st_client.println(st_hubPort);
-				st_client.println(F("CONTENT-TYPE: text"));
-				st_client.print(F("CONTENT-LENGTH: "));
-				st_client.println(message.length());
-				st_client.println();
-				st_client.println(message);
-			}
+			firstSendDone(false);
+			retryLater(messages, lengths, count);	//retried from run(), with backoff
+			return;		//no reply to wait for
+
+		}
+		firstSendDone(true);
 
+		if (getKeepAlive())
+		{
+			releaseConnection(st_client);	//the reply is read on the next send, or by run()
+			return;
 		}
 
         // Wait for a response
@@ -425,4 +676,145 @@ namespace st
 		delay(1);
 		st_client.stop();
 	}
+
+	//*******************************************************************************
+	/// Puts device into Deepsleep - messages still queued are sent first
+	//*******************************************************************************
+	void SmartThingsESP32WiFi::deepSleep(uint64_t time)
+	{
+		// millis() starts again at every wake, so it is the time spent awake
+		unsigned long runTime = millis();
+		if (_isDebugEnabled)
+		{
+			Serial.print(F("------------ Run time:"));
+			Serial.println(runTime);
+			Serial.print(F("------------ Wake to first send:"));
+			Serial.println(m_lWakeToSendMillis);
+		}
+
+		// Report to device handler the run time, and how long the first message took
+		send(String("RunTime ") + String(runTime));
+		if (m_lWakeToSendMillis > 0)
+		{
+			send(String("WakeToSend ") + String(m_lWakeToSendMillis));
+		}
+
+		while (isSending())
+		{
+			advanceSend();	//every state ends within SEND_RESPONSE_TIMEOUT, or sooner if WiFi is down
+			if (WiFi.isConnected() == false)
+			{
+				break;
+			}
+			yield();
+		}
+
+		if (m_bFastReconnect && wakeCacheValid())
+		{
+			st_wakeCache.leaseAge += (millis() / 1000) + (uint32_t)(time / 1000000);
+			sealWakeCache();
+		}
+
+		esp_deep_sleep(time);
+	}
+
+	//*******************************************************************************
+	/// The wake cache is only used if its CRC is good and it was made for the same
+	/// network, hub and server port - a sketch with new settings joins normally
+	//*******************************************************************************
+	bool SmartThingsESP32WiFi::wakeCacheValid()
+	{
+		return (st_wakeCache.crc32 == calculateCRC32(((uint8_t*)&st_wakeCache) + 4, sizeof(st_wakeCache) - 4)) &&
+			(st_wakeCache.ssidCRC == calculateCRC32((const uint8_t*)st_ssid, strlen(st_ssid))) &&
+			(st_wakeCache.hubIP == (uint32_t)st_hubIP) &&
+			(st_wakeCache.hubPort == st_hubPort) &&
+			(st_wakeCache.serverPort == st_serverPort);
+	}
+
+	//*******************************************************************************
+	/// Records the access point just joined and, if they are new, the DHCP addresses
+	//*******************************************************************************
+	void SmartThingsESP32WiFi::saveWakeCache()
+	{
+		st_wakeCache.ssidCRC = calculateCRC32((const uint8_t*)st_ssid, strlen(st_ssid));
+		st_wakeCache.hubIP = (uint32_t)st_hubIP;
+		st_wakeCache.hubPort = st_hubPort;
+		st_wakeCache.serverPort = st_serverPort;
+		st_wakeCache.channel = WiFi.channel();
+		memcpy(st_wakeCache.bssid, WiFi.BSSID(), 6);
+
+		if (st_DHCP && !st_wakeCache.leased)
+		{
+			st_wakeCache.leased = 1;
+			st_wakeCache.localIP = (uint32_t)WiFi.localIP();
+			st_wakeCache.gateway = (uint32_t)WiFi.gatewayIP();
+			st_wakeCache.subnet = (uint32_t)WiFi.subnetMask();
+			st_wakeCache.dns = (uint32_t)WiFi.dnsIP();
+			st_wakeCache.leaseAge = 0;
+		}
+		sealWakeCache();
+
+		if (_isDebugEnabled)
+		{
+			Serial.print(F("Wake cache saved, channel = "));
+			Serial.println(st_wakeCache.channel);
+		}
+	}
+
+	//*******************************************************************************
+	void SmartThingsESP32WiFi::sealWakeCache()
+	{
+		st_wakeCache.crc32 = calculateCRC32(((uint8_t*)&st_wakeCache) + 4, sizeof(st_wakeCache) - 4);
+	}
+
+	//*******************************************************************************
+	/// Called with the outcome of each send until the hub first accepts one
+	//*******************************************************************************
+	void SmartThingsESP32WiFi::firstSendDone(bool sent)
+	{
+		if (m_lWakeToSendMillis > 0)
+		{
+			return;
+		}
+
+		if (sent)
+		{
+			m_lWakeToSendMillis = millis() ? millis() : 1;
+		}
+		else if (m_bWakeCacheUsed)
+		{
+			//the cached address may have been leased to another device - lease one again on the next wake
+			if (_isDebugEnabled)
+			{
+				Serial.println(F("Hub not reached after fast reconnect, wake cache cleared"));
+			}
+			st_wakeCache.crc32 = ~st_wakeCache.crc32;
+			m_bWakeCacheUsed = false;
+		}
+	}
+
+	//*******************************************************************************
+	/// Calculate CRC32
+	//*******************************************************************************
+	uint32_t SmartThingsESP32WiFi::calculateCRC32(const uint8_t *data, size_t length)
+	{
+		uint32_t crc = 0xffffffff;
+		while(length--) {
+			uint8_t c = *data++;
+			for(uint32_t i = 0x80; i > 0; i >>= 1) {
+				bool bit = crc & 0x80000000;
+				if(c & i) {
+					bit = !bit;
+				}
+
+				crc <<= 1;
+				if(bit) {
+					crc ^= 0x04c11db7;
+				}
+			}
+		}
+
+		return crc;
+	}
+
 }
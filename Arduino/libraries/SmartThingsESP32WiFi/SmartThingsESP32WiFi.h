@@ -13,6 +13,14 @@
 //                             500ms to prevent duplicate child devices
 //  2020-06-20  Dan Ogorchock  Add user selectable host name (repurposing the old shieldType variable)
 //  2020-08-22  a00889920      Added deepSleep() function
+//  2026-10-16  a00889920      Added send() overload taking a message buffer and length, uses shared postMessage()
+//  2026-10-16  a00889920      Added sendBatch() to POST several messages in one connection
+//  2026-10-16  a00889920      send() queues the message and returns - run() sends it and waits for the hub's reply
+//  2026-10-16  a00889920      Added st_inbound - slots for the hub's connections to the device's server
+//  2026-10-16  a00889920      Messages that cannot be sent are kept in the optional journal (setJournal)
+//  2026-10-16  a00889920      Messages that cannot be sent are retried from run() with backoff (setRetryPolicy), the journal takes what the retries cannot
+//  2026-10-16  a00889920      Added setFastReconnect() - channel, BSSID and DHCP lease kept in RTC memory for a quick join after deep sleep
+//  2026-10-16  a00889920      With a retry queue or journal, queued messages are handed to it while WiFi is down or the send queue is full
 //
 //*******************************************************************************
 
@@ -20,6 +28,7 @@
 #define __SMARTTHINGSESP32WIFI_H__
 
 #include "SmartThingsEthernet.h"
+#include "MessageQueue.h"
 
 //*******************************************************************************
 // Using ESP32 WiFi
@@ -38,10 +47,73 @@ namespace st
 		boolean st_preExistingConnection = false;
 		WiFiServer st_server; //server
 		WiFiClient st_client; //client
+		InboundSlot<WiFiClient> st_inbound[4]; //connections from the hub
 		long previousMillis;
 		long RSSIsendInterval;
 		char st_devicename[50];
 
+		//background sending - see setAsyncSend()
+		typedef enum
+		{
+			SEND_IDLE,				//nothing in flight - the next queued message is connected and written from here
+			SEND_AWAITING_RESPONSE,	//request written, waiting for the first byte of the hub's reply
+			SEND_DRAINING			//reading the hub's reply
+		} SendState_t;
+
+		static const unsigned int SEND_BUFFER_SIZE = 1024;			//bytes of messages that may wait to be sent
+		static const unsigned long SEND_RESPONSE_TIMEOUT = 1000;	//ms to wait for the hub's reply
+		static const byte SEND_MAX_BATCH = 10;						//most messages in one POST when batching is enabled
+		static const byte SEND_DRAIN_CHUNK = 64;					//most reply bytes read per call to run()
+
+		bool m_bAsyncSend;				//true to queue messages in send() and send them from run()
+		SendState_t m_SendState;
+		unsigned long m_lSendStateMillis;	//time the current request was written
+		byte m_nInFlight;				//number of messages at the front of m_SendQueue in the current request
+		byte m_nResponseBytes;			//reply bytes read so far (stops counting at 255)
+		char m_cResponseClass;			//first digit of the reply's status code ('2' = accepted)
+		bool m_bResendQueued;			//the message in m_SendQueue is being resent from the retry queue or journal
+		byte m_SendBuffer[SEND_BUFFER_SIZE];
+		MessageQueue m_SendQueue;		//messages waiting to be sent, oldest (possibly in flight) first
+
+		void advanceSend();				//moves the background send on as far as it can without waiting
+		void finishSend(SmartThingsSendResult_t result, bool retry = false);	//reports and removes the messages in flight, retrying them if asked
+		void postNow(const char * const *messages, const unsigned int *lengths, byte count);	//blocking send, used when m_bAsyncSend is false
+		void spillSendQueue();			//hands everything in m_SendQueue to the retry queue or journal
+		virtual bool readyToResend() { return !isSending(); }	//a message being resent is only queued behind nothing
+
+		//fast reconnect after deep sleep - see setFastReconnect()
+		static const unsigned long WAKE_CACHE_JOIN_TIMEOUT = 3000;		//ms to wait for the cached access point before a normal join
+		static const uint32_t WAKE_CACHE_LEASE_SECONDS = 12UL * 3600;	//a cached DHCP address is reused for this long, then leased again
+
+		typedef struct
+		{
+			uint32_t crc32;				//of everything below - anything else is not used
+			uint32_t ssidCRC;			//the network, hub and ports the cache was made for
+			uint32_t hubIP;
+			uint16_t hubPort;
+			uint16_t serverPort;
+			uint8_t channel;			//the access point joined
+			uint8_t bssid[6];
+			uint8_t leased;				//1 if the addresses below came from DHCP
+			uint32_t localIP;
+			uint32_t gateway;
+			uint32_t subnet;
+			uint32_t dns;
+			uint32_t leaseAge;			//seconds since the addresses were leased, counting time asleep
+		} WakeCache_t;
+
+		static WakeCache_t st_wakeCache;	//in RTC memory, so it survives deep sleep
+
+		bool m_bFastReconnect;			//true to use and keep st_wakeCache
+		bool m_bWakeCacheUsed;			//this wake joined with the cached access point (and addresses)
+		unsigned long m_lWakeToSendMillis;	//millis() when the hub first accepted a message (0 = not yet)
+
+		bool wakeCacheValid();			//st_wakeCache was made by this sketch for this network and hub
+		void saveWakeCache();			//records the access point and addresses just joined
+		void sealWakeCache();			//updates st_wakeCache.crc32
+		void firstSendDone(bool sent);	//records the wake-to-first-send time, forgets the cache if it led nowhere
+		static uint32_t calculateCRC32(const uint8_t *data, size_t length);
+
 		//**************************************************************************************
 		/// Event Handler for ESP32 WiFi Events (needed to implement reconnect logic for now...)
 		//**************************************************************************************
@@ -110,7 +182,45 @@ namespace st
 		virtual void send(String message);
 
 		//*******************************************************************************
-		/// Puts device into Deepsleep 
+		/// Send Message to the Hub - message need not be null terminated
+		//*******************************************************************************
+		virtual void send(const char *message, unsigned int length);
+
+		//*******************************************************************************
+		/// Send several Messages to the Hub in one HTTP POST, one message per line
+		//*******************************************************************************
+		virtual void sendBatch(const char * const *messages, const unsigned int *lengths, byte count);
+
+		//*******************************************************************************
+		/// true (default) - send() queues the message and returns at once, and run() sends
+		/// it and reads the hub's reply.  The result of each message is passed to the
+		/// callout set with setSendCallout().  false - send() waits for the hub's reply.
+		//*******************************************************************************
+		void setAsyncSend(bool enable) { m_bAsyncSend = enable; }
+		bool getAsyncSend() const { return m_bAsyncSend; }
+
+		//*******************************************************************************
+		/// Returns true while queued messages are still being sent in the background
+		//*******************************************************************************
+		bool isSending() const { return (m_SendState != SEND_IDLE) || !m_SendQueue.isEmpty(); }
+
+		//*******************************************************************************
+		/// true - init() joins the access point (channel and BSSID) it used before deep
+		/// sleep, without scanning, and with DHCP reuses the address it was leased (for up
+		/// to WAKE_CACHE_LEASE_SECONDS).  If the join fails, or the hub can not be reached
+		/// on the first send, the cache is forgotten and a normal join is made.  Call before
+		/// init(), and sleep with deepSleep() so the lease age is kept.  Default: false.
+		//*******************************************************************************
+		void setFastReconnect(bool enable) { m_bFastReconnect = enable; }
+		bool getFastReconnect() const { return m_bFastReconnect; }
+
+		//*******************************************************************************
+		/// ms from wake (reset) until the hub first accepted a message, 0 if none yet
+		//*******************************************************************************
+		unsigned long getWakeToSendMillis() const { return m_lWakeToSendMillis; }
+
+		//*******************************************************************************
+		/// Puts device into Deepsleep - reports "RunTime" and "WakeToSend" (ms) to the hub first
 		//*******************************************************************************
 		virtual void deepSleep(uint64_t time);
 
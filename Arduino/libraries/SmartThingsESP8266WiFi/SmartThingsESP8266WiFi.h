@@ -14,6 +14,9 @@
 //  2020-08-22  a00889920	   Added power savings tricks when running on battery for ESP8266
 //  2020-08-24  a00889920      Adding suuport for device to request OTA updates for devices that sleep most of the time
 //  2020-09-02  a00889920      Moving OTA code to its own repo https://github.com/a00889920/OTAOnDemand_master
+//  2026-10-16  a00889920      Added send() overload taking a message buffer and length, uses shared postMessage()
+//  2026-10-16  a00889920      Added sendBatch() to POST several messages in one connection
+//  2026-10-16  a00889920      Added st_inbound - slots for the hub's connections to the device's server
 //*******************************************************************************
 
 #ifndef __SMARTTHINGSESP8266WIFI_H__
@@ -41,6 +44,7 @@ namespace st
 		boolean st_preExistingConnection = false;
 		WiFiServer st_server; //server
 		WiFiClient st_client; //client
+		InboundSlot<WiFiClient> st_inbound[2]; //connections from the hub
 		long previousMillis;
 		long RSSIsendInterval;
 		char st_devicename[50];
@@ -164,6 +168,16 @@ namespace st
 		//*******************************************************************************
 		virtual void send(String message);
 
+		//*******************************************************************************
+		/// Send Message to the Hub - message need not be null terminated
+		//*******************************************************************************
+		virtual void send(const char *message, unsigned int length);
+
+		//*******************************************************************************
+		/// Send several Messages to the Hub in one HTTP POST, one message per line
+		//*******************************************************************************
+		virtual void sendBatch(const char * const *messages, const unsigned int *lengths, byte count);
+
 		//*******************************************************************************
 		/// Puts device into Deepsleep 
 		//*******************************************************************************
@@ -10,6 +10,12 @@
 //  2018-02-03  Dan Ogorchock  Support for Hubitat
 //  2020-04-05  Dan Ogorchock  Tweaked to hopefully prevent lockup
 //  2020-04-18  Dan Ogorchock  Unified Arduino Ethernet Shield Class for 5100, 5200, 5500
+//  2026-10-16  a00889920      Added send() overload taking a message buffer and length, uses shared postMessage()
+//  2026-10-16  a00889920      Added sendBatch() to POST several messages in one connection
+//  2026-10-16  a00889920      sendBatch() uses postToHub()/releaseConnection(), so setKeepAlive() can keep the hub connection open
+//  2026-10-16  a00889920      sendBatch() and run() support the optional UDP datagram link (setDatagramLink)
+//  2026-10-16  a00889920      sendBatch() keeps messages it cannot send in the optional journal (setJournal), run() sends them later
+//  2026-10-16  a00889920      Failed sends go to the shared retry queue (backoff and circuit breaker) instead of one immediate resend
 //*******************************************************************************
 
 #include "SmartThingsEthernetW5x00.h"
@@ -108,6 +114,10 @@ namespace st
 
 		if (st_DHCP) { Ethernet.maintain(); }  //Renew DHCP lease if necessary
 
+		checkConnection(st_client);	//closes a kept-alive connection to the hub once it is idle or closed by the hub
+		serviceDatagrams();			//reads the hub's acknowledgements of UDP datagrams and resends any overdue
+		serviceRetries();			//resends messages that could not be sent, once their backoff has passed
+
 		EthernetClient client = st_server.available();
 		if (client) {
 			boolean currentLineIsBlank = true;
@@ -187,23 +197,33 @@ namespace st
 	//*******************************************************************************
 	void SmartThingsEthernetW5x00::send(String message)
 	{
-		//Make sure the client is stopped, to free up socket for new conenction
-		st_client.stop();
+		send(message.c_str(), message.length());
+	}
+
+	//*******************************************************************************
+	/// Send Message out over Ethernet to the Hub - message need not be null terminated
+	//*******************************************************************************
+	void SmartThingsEthernetW5x00::send(const char *message, unsigned int length)
+	{
+		sendBatch(&message, &length, 1);
+	}
 
-		if (st_client.connect(st_hubIP, st_hubPort))
+	//*******************************************************************************
+	/// Send several Messages out over Ethernet to the Hub in one HTTP POST, one message per line
+	//*******************************************************************************
+	void SmartThingsEthernetW5x00::sendBatch(const char * const *messages, const unsigned int *lengths, byte count)
+	{
+		if (sendDatagrams(messages, lengths, count))
 		{
-			st_client.println(F("POST / HTTP/1.1"));
-			st_client.print(F("HOST: "));
-			st_client.print(st_hubIP);
-			st_client.print(F(":"));
-			st_client.println(st_hubPort);
-			st_client.println(F("CONTENT-TYPE: text"));
-			st_client.print(F("CONTENT-LENGTH: "));
-			st_client.println(message.length());
-			st_client.println();
-			st_client.println(message);
+			return;		//sent as a UDP datagram - acknowledged or resent from run()
 		}
-		else
+
+		if (holdMessages(messages, lengths, count))
+		{
+			return;		//sent from run() after the messages already waiting to be resent
+		}
+
+		if (!postToHub(st_client, messages, lengths, count))
 		{
 			//connection failed;
 			if (_isDebugEnabled)
@@ -225,45 +245,12 @@ namespace st
 
 			init();      //Re-Init connection to get things working again
 
-			if (_isDebugEnabled)
-			{
-				Serial.println(F("***********************************************************"));
-				Serial.println(F("******        Attempting to resend missed data      *******"));
-				Serial.println(F("***********************************************************"));
-			}
-
-
-			st_client.flush();
 			st_client.stop();
-			if (st_client.connect(st_hubIP, st_hubPort))
-			{
-				st_client.println(F("POST / HTTP/1.1"));
-				st_client.print(F("HOST: "));
-				st_client.print(st_hubIP);
-				st_client.print(F(":"));
-				st_client.println(st_hubPort);
-				st_client.println(F("CONTENT-TYPE: text"));
-				st_client.print(F("CONTENT-LENGTH: "));
-				st_client.println(message.length());
-				st_client.println();
-				st_client.println(message);
-			}
+			retryLater(messages, lengths, count);	//retried from run(), with backoff
 
 		}
 
-		//if (_isDebugEnabled) { Serial.println(F("Ethernet.send(): Reading for reply data "));}
-		// read any data returned from the POST
-		while (st_client.connected()) {
-		    if (st_client.available()) {
-			    char c = st_client.read(); //gets byte from ethernet buffer
-				//if (_isDebugEnabled) { Serial.print(c); } //prints byte to serial monitor
-			} else {
-				break;
-			}
-		}
-
-		delay(1);
-		st_client.stop();
+		releaseConnection(st_client);
 	}
 
 }
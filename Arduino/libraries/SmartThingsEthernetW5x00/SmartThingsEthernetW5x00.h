@@ -11,6 +11,8 @@
 //                             500ms to prevent duplicate child devices
 //  2020-04-18  Dan Ogorchock  Unified Arduino Ethernet Shield Class for 5100, 5200, 5500
 //  2020-08-22  a00889920      Added deepSleep() function
+//  2026-10-16  a00889920      Added send() overload taking a message buffer and length, uses shared postMessage()
+//  2026-10-16  a00889920      Added sendBatch() to POST several messages in one connection
 //*******************************************************************************
 
 #ifndef __SMARTTHINGSETHERNETW5x00_H__ 
@@ -85,6 +87,16 @@ namespace st
 		//*******************************************************************************
 		virtual void send(String message);
 
+		//*******************************************************************************
+		/// Send Message to the Hub - message need not be null terminated
+		//*******************************************************************************
+		virtual void send(const char *message, unsigned int length);
+
+		//*******************************************************************************
+		/// Send several Messages to the Hub in one HTTP POST, one message per line
+		//*******************************************************************************
+		virtual void sendBatch(const char * const *messages, const unsigned int *lengths, byte count);
+
 		//*******************************************************************************
 		/// Puts device into Deepsleep 
 		//*******************************************************************************
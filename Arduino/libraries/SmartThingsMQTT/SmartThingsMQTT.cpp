@@ -0,0 +1,652 @@
+//*******************************************************************************
+//	SmartThings Arduino MQTT Library - publishes to an MQTT broker (e.g. Mosquitto)
+//                                     instead of POSTing to the hub
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  a00889920      Created
+//*******************************************************************************
+
+#include "SmartThingsMQTT.h"
+
+namespace st
+{
+	//MQTT 3.1.1 control packet types (upper four bits of the first byte)
+	static const byte MQTT_CONNECT = 0x10;
+	static const byte MQTT_CONNACK = 0x20;
+	static const byte MQTT_PUBLISH = 0x30;
+	static const byte MQTT_PUBACK = 0x40;
+	static const byte MQTT_SUBSCRIBE = 0x82;	//includes the reserved flags the spec requires
+	static const byte MQTT_SUBACK = 0x90;
+	static const byte MQTT_PINGREQ = 0xC0;
+	static const byte MQTT_PINGRESP = 0xD0;
+	static const byte MQTT_DISCONNECT = 0xE0;
+
+	static const char STATUS_TOPIC[] = "status";
+	static const char SET_SUFFIX[] = "/set";
+	static const char COMMAND_TOPIC[] = "cmd";
+
+//private
+	void SmartThingsMQTT::beginPacket(byte header, unsigned long remainingLength)
+	{
+		m_nTransmitLength = 0;
+		m_bTransmitFailed = false;
+		putByte(header);
+		do
+		{
+			byte digit = remainingLength & 0x7F;
+			remainingLength >>= 7;
+			putByte(remainingLength ? (digit | 0x80) : digit);
+		} while (remainingLength);
+	}
+
+	void SmartThingsMQTT::putByte(byte b)
+	{
+		if (m_nTransmitLength == TRANSMIT_BUFFER_SIZE)
+		{
+			m_bTransmitFailed = m_bTransmitFailed || (m_Client.write(m_TransmitBuffer, m_nTransmitLength) != m_nTransmitLength);
+			m_nTransmitLength = 0;
+		}
+		m_TransmitBuffer[m_nTransmitLength++] = b;
+	}
+
+	void SmartThingsMQTT::putBytes(const void *data, unsigned int length)
+	{
+		for (unsigned int i = 0; i < length; ++i)
+		{
+			putByte(((const byte *)data)[i]);
+		}
+	}
+
+	void SmartThingsMQTT::putWord(uint16_t value)
+	{
+		putByte(value >> 8);
+		putByte(value & 0xFF);
+	}
+
+	void SmartThingsMQTT::putString(const char *text)
+	{
+		unsigned int length = strlen(text);
+		putWord(length);
+		putBytes(text, length);
+	}
+
+	void SmartThingsMQTT::putTopic(const char *name, unsigned int nameLength, const char *suffix)
+	{
+		putWord(topicLength(nameLength, suffix));
+		putBytes(m_pTopicPrefix, strlen(m_pTopicPrefix));
+		putByte('/');
+		putBytes(name, nameLength);
+		putBytes(suffix, strlen(suffix));
+	}
+
+	unsigned int SmartThingsMQTT::topicLength(unsigned int nameLength, const char *suffix) const
+	{
+		return strlen(m_pTopicPrefix) + 1 + nameLength + strlen(suffix);
+	}
+
+	bool SmartThingsMQTT::endPacket()
+	{
+		if (m_nTransmitLength)
+		{
+			m_bTransmitFailed = m_bTransmitFailed || (m_Client.write(m_TransmitBuffer, m_nTransmitLength) != m_nTransmitLength);
+			m_nTransmitLength = 0;
+		}
+		m_lLastSendMillis = millis();
+		return !m_bTransmitFailed;
+	}
+
+	void SmartThingsMQTT::connectBroker()
+	{
+		m_lStateMillis = millis();
+
+		if (_isDebugEnabled)
+		{
+			Serial.print(F("SmartThingsMQTT: connecting to broker "));
+			Serial.print(m_BrokerIP);
+			Serial.print(F(":"));
+			Serial.println(m_nBrokerPort);
+		}
+
+		if (!m_Client.connect(m_BrokerIP, m_nBrokerPort))
+		{
+			if (_isDebugEnabled)
+			{
+				Serial.println(F("SmartThingsMQTT: connection to broker failed"));
+			}
+			return;
+		}
+
+		//clean session is left off, so the broker keeps this client's subscriptions while it is away
+		byte flags = 0x04 | 0x20;		//retained last will, at QoS 0
+		unsigned long length = 10 + 2 + strlen(m_pClientId) + 2 + topicLength(strlen(STATUS_TOPIC), "") + 2 + 7;
+		if (m_pUser)
+		{
+			flags |= 0x80;
+			length += 2 + strlen(m_pUser);
+			if (m_pPassword)
+			{
+				flags |= 0x40;
+				length += 2 + strlen(m_pPassword);
+			}
+		}
+
+		beginPacket(MQTT_CONNECT, length);
+		putString("MQTT");
+		putByte(4);						//protocol level 3.1.1
+		putByte(flags);
+		putWord(KEEP_ALIVE);
+		putString(m_pClientId);
+		putTopic(STATUS_TOPIC, strlen(STATUS_TOPIC), "");
+		putString("offline");
+		if (m_pUser)
+		{
+			putString(m_pUser);
+			if (m_pPassword)
+			{
+				putString(m_pPassword);
+			}
+		}
+
+		if (!endPacket())
+		{
+			disconnectBroker(false);
+			return;
+		}
+
+		m_State = MQTT_CONNECTING;
+		m_ReceiveState = RX_TYPE;
+		m_lLastReceiveMillis = millis();
+		m_bPingOutstanding = false;
+	}
+
+	void SmartThingsMQTT::disconnectBroker(bool graceful)
+	{
+		if (graceful && (m_State == MQTT_CONNECTED))
+		{
+			beginPacket(MQTT_DISCONNECT, 0);	//the broker does not publish the last will after a clean disconnect
+			endPacket();
+		}
+		m_Client.stop();
+
+		if (_isDebugEnabled && (m_State != MQTT_DISCONNECTED))
+		{
+			Serial.println(F("SmartThingsMQTT: disconnected from broker"));
+		}
+		m_State = MQTT_DISCONNECTED;
+		m_lStateMillis = millis();
+	}
+
+	void SmartThingsMQTT::subscribe()
+	{
+		uint16_t packetId = m_nNextPacketId++;
+		if (!m_nNextPacketId)
+		{
+			m_nNextPacketId = 1;
+		}
+
+		beginPacket(MQTT_SUBSCRIBE, 2 + 2 + topicLength(1, SET_SUFFIX) + 1 + 2 + topicLength(strlen(COMMAND_TOPIC), "") + 1);
+		putWord(packetId);
+		putTopic("+", 1, SET_SUFFIX);
+		putByte(1);
+		putTopic(COMMAND_TOPIC, strlen(COMMAND_TOPIC), "");
+		putByte(1);
+		endPacket();
+	}
+
+	void SmartThingsMQTT::publish(const char *message, unsigned int length, byte qos, uint16_t packetId, bool dup)
+	{
+		//"temperature1 72.5" is published to <prefix>/temperature1 as "72.5"
+		unsigned int nameLength = 0;
+		while ((nameLength < length) && (message[nameLength] != ' '))
+		{
+			++nameLength;
+		}
+		unsigned int valueStart = nameLength < length ? nameLength + 1 : length;
+
+		beginPacket(MQTT_PUBLISH | (dup ? 0x08 : 0) | (qos << 1), 2 + topicLength(nameLength, "") + (qos ? 2 : 0) + (length - valueStart));
+		putTopic(message, nameLength, "");
+		if (qos)
+		{
+			putWord(packetId);
+		}
+		putBytes(message + valueStart, length - valueStart);
+		if (!endPacket())
+		{
+			disconnectBroker(false);	//the message stays queued, and goes out again after reconnecting
+		}
+	}
+
+	byte SmartThingsMQTT::qosFor(const char *message, unsigned int length) const
+	{
+		for (byte i = 0; i < m_nQosRules; ++i)
+		{
+			unsigned int ruleLength = strlen(m_QosRules[i].name);
+			if ((ruleLength <= length) && (strncmp(message, m_QosRules[i].name, ruleLength) == 0))
+			{
+				return m_QosRules[i].qos;
+			}
+		}
+		return m_nDefaultQos;
+	}
+
+	void SmartThingsMQTT::publishQueued()
+	{
+		for (byte n = 0; (n < MAX_PUBLISH_PER_RUN) && (m_State == MQTT_CONNECTED); ++n)
+		{
+			const char *message;
+			unsigned int length;
+			if (!m_SendQueue.front(message, length))
+			{
+				return;
+			}
+
+			if (m_nInFlightId)
+			{
+				//QoS 1 messages go one at a time, so the broker sees every message in the order it was sent
+				if (millis() - m_lInFlightMillis >= ACK_TIMEOUT)
+				{
+					m_lInFlightMillis = millis();
+					publish(message, length, 1, m_nInFlightId, true);
+				}
+				return;
+			}
+
+			if (qosFor(message, length) == 0)
+			{
+				publish(message, length, 0, 0, false);
+				if (m_State != MQTT_CONNECTED)
+				{
+					return;
+				}
+				reportSendResult(message, length, STSEND_OK);
+				m_SendQueue.pop();
+			}
+			else
+			{
+				m_nInFlightId = m_nNextPacketId++;
+				if (!m_nNextPacketId)
+				{
+					m_nNextPacketId = 1;
+				}
+				m_lInFlightMillis = millis();
+				publish(message, length, 1, m_nInFlightId, false);
+				return;
+			}
+		}
+	}
+
+	void SmartThingsMQTT::receive()
+	{
+		if (!m_Client.connected())
+		{
+			disconnectBroker(false);
+			return;
+		}
+
+		for (unsigned int n = 0; (n < 256) && m_Client.available(); ++n)
+		{
+			byte b = m_Client.read();
+
+			switch (m_ReceiveState)
+			{
+			case RX_TYPE:
+				m_nPacketHeader = b;
+				m_lPacketLength = 0;
+				m_nLengthShift = 0;
+				m_ReceiveState = RX_LENGTH;
+				break;
+
+			case RX_LENGTH:
+				m_lPacketLength |= (unsigned long)(b & 0x7F) << m_nLengthShift;
+				m_nLengthShift += 7;
+				if (!(b & 0x80))
+				{
+					m_lPacketRead = 0;
+					m_ReceiveState = RX_BODY;
+				}
+				break;
+
+			case RX_BODY:
+				if (m_lPacketRead < RECEIVE_BUFFER_SIZE)
+				{
+					m_ReceiveBuffer[m_lPacketRead] = b;
+				}
+				++m_lPacketRead;
+				break;
+			}
+
+			if ((m_ReceiveState == RX_BODY) && (m_lPacketRead == m_lPacketLength))
+			{
+				m_ReceiveState = RX_TYPE;
+				m_lLastReceiveMillis = millis();
+				handlePacket();
+				if (m_State == MQTT_DISCONNECTED)
+				{
+					return;
+				}
+			}
+		}
+	}
+
+	void SmartThingsMQTT::handlePacket()
+	{
+		if (m_lPacketLength > RECEIVE_BUFFER_SIZE)
+		{
+			if (_isDebugEnabled)
+			{
+				Serial.println(F("SmartThingsMQTT: packet from broker too long, skipped"));
+			}
+			return;
+		}
+
+		switch (m_nPacketHeader & 0xF0)
+		{
+		case MQTT_CONNACK:
+			if ((m_lPacketLength < 2) || (m_ReceiveBuffer[1] != 0))
+			{
+				if (_isDebugEnabled)
+				{
+					Serial.print(F("SmartThingsMQTT: broker refused connection, code "));
+					Serial.println(m_lPacketLength < 2 ? -1 : m_ReceiveBuffer[1]);
+				}
+				disconnectBroker(false);
+				return;
+			}
+
+			m_State = MQTT_CONNECTED;
+			if (_isDebugEnabled)
+			{
+				Serial.println(F("SmartThingsMQTT: connected to broker"));
+			}
+
+			if (!(m_ReceiveBuffer[0] & 0x01))
+			{
+				subscribe();	//no session was kept for us - subscribe again
+			}
+
+			beginPacket(MQTT_PUBLISH | 0x01, 2 + topicLength(strlen(STATUS_TOPIC), "") + 6);	//retained
+			putTopic(STATUS_TOPIC, strlen(STATUS_TOPIC), "");
+			putBytes("online", 6);
+			endPacket();
+
+			if (m_nInFlightId)
+			{
+				m_lInFlightMillis = millis() - ACK_TIMEOUT;		//the broker may not have it - send it again straight away
+			}
+			break;
+
+		case MQTT_PUBLISH:
+			handlePublish(m_ReceiveBuffer, m_lPacketLength, (m_nPacketHeader >> 1) & 0x03);
+			break;
+
+		case MQTT_PUBACK:
+			if ((m_lPacketLength >= 2) && m_nInFlightId && ((((uint16_t)m_ReceiveBuffer[0] << 8) | m_ReceiveBuffer[1]) == m_nInFlightId))
+			{
+				const char *message;
+				unsigned int length;
+				if (m_SendQueue.front(message, length))
+				{
+					reportSendResult(message, length, STSEND_OK);
+					m_SendQueue.pop();
+				}
+				m_nInFlightId = 0;
+			}
+			break;
+
+		case MQTT_PINGRESP:
+			m_bPingOutstanding = false;
+			break;
+
+		case MQTT_SUBACK:
+		default:
+			break;
+		}
+	}
+
+	void SmartThingsMQTT::handlePublish(const byte *packet, unsigned int length, byte qos)
+	{
+		if (length < 2)
+		{
+			return;
+		}
+		unsigned int topicLen = ((unsigned int)packet[0] << 8) | packet[1];
+		unsigned int payloadStart = 2 + topicLen + (qos ? 2 : 0);
+		if (payloadStart > length)
+		{
+			return;
+		}
+		const char *topic = (const char *)packet + 2;
+		const char *payload = (const char *)packet + payloadStart;
+		unsigned int payloadLength = length - payloadStart;
+		unsigned int prefixLength = strlen(m_pTopicPrefix);
+		unsigned int setLength = strlen(SET_SUFFIX);
+
+		char command[RECEIVE_BUFFER_SIZE + 1];
+		unsigned int commandLength = 0;
+
+		if ((topicLen > prefixLength + 1) && (strncmp(topic, m_pTopicPrefix, prefixLength) == 0) && (topic[prefixLength] == '/'))
+		{
+			const char *name = topic + prefixLength + 1;
+			unsigned int nameLength = topicLen - prefixLength - 1;
+
+			if ((nameLength == strlen(COMMAND_TOPIC)) && (strncmp(name, COMMAND_TOPIC, nameLength) == 0))
+			{
+				//<prefix>/cmd "refresh" - the payload is the whole command
+				memcpy(command, payload, payloadLength);
+				commandLength = payloadLength;
+			}
+			else if ((nameLength > setLength) && (strncmp(name + nameLength - setLength, SET_SUFFIX, setLength) == 0))
+			{
+				//<prefix>/switch1/set "on" - becomes "switch1 on"
+				nameLength -= setLength;
+				memcpy(command, name, nameLength);
+				command[nameLength] = ' ';
+				memcpy(command + nameLength + 1, payload, payloadLength);
+				commandLength = nameLength + 1 + payloadLength;
+			}
+		}
+
+		if (qos)
+		{
+			beginPacket(MQTT_PUBACK, 2);
+			putBytes(packet + 2 + topicLen, 2);		//packet id
+			endPacket();
+		}
+
+		if (commandLength)
+		{
+			command[commandLength] = 0;
+			if (_isDebugEnabled)
+			{
+				Serial.print(F("Handling request from broker. command = "));
+				Serial.println(command);
+			}
+			deliverCommand(command, commandLength);
+		}
+	}
+
+//public
+	//*******************************************************************************
+	/// SmartThingsMQTT Constructor
+	//*******************************************************************************
+	SmartThingsMQTT::SmartThingsMQTT(Client &client, IPAddress brokerIP, uint16_t brokerPort, const char *clientId, const char *topicPrefix, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) :
+		SmartThings(callout, shieldType, enableDebug, transmitInterval),
+		m_Client(client),
+		m_BrokerIP(brokerIP),
+		m_nBrokerPort(brokerPort),
+		m_pClientId(clientId),
+		m_pTopicPrefix(topicPrefix),
+		m_pUser(0),
+		m_pPassword(0),
+		m_State(MQTT_DISCONNECTED),
+		m_lStateMillis(0),
+		m_lLastSendMillis(0),
+		m_lLastReceiveMillis(0),
+		m_bPingOutstanding(false),
+		m_SendQueue(m_SendBuffer, sizeof(m_SendBuffer)),
+		m_nNextPacketId(1),
+		m_nInFlightId(0),
+		m_lInFlightMillis(0),
+		m_nQosRules(0),
+		m_nDefaultQos(0),
+		m_ReceiveState(RX_TYPE),
+		m_nPacketHeader(0),
+		m_lPacketLength(0),
+		m_lPacketRead(0),
+		m_nLengthShift(0),
+		m_nTransmitLength(0),
+		m_bTransmitFailed(false)
+	{
+	}
+
+	//*****************************************************************************
+	//SmartThingsMQTT::~SmartThingsMQTT()
+	//*****************************************************************************
+	SmartThingsMQTT::~SmartThingsMQTT()
+	{
+	}
+
+	bool SmartThingsMQTT::setQos(const char *name, byte qos)
+	{
+		if (m_nQosRules == MAX_QOS_RULES)
+		{
+			return false;
+		}
+		m_QosRules[m_nQosRules].name = name;
+		m_QosRules[m_nQosRules].qos = qos > 1 ? 1 : qos;
+		++m_nQosRules;
+		return true;
+	}
+
+	//*******************************************************************************
+	/// Initialize SmartThingsMQTT Library
+	//*******************************************************************************
+	void SmartThingsMQTT::init(void)
+	{
+		if (_isDebugEnabled)
+		{
+			Serial.println(F(""));
+			Serial.println(F("Enabling ST_Anything MQTT Library"));
+			Serial.print(F("Broker = "));
+			Serial.print(m_BrokerIP);
+			Serial.print(F(":"));
+			Serial.println(m_nBrokerPort);
+			Serial.print(F("Client id = "));
+			Serial.println(m_pClientId);
+			Serial.print(F("Topic prefix = "));
+			Serial.println(m_pTopicPrefix);
+			Serial.println(F(""));
+		}
+
+		disconnectBroker(false);
+		connectBroker();
+	}
+
+	//*****************************************************************************
+	// Run SmartThingsMQTT Library
+	//*****************************************************************************
+	void SmartThingsMQTT::run(void)
+	{
+		switch (m_State)
+		{
+		case MQTT_DISCONNECTED:
+			if (millis() - m_lStateMillis >= RECONNECT_INTERVAL)
+			{
+				connectBroker();
+			}
+			break;
+
+		case MQTT_CONNECTING:
+			receive();
+			if ((m_State == MQTT_CONNECTING) && (millis() - m_lStateMillis >= ACK_TIMEOUT))
+			{
+				if (_isDebugEnabled)
+				{
+					Serial.println(F("SmartThingsMQTT: no CONNACK from broker"));
+				}
+				disconnectBroker(false);
+			}
+			break;
+
+		case MQTT_CONNECTED:
+			receive();
+			if (m_State != MQTT_CONNECTED)
+			{
+				break;
+			}
+
+			publishQueued();
+			if (m_State != MQTT_CONNECTED)
+			{
+				break;
+			}
+
+			if (m_bPingOutstanding && (millis() - m_lLastReceiveMillis >= KEEP_ALIVE * 1000UL))
+			{
+				if (_isDebugEnabled)
+				{
+					Serial.println(F("SmartThingsMQTT: broker stopped answering"));
+				}
+				disconnectBroker(false);
+			}
+			else if (!m_bPingOutstanding && (millis() - m_lLastSendMillis >= KEEP_ALIVE * 500UL))
+			{
+				beginPacket(MQTT_PINGREQ, 0);
+				m_bPingOutstanding = endPacket();
+			}
+			break;
+		}
+	}
+
+	//*******************************************************************************
+	/// Queue Message for the broker
+	//*******************************************************************************
+	void SmartThingsMQTT::send(String message)
+	{
+		send(message.c_str(), message.length());
+	}
+
+	//*******************************************************************************
+	/// Queue Message for the broker - message need not be null terminated
+	//*******************************************************************************
+	void SmartThingsMQTT::send(const char *message, unsigned int length)
+	{
+		if (!m_SendQueue.push(message, length))
+		{
+			if (_isDebugEnabled)
+			{
+				Serial.println(F("SmartThingsMQTT: send queue full, message dropped"));
+			}
+			reportSendResult(message, length, STSEND_OVERFLOW);
+			return;
+		}
+
+		if (m_State == MQTT_CONNECTED)
+		{
+			publishQueued();	//QoS 0 messages go straight out when nothing is waiting for an acknowledgement
+		}
+	}
+
+	//*******************************************************************************
+	/// Puts device into Deepsleep
+	//*******************************************************************************
+	void SmartThingsMQTT::deepSleep(uint64_t time)
+	{
+		unsigned long start = millis();
+		while (!m_SendQueue.isEmpty() && (millis() - start < 2 * ACK_TIMEOUT))
+		{
+			run();
+			yield();
+		}
+		disconnectBroker(true);
+
+	#if defined(ARDUINO_ARCH_ESP8266)
+		ESP.deepSleep(time);
+	#elif defined(ARDUINO_ARCH_ESP32)
+		esp_deep_sleep(time);
+	#endif
+	}
+}
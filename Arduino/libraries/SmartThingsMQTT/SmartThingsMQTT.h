@@ -0,0 +1,196 @@
+//*******************************************************************************
+//	SmartThings Arduino MQTT Library - publishes to an MQTT broker (e.g. Mosquitto)
+//                                     instead of POSTing to the hub
+//
+//	Summary:  Works over any connected network - the sketch brings up WiFi or
+//			  Ethernet and passes in a Client (WiFiClient, EthernetClient, ...).
+//			  A minimal MQTT 3.1.1 client is built in, so no other library is needed.
+//
+//			  Topics, with topicPrefix "st/node1":
+//				st/node1/temperature1	<- "72.5"		(one topic per device, from the
+//				st/node1/switch1		<- "on"			 device name of each message)
+//				st/node1/status			<- "online"/"offline" (retained, last will)
+//				st/node1/switch1/set	-> "off"		becomes the command "switch1 off"
+//				st/node1/cmd			-> "refresh"	passed on as the whole command
+//
+//			  The session is persistent (clean session off), so the broker keeps the
+//			  subscriptions and queued QoS 1 commands while the board is away.
+//			  Each message is published at QoS 0 unless setQos() names its device
+//			  class (e.g. "button", "contact") for QoS 1.  QoS 1 messages are kept
+//			  until the broker acknowledges them, and sent again after a reconnect.
+//
+//			  send() only queues the message - run() publishes it, reads the broker
+//			  and keeps the connection alive without waiting.  Only the TCP connect
+//			  itself blocks (for the network library's connect timeout), and is tried
+//			  at most once every RECONNECT_INTERVAL.
+//
+//	License
+//	(C) Copyright 2017 Dan Ogorchock
+//
+//	History
+//	2026-10-16  a00889920      Created
+//*******************************************************************************
+
+#ifndef __SMARTTHINGSMQTT_H__
+#define __SMARTTHINGSMQTT_H__
+
+#include "SmartThings.h"
+#include "MessageQueue.h"
+#include <IPAddress.h>
+#include <Client.h>
+
+namespace st
+{
+	class SmartThingsMQTT: public SmartThings
+	{
+	private:
+		typedef enum
+		{
+			MQTT_DISCONNECTED,
+			MQTT_CONNECTING,		//CONNECT sent, waiting for CONNACK
+			MQTT_CONNECTED
+		} MqttState_t;
+
+		typedef enum
+		{
+			RX_TYPE,				//first byte of the fixed header
+			RX_LENGTH,				//remaining length, 1 to 4 bytes
+			RX_BODY					//remaining length bytes of packet
+		} ReceiveState_t;
+
+		static const unsigned int SEND_BUFFER_SIZE = 512;		//bytes of messages waiting to be published
+		static const byte RECEIVE_BUFFER_SIZE = 128;			//largest packet read from the broker - longer ones are skipped
+		static const byte TRANSMIT_BUFFER_SIZE = 64;			//packets are written to the Client in pieces of up to this size
+		static const byte MAX_QOS_RULES = 8;
+		static const byte MAX_PUBLISH_PER_RUN = 4;				//messages published per run(), so loop() is never held up for long
+		static const unsigned long RECONNECT_INTERVAL = 5000;	//ms between connection attempts
+		static const unsigned long ACK_TIMEOUT = 5000;			//ms to wait for CONNACK or PUBACK
+		static const uint16_t KEEP_ALIVE = 60;					//seconds
+
+		struct QosRule
+		{
+			const char *name;		//device name prefix, e.g. "button"
+			byte qos;
+		};
+
+		Client &m_Client;
+		IPAddress m_BrokerIP;
+		uint16_t m_nBrokerPort;
+		const char *m_pClientId;
+		const char *m_pTopicPrefix;
+		const char *m_pUser;
+		const char *m_pPassword;
+
+		MqttState_t m_State;
+		unsigned long m_lStateMillis;		//time of the last connection attempt
+		unsigned long m_lLastSendMillis;	//time of the last packet written to the broker
+		unsigned long m_lLastReceiveMillis;	//time of the last packet read from the broker
+		bool m_bPingOutstanding;
+
+		byte m_SendBuffer[SEND_BUFFER_SIZE];
+		MessageQueue m_SendQueue;
+		uint16_t m_nNextPacketId;
+		uint16_t m_nInFlightId;				//packet id of the QoS 1 message at the front of m_SendQueue (0 = none)
+		unsigned long m_lInFlightMillis;
+
+		QosRule m_QosRules[MAX_QOS_RULES];
+		byte m_nQosRules;
+		byte m_nDefaultQos;
+
+		ReceiveState_t m_ReceiveState;
+		byte m_nPacketHeader;
+		unsigned long m_lPacketLength;		//remaining length of the packet being read
+		unsigned long m_lPacketRead;		//bytes of it read so far
+		byte m_nLengthShift;
+		byte m_ReceiveBuffer[RECEIVE_BUFFER_SIZE];
+
+		byte m_TransmitBuffer[TRANSMIT_BUFFER_SIZE];
+		byte m_nTransmitLength;
+		bool m_bTransmitFailed;
+
+		void connectBroker();
+		void disconnectBroker(bool graceful);
+		void receive();
+		void handlePacket();
+		void handlePublish(const byte *packet, unsigned int length, byte qos);
+		void publishQueued();
+		void publish(const char *message, unsigned int length, byte qos, uint16_t packetId, bool dup);
+		byte qosFor(const char *message, unsigned int length) const;
+		void subscribe();
+
+		//packet writing - bytes are gathered in m_TransmitBuffer and written in pieces
+		void beginPacket(byte header, unsigned long remainingLength);
+		void putByte(byte b);
+		void putBytes(const void *data, unsigned int length);
+		void putWord(uint16_t value);
+		void putString(const char *text);
+		void putTopic(const char *name, unsigned int nameLength, const char *suffix);	//<prefix>/<name><suffix>
+		unsigned int topicLength(unsigned int nameLength, const char *suffix) const;
+		bool endPacket();
+
+	public:
+
+		//*******************************************************************************
+		/// @brief  SmartThings MQTT Constructor
+		///   @param[in] client - network client to reach the broker with (WiFiClient, EthernetClient, ...)
+		///   @param[in] brokerIP - TCP/IP Address of the MQTT broker
+		///   @param[in] brokerPort - TCP/IP Port of the MQTT broker (usually 1883)
+		///   @param[in] clientId - MQTT client id, unique to this board (kept, not copied)
+		///   @param[in] topicPrefix - start of every topic, e.g. "st/node1" (kept, not copied)
+		///   @param[in] callout - Set the Callout Function that is called on Msg Reception
+		///   @param[in] shieldType (optional) - Set the Reported SheildType to the Server
+		///   @param[in] enableDebug (optional) - Enable internal Library debug
+		///   @param[in] transmitInterval (optional) - Interval for transmiting
+		//*******************************************************************************
+		SmartThingsMQTT(Client &client, IPAddress brokerIP, uint16_t brokerPort, const char *clientId, const char *topicPrefix, SmartThingsCallout_t *callout, String shieldType = "MQTT", bool enableDebug = false, int transmitInterval = 100);
+
+		//*******************************************************************************
+		/// Destructor
+		//*******************************************************************************
+		~SmartThingsMQTT();
+
+		//*******************************************************************************
+		/// Sets the user name and password sent to the broker - call before init() (kept, not copied)
+		//*******************************************************************************
+		void setCredentials(const char *user, const char *password) { m_pUser = user; m_pPassword = password; }
+
+		//*******************************************************************************
+		/// Publishes messages whose device name starts with name (e.g. "button") at qos (0 or 1)
+		//*******************************************************************************
+		bool setQos(const char *name, byte qos);
+
+		//*******************************************************************************
+		/// QoS for messages that match no setQos() rule (0 unless changed)
+		//*******************************************************************************
+		void setDefaultQos(byte qos) { m_nDefaultQos = qos > 1 ? 1 : qos; }
+
+		//*******************************************************************************
+		/// Initialize SmartThingsMQTT Library - the network must already be up
+		//*******************************************************************************
+		virtual void init(void);
+
+		//*******************************************************************************
+		/// Run SmartThingsMQTT Library - publishes, reads the broker, keeps the connection alive
+		//*******************************************************************************
+		virtual void run(void);
+
+		//*******************************************************************************
+		/// Queue a Message for the broker
+		//*******************************************************************************
+		virtual void send(String message);
+
+		//*******************************************************************************
+		/// Queue a Message for the broker - message need not be null terminated
+		//*******************************************************************************
+		virtual void send(const char *message, unsigned int length);
+
+		//*******************************************************************************
+		/// Publishes what is queued, disconnects cleanly, then puts an ESP8266 or ESP32
+		/// into deep sleep for time microseconds
+		//*******************************************************************************
+		virtual void deepSleep(uint64_t time);
+
+		bool isConnected() const { return m_State == MQTT_CONNECTED; }
+	};
+}
+#endif
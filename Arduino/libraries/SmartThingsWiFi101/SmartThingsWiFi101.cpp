@@ -12,6 +12,13 @@
 //  2018-01-06  Dan Ogorchock  Simplified the MAC address printout to prevent confusion
 //  2018-02-03  Dan Ogorchock  Support for Hubitat
 //  2020-04-05  Dan Ogorchock  Tweaked to hopefully prevent lockup
+//  2026-10-16  a00889920      Added send() overload taking a message buffer and length, uses shared postMessage()
+//  2026-10-16  a00889920      Added sendBatch() to POST several messages in one connection
+//  2026-10-16  a00889920      sendBatch() uses postToHub()/releaseConnection(), so setKeepAlive() can keep the hub connection open
+//  2026-10-16  a00889920      run() uses serviceInbound() - hub requests are parsed as they arrive, without String or a blocking read loop
+//  2026-10-16  a00889920      sendBatch() and run() support the optional UDP datagram link (setDatagramLink)
+//  2026-10-16  a00889920      sendBatch() keeps messages it cannot send in the optional journal (setJournal), run() sends them later
+//  2026-10-16  a00889920      Failed sends go to the shared retry queue (backoff and circuit breaker) instead of one immediate resend
 //*******************************************************************************
 
 #include "SmartThingsWiFi101.h"
@@ -124,10 +131,12 @@ namespace st
 	//*****************************************************************************
 	void SmartThingsWiFi101::run(void)
 	{
-		String readString;
-		String tempString;
 		String strRSSI;
 
+		checkConnection(st_client);	//closes a kept-alive connection to the hub once it is idle or closed by the hub
+		serviceDatagrams();			//reads the hub's acknowledgements of UDP datagrams and resends any overdue
+		serviceRetries();			//resends messages that could not be sent, once their backoff has passed
+
 		if (WiFi.status() != WL_CONNECTED)
 		{
 			if (_isDebugEnabled)
@@ -161,78 +170,7 @@ namespace st
 			}
 		}
 
-		WiFiClient client = st_server.available();
-		if (client) {
-			boolean currentLineIsBlank = true;
-			while (client.connected()) {
-				if (client.available()) {
-					char c = client.read();
-					//read char by char HTTP request
-					if (readString.length() < 200) {
-						//store characters to string
-						readString += c;
-					}
-					else
-					{
-						if (_isDebugEnabled)
-						{
-							Serial.println(F(""));
-							Serial.println(F("SmartThings.run() - Exceeded 200 character limit"));
-							Serial.println(F(""));
-						}
-					}
-					// if you've gotten to the end of the line (received a newline
-					// character) and the line is blank, the http request has ended,
-					// so you can send a reply
-					if (c == '\n' && currentLineIsBlank) {
-						//now output HTML data header
-						tempString = readString.substring(readString.indexOf('/') + 1, readString.indexOf('?'));
-
-						if (tempString.length() > 0) {
-							client.println(F("HTTP/1.1 200 OK")); //send new page
-							client.println();
-							}
-						else {
-							client.println(F("HTTP/1.1 204 No Content"));
-							client.println();
-							client.println();
-							if (_isDebugEnabled)
-							{
-								Serial.println(F("No Valid Data Received"));
-							}
-						}
-						break;
-					}
-					if (c == '\n') {
-						// you're starting a new line
-						currentLineIsBlank = true;
-					}
-					else if (c != '\r') {
-						// you've gotten a character on the current line
-						currentLineIsBlank = false;
-					}
-				}
-			}
-
-			delay(1);
-			//stopping client
-			client.stop();
-
-			//Handle the received data after cleaning up the network connection
-			if (tempString.length() > 0) {
-				if (_isDebugEnabled)
-				{
-					Serial.print(F("Handling request from ST. tempString = "));
-					Serial.println(tempString);
-				}
-				//Pass the message to user's SmartThings callout function
-				tempString.replace("%20", " ");  //Clean up for Hubitat
-				_calloutFunction(tempString);
-			}
-
-			readString = "";
-			tempString = "";
-		}
+		serviceInbound(st_server, st_inbound);	//reads and answers the hub's requests as they arrive - never waits
 	}
 
 	//*******************************************************************************
@@ -240,6 +178,32 @@ namespace st
 	//*******************************************************************************
 	void SmartThingsWiFi101::send(String message)
 	{
+		send(message.c_str(), message.length());
+	}
+
+	//*******************************************************************************
+	/// Send Message out over Ethernet to the Hub - message need not be null terminated
+	//*******************************************************************************
+	void SmartThingsWiFi101::send(const char *message, unsigned int length)
+	{
+		sendBatch(&message, &length, 1);
+	}
+
+	//*******************************************************************************
+	/// Send several Messages out over Ethernet to the Hub in one HTTP POST, one message per line
+	//*******************************************************************************
+	void SmartThingsWiFi101::sendBatch(const char * const *messages, const unsigned int *lengths, byte count)
+	{
+		if (sendDatagrams(messages, lengths, count))
+		{
+			return;		//sent as a UDP datagram - acknowledged or resent from run()
+		}
+
+		if (holdMessages(messages, lengths, count))
+		{
+			return;		//sent from run() after the messages already waiting to be resent
+		}
+
 		if (WiFi.status() != WL_CONNECTED)
 		{
 			Serial.println(F("**********************************************************"));
@@ -249,23 +213,7 @@ namespace st
 			init();
 		}
 
-		//Make sure the client is stopped, to free up socket for new conenction
-		st_client.stop();
-
-		if (st_client.connect(st_hubIP, st_hubPort))
-		{
-			st_client.println(F("POST / HTTP/1.1"));
-			st_client.print(F("HOST: "));
-			st_client.print(st_hubIP);
-			st_client.print(F(":"));
-			st_client.println(st_hubPort);
-			st_client.println(F("CONTENT-TYPE: text"));
-			st_client.print(F("CONTENT-LENGTH: "));
-			st_client.println(message.length());
-			st_client.println();
-			st_client.println(message);
-		}
-		else
+		if (!postToHub(st_client, messages, lengths, count))
 		{
 			//connection failed;
 			if (_isDebugEnabled)
@@ -287,43 +235,12 @@ namespace st
 			WiFi.end();  //End current broken WiFi Connection
 			init();      //Re-Init connection to get things working again
 
-			if (_isDebugEnabled)
-			{
-				Serial.println(F("***********************************************************"));
-				Serial.println(F("******        Attempting to resend missed data      *******"));
-				Serial.println(F("***********************************************************"));
-			}
-			
-
-			st_client.flush();
 			st_client.stop();
-			if (st_client.connect(st_hubIP, st_hubPort))
-			{
-				st_client.println(F("POST / HTTP/1.1"));
-				st_client.print(F("HOST: "));
-				st_client.print(st_hubIP);
-				st_client.print(F(":"));
-				st_client.println(st_hubPort);
-				st_client.println(F("CONTENT-TYPE: text"));
-				st_client.print(F("CONTENT-LENGTH: "));
-				st_client.println(message.length());
-				st_client.println();
-				st_client.println(message);
-			}
-
-		}
+			retryLater(messages, lengths, count);	//retried from run(), with backoff
 
-		//if (_isDebugEnabled) { Serial.println(F("WiFi.send(): Reading for reply data "));}
-		// read any data returned from the POST
-		//while (st_client.connected()) {
-		while (st_client.available()) {
-				char c = st_client.read(); //gets byte from ethernet buffer
-				//if (_isDebugEnabled) { Serial.print(c); } //prints byte to serial monitor
-			//}
 		}
 
-		delay(1);
-		st_client.stop();
+		releaseConnection(st_client);
 	}
 
 }
@@ -11,6 +11,9 @@
 //  2019-05-01  Dan Ogorchock  Changed max transmit rate from every 100ms to every 
 //                             500ms to prevent duplicate child devices
 //  2020-08-22  a00889920      Added deepSleep() function
+//  2026-10-16  a00889920      Added send() overload taking a message buffer and length, uses shared postMessage()
+//  2026-10-16  a00889920      Added sendBatch() to POST several messages in one connection
+//  2026-10-16  a00889920      Added st_inbound - slots for the hub's connections to the device's server
 //*******************************************************************************
 
 #ifndef __SMARTTHINGSWIFI101_H__ 
@@ -36,6 +39,7 @@ namespace st
 		char st_password[50];
 		WiFiServer st_server; //server
 		WiFiClient st_client; //client
+		InboundSlot<WiFiClient> st_inbound[2]; //connections from the hub
 		long previousMillis;
 		long RSSIsendInterval;
 
@@ -91,6 +95,16 @@ namespace st
 		//*******************************************************************************
 		virtual void send(String message);
 
+		//*******************************************************************************
+		/// Send Message to the Hub - message need not be null terminated
+		//*******************************************************************************
+		virtual void send(const char *message, unsigned int length);
+
+		//*******************************************************************************
+		/// Send several Messages to the Hub in one HTTP POST, one message per line
+		//*******************************************************************************
+		virtual void sendBatch(const char * const *messages, const unsigned int *lengths, byte count);
+
 		//*******************************************************************************
 		/// Puts device into Deepsleep 
 		//*******************************************************************************
@@ -10,6 +10,11 @@
 //  2018-01-06  Dan Ogorchock  Simplified the MAC address printout to prevent confusion
 //  2018-02-03  Dan Ogorchock  Support for Hubitat
 //  2020-04-05  Dan Ogorchock  Tweaked to hopefully prevent lockup
+//  2026-10-16  a00889920      Added send() overload taking a message buffer and length, uses shared postMessage()
+//  2026-10-16  a00889920      Added sendBatch() to POST several messages in one connection
+//  2026-10-16  a00889920      sendBatch() keeps messages it cannot send in the optional journal (setJournal), run() sends them later
+//  2026-10-16  a00889920      Failed sends go to the shared retry queue (backoff and circuit breaker) instead of one immediate resend
+//  2026-10-16  a00889920      init() no longer blocks - run() brings the ESP-01 up with WiFi.startInit()/pollInit() while the sensors start
 //*******************************************************************************
 
 #include "SmartThingsWiFiEsp.h"
@@ -22,7 +27,9 @@ namespace st
 	SmartThingsWiFiEsp::SmartThingsWiFiEsp(Stream *espSerial, String ssid, String password, IPAddress localIP, uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) :
 		SmartThingsEthernet(localIP, serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, false),
 		st_server(serverPort),
-		st_espSerial(espSerial)
+		st_espSerial(espSerial),
+		st_linkReady(false),
+		st_initMillis(0)
 	{
 		ssid.toCharArray(st_ssid, sizeof(st_ssid));
 		password.toCharArray(st_password, sizeof(st_password));
@@ -34,7 +41,9 @@ namespace st
 	SmartThingsWiFiEsp::SmartThingsWiFiEsp(Stream *espSerial, String ssid, String password, uint16_t serverPort, IPAddress hubIP, uint16_t hubPort, SmartThingsCallout_t *callout, String shieldType, bool enableDebug, int transmitInterval) :
 		SmartThingsEthernet(serverPort, hubIP, hubPort, callout, shieldType, enableDebug, transmitInterval, true),
 		st_server(serverPort),
-		st_espSerial(espSerial)
+		st_espSerial(espSerial),
+		st_linkReady(false),
+		st_initMillis(0)
 	{
 		ssid.toCharArray(st_ssid, sizeof(st_ssid));
 		password.toCharArray(st_password, sizeof(st_password));
@@ -54,29 +63,41 @@ namespace st
 	//*******************************************************************************
 	void SmartThingsWiFiEsp::init(void)
 	{
-		int status = WL_IDLE_STATUS;     // the Wifi radio's status
-
 		Serial.println(F(""));
-		Serial.println(F("Initializing WiFiEsp network.  Please be patient..."));
+		Serial.println(F("Initializing WiFiEsp network.  Sensors start now, the hub is reached once WiFi is up..."));
+		Serial.print(F("Attempting to connect to WPA SSID: "));
+		Serial.println(st_ssid);
 
-		// Initialize the WiFiEsp library
-		WiFi.init(st_espSerial);
+		// Initialize the ESP-01 and join the WiFi network - returns at once, run() carries on until the module is connected
+		st_linkReady = false;
+		st_initMillis = millis();
+		WiFi.startInit(st_espSerial, st_ssid, st_password);
+	}
 
-		// check for the presence of the shield
-		if (WiFi.status() == WL_NO_SHIELD) {
-			Serial.println("ESP WiFi shield not present");
-			// don't continue
-			while (true);
+	//*******************************************************************************
+	/// Moves the ESP-01's init along - finishes the job once it has joined the network
+	//*******************************************************************************
+	void SmartThingsWiFiEsp::serviceInit(void)
+	{
+		switch (WiFi.pollInit())
+		{
+		case WL_CONNECTED:
+			finishInit();
+			break;
+
+		case WL_NO_SHIELD:
+			Serial.println(F("ESP WiFi shield not present - trying again"));
+			WiFi.startInit(st_espSerial, st_ssid, st_password);
+			break;
 		}
+	}
 
-		// attempt to connect to WiFi network
-		while (status != WL_CONNECTED) {
-			Serial.print("Attempting to connect to WPA SSID: ");
-			Serial.println(st_ssid);
-			// Connect to WPA/WPA2 network
-			status = WiFi.begin(st_ssid, st_password);
-			delay(1000);
-		}
+	//*******************************************************************************
+	/// The ESP-01 has joined the network - starts the server and reports the settings
+	//*******************************************************************************
+	void SmartThingsWiFiEsp::finishInit(void)
+	{
+		st_linkReady = true;
 
 		if (st_DHCP == false)
 		{
@@ -112,7 +133,9 @@ namespace st
 		Serial.print(F("RSSI = "));
 		Serial.println(WiFi.RSSI());
 		Serial.println(F(""));
-		Serial.println(F("SmartThingsWiFiEsp: Intialized"));
+		Serial.print(F("SmartThingsWiFiEsp: Intialized in "));
+		Serial.print(millis() - st_initMillis);
+		Serial.println(F(" ms"));
 		Serial.println(F(""));
 
 		RSSIsendInterval = 5000;
@@ -128,6 +151,14 @@ namespace st
 		String tempString;
 		String strRSSI;
 
+		if (!st_linkReady)
+		{
+			serviceInit();
+			return;		//nothing can be sent or received until the ESP-01 has joined the network
+		}
+
+		serviceRetries();	//resends messages that could not be sent, once their backoff has passed
+
 		//if (WiFi.status() != WL_CONNECTED)
 		//{
 		//	Serial.println(F("**********************************************************"));
@@ -237,6 +268,33 @@ namespace st
 	//*******************************************************************************
 	void SmartThingsWiFiEsp::send(String message)
 	{
+		send(message.c_str(), message.length());
+	}
+
+	//*******************************************************************************
+	/// Send Message out over Ethernet to the Hub - message need not be null terminated
+	//*******************************************************************************
+	void SmartThingsWiFiEsp::send(const char *message, unsigned int length)
+	{
+		sendBatch(&message, &length, 1);
+	}
+
+	//*******************************************************************************
+	/// Send several Messages out over Ethernet to the Hub in one HTTP POST, one message per line
+	//*******************************************************************************
+	void SmartThingsWiFiEsp::sendBatch(const char * const *messages, const unsigned int *lengths, byte count)
+	{
+		if (holdMessages(messages, lengths, count))
+		{
+			return;		//sent from run() after the messages already waiting to be resent
+		}
+
+		if (!st_linkReady)
+		{
+			retryLater(messages, lengths, count);	//sent from run() once the ESP-01 has joined the network
+			return;
+		}
+
 		st_client.stop();
 
 		//if (WiFi.status() != WL_CONNECTED)
@@ -253,19 +311,12 @@ namespace st
 
 		if (st_client.connect(st_hubIP, st_hubPort))
 		{
-			st_client.println(F("POST / HTTP/1.1"));
-			st_client.print(F("HOST: "));
-			st_client.print(st_hubIP);
-			st_client.print(F(":"));
-			st_client.println(st_hubPort);
-			st_client.println(F("CONTENT-TYPE: text"));
-			st_client.print(F("CONTENT-LENGTH: "));
-			st_client.println(message.length());
-			st_client.println();
-			st_client.println(message);
+			hubReached();
+			postMessages(st_client, messages, lengths, count);
 		}
 		else
 		{
+			hubFailed();	//backs off, and pauses connection attempts if the hub stays away
 			//connection failed;
 			if (_isDebugEnabled)
 			{
@@ -286,29 +337,8 @@ namespace st
 			//WiFi.reset();//End current broken WiFi Connection
 			//init();      //Re-Init connection to get things working again
 
-			if (_isDebugEnabled)
-			{
-				Serial.println(F("***********************************************************"));
-				Serial.println(F("******        Attempting to resend missed data      *******"));
-				Serial.println(F("***********************************************************"));
-			}
-
-
-			st_client.flush();
 			st_client.stop();
-			if (st_client.connect(st_hubIP, st_hubPort))
-			{
-				st_client.println(F("POST / HTTP/1.1"));
-				st_client.print(F("HOST: "));
-				st_client.print(st_hubIP);
-				st_client.print(F(":"));
-				st_client.println(st_hubPort);
-				st_client.println(F("CONTENT-TYPE: text"));
-				st_client.print(F("CONTENT-LENGTH: "));
-				st_client.println(message.length());
-				st_client.println();
-				st_client.println(message);
-			}
+			retryLater(messages, lengths, count);	//retried from run(), with backoff
 
 		}
 
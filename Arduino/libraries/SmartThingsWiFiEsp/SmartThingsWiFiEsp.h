@@ -10,6 +10,9 @@
 //  2019-05-01  Dan Ogorchock  Changed max transmit rate from every 100ms to every 
 //                             500ms to prevent duplicate child devices
 //  2020-08-22  a00889920      Added deepSleep() function
+//  2026-10-16  a00889920      Added send() overload taking a message buffer and length, uses shared postMessage()
+//  2026-10-16  a00889920      Added sendBatch() to POST several messages in one connection
+//  2026-10-16  a00889920      init() no longer blocks while the ESP-01 joins the network - see isReady()
 //*******************************************************************************
 
 #ifndef __SMARTTHINGSWIFIESP_H__ 
@@ -37,6 +40,11 @@ namespace st
 		Stream* st_espSerial;    //Serial UART used to commincate with the ESP-01 board
 		long previousMillis;
 		long RSSIsendInterval;
+		bool st_linkReady;       //true once the ESP-01 has joined the network
+		unsigned long st_initMillis;	//time init() was called
+
+		void serviceInit(void);  //moves the ESP-01's init along, from run()
+		void finishInit(void);   //starts the server once the ESP-01 has joined the network
 
 	public:
 
@@ -84,11 +92,26 @@ namespace st
 		//*******************************************************************************
 		virtual void run(void);
 
+		//*******************************************************************************
+		/// True once the ESP-01 has joined the WiFi network
+		//*******************************************************************************
+		virtual bool isReady() { return st_linkReady; }
+
 		//*******************************************************************************
 		/// Send Message to the Hub 
 		//*******************************************************************************
 		virtual void send(String message);
 
+		//*******************************************************************************
+		/// Send Message to the Hub - message need not be null terminated
+		//*******************************************************************************
+		virtual void send(const char *message, unsigned int length);
+
+		//*******************************************************************************
+		/// Send several Messages to the Hub in one HTTP POST, one message per line
+		//*******************************************************************************
+		virtual void sendBatch(const char * const *messages, const unsigned int *lengths, byte count);
+
 		//*******************************************************************************
 		/// Puts device into Deepsleep 
 		//*******************************************************************************
@@ -37,6 +37,20 @@ void WiFiEspClass::init(Stream* espSerial)
 	EspDrv::wifiDriverInit(espSerial);
 }
 
+void WiFiEspClass::startInit(Stream* espSerial, const char* ssid, const char* passphrase)
+{
+    LOGINFO(F("Initializing ESP module"));
+	EspDrv::wifiDriverInitStart(espSerial, ssid, passphrase);
+}
+
+uint8_t WiFiEspClass::pollInit()
+{
+	uint8_t status = EspDrv::wifiDriverInitPoll();
+	if (status == WL_CONNECTED)
+		espMode = 1;
+	return status;
+}
+
 
 
 char* WiFiEspClass::firmwareVersion()
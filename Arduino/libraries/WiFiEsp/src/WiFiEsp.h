@@ -51,6 +51,19 @@ public:
 	static void init(Stream* espSerial);
 
 
+	/**
+	* Non-blocking init() followed by begin(ssid, passphrase).
+	* startInit() returns at once; call pollInit() often (e.g. from loop()) until it
+	* returns WL_CONNECTED, or WL_NO_SHIELD if the module did not answer.  No other
+	* WiFi, client or server call may be made before then.
+	*
+	* param ssid, passphrase: kept, not copied - must stay valid until pollInit() is done.
+	* return: WL_IDLE_STATUS while busy, WL_CONNECTED or WL_NO_SHIELD
+	*/
+	static void startInit(Stream* espSerial, const char* ssid, const char* passphrase);
+	static uint8_t pollInit();
+
+
 	/**
 	* Get firmware version
 	*/
@@ -43,6 +43,21 @@ typedef enum
 	TAG_CONNECT
 } TagsEnum;
 
+typedef enum
+{
+	INIT_IDLE,
+	INIT_PROBE,			// "AT" until the module answers - it may still be starting up
+	INIT_RESET,			// "AT+RST", then wait for the module to print "ready"
+	INIT_SETUP,			// echo off, station mode, multiple connections, ...
+	INIT_JOIN,			// join the access point
+	INIT_JOIN_RETRY,	// a failed join is followed by more lines - let them pass before trying again
+	INIT_DONE,
+	INIT_FAILED
+} InitStateEnum;
+
+// commands sent by INIT_SETUP, in order (the same as reset())
+#define NUMINITSETUP 6
+
 
 Stream *EspDrv::espSerial;
 
@@ -66,6 +81,13 @@ uint8_t EspDrv::_connId=0;
 uint16_t EspDrv::_remotePort  =0;
 uint8_t EspDrv::_remoteIp[] = {0};
 
+uint8_t EspDrv::_initState = INIT_IDLE;
+uint8_t EspDrv::_initStep = 0;
+uint8_t EspDrv::_initTries = 0;
+unsigned long EspDrv::_initMillis = 0;
+const char* EspDrv::_initSsid = 0;
+const char* EspDrv::_initPassphrase = 0;
+
 
 void EspDrv::wifiDriverInit(Stream *espSerial)
 {
@@ -77,18 +99,17 @@ void EspDrv::wifiDriverInit(Stream *espSerial)
 	
 	for(int i=0; i<5; i++)
 	{
+		// sendCmd() waits up to a second for the reply - no need to wait again
 		if (sendCmd(F("AT")) == TAG_OK)
 		{
 			initOK=true;
 			break;
 		}
-		delay(1000);
 	}
 
 	if (!initOK)
 	{
 		LOGERROR(F("Cannot initialize ESP module"));
-		delay(5000);
 		return;
 	}
 
@@ -102,7 +123,6 @@ void EspDrv::wifiDriverInit(Stream *espSerial)
 		fwVersion[1] != '.')
 	{
 		LOGWARN1(F("Warning: Unsupported firmware"), fwVersion);
-		delay(4000);
 	}
 	else
 	{
@@ -111,12 +131,143 @@ void EspDrv::wifiDriverInit(Stream *espSerial)
 }
 
 
+void EspDrv::wifiDriverInitStart(Stream *espSerial, const char* ssid, const char* passphrase)
+{
+	LOGDEBUG(F("> wifiDriverInitStart"));
+
+	EspDrv::espSerial = espSerial;
+	_initSsid = ssid;
+	_initPassphrase = passphrase;
+	_initTries = 0;
+
+	startCmd(F("AT"));
+	nextInitState(INIT_PROBE);
+}
+
+
+static const __FlashStringHelper* initSetupCmd(uint8_t step)
+{
+	switch (step)
+	{
+		case 0: return F("ATE0");				// disable echo of commands
+		case 1: return F("AT+CWMODE=1");		// set station mode
+		case 2: return F("AT+CIPMUX=1");		// set multiple connections mode
+		case 3: return F("AT+CIPDINFO=1");		// show remote IP and port with "+IPD"
+		case 4: return F("AT+CWAUTOCONN=0");	// disable autoconnect
+		default: return F("AT+CWDHCP=1,1");		// enable DHCP
+	}
+}
+
+
+uint8_t EspDrv::wifiDriverInitPoll()
+{
+	unsigned long elapsed = millis() - _initMillis;
+	int tag;
+
+	switch (_initState)
+	{
+	case INIT_PROBE:
+		tag = pollCmd();
+		if (tag == TAG_OK)
+		{
+			startCmd(F("AT+RST"));
+			nextInitState(INIT_RESET);
+		}
+		else if (tag >= 0 or elapsed >= 250)
+		{
+			// asked again every 250 ms for up to 5 s - a module that has just been powered up answers within about half a second
+			if (++_initTries >= 20)
+			{
+				LOGERROR(F("Cannot initialize ESP module"));
+				nextInitState(INIT_FAILED);
+			}
+			else
+			{
+				startCmd(F("AT"));
+				nextInitState(INIT_PROBE);
+			}
+		}
+		break;
+
+	case INIT_RESET:
+		// the module answers OK, restarts and prints "ready" - usually well within the 3 s fallback
+		if (pollCmd("ready\r\n", false) >= 0 or elapsed >= 3000)
+		{
+			espEmptyBuf(false);  // empty dirty characters from the buffer
+			_initStep = 0;
+			startCmd(initSetupCmd(_initStep));
+			nextInitState(INIT_SETUP);
+		}
+		break;
+
+	case INIT_SETUP:
+		if (pollCmd() >= 0 or elapsed >= 1000)
+		{
+			if (++_initStep < NUMINITSETUP)
+			{
+				startCmd(initSetupCmd(_initStep));
+				nextInitState(INIT_SETUP);
+			}
+			else
+			{
+				// connect to access point, use CUR mode to avoid connection at boot
+				startCmd(F("AT+CWJAP_CUR=\"%s\",\"%s\""), _initSsid, _initPassphrase);
+				nextInitState(INIT_JOIN);
+			}
+		}
+		break;
+
+	case INIT_JOIN:
+		tag = pollCmd();
+		if (tag == TAG_OK)
+		{
+			LOGINFO1(F("Connected to"), _initSsid);
+			nextInitState(INIT_DONE);
+		}
+		else if (tag >= 0 or elapsed >= 20000)
+		{
+			LOGWARN1(F("Failed connecting to"), _initSsid);
+			nextInitState(INIT_JOIN_RETRY);
+		}
+		break;
+
+	case INIT_JOIN_RETRY:
+		if (espSerial->available())
+		{
+			espEmptyBuf(false);
+			nextInitState(INIT_JOIN_RETRY);		// wait for the module to go quiet
+		}
+		else if (elapsed >= 1000)
+		{
+			startCmd(F("AT+CWJAP_CUR=\"%s\",\"%s\""), _initSsid, _initPassphrase);
+			nextInitState(INIT_JOIN);
+		}
+		break;
+
+	case INIT_DONE:
+		return WL_CONNECTED;
+
+	case INIT_FAILED:
+		return WL_NO_SHIELD;
+	}
+
+	return WL_IDLE_STATUS;
+}
+
+
+void EspDrv::nextInitState(uint8_t state)
+{
+	_initState = state;
+	_initMillis = millis();
+}
+
+
 void EspDrv::reset()
 {
 	LOGDEBUG(F("> reset"));
 
 	sendCmd(F("AT+RST"));
-	delay(3000);
+	readUntil(3000, "ready\r\n", false);  // the module prints "ready" once it has restarted
 	espEmptyBuf(false);  // empty dirty characters from the buffer
 
 	// disable echo of commands
@@ -124,7 +275,6 @@ void EspDrv::reset()
 
 	// set station mode
 	sendCmd(F("AT+CWMODE=1"));
-	delay(200);
 
 	// set multiple connections mode
 	sendCmd(F("AT+CIPMUX=1"));
@@ -138,7 +288,6 @@ void EspDrv::reset()
 
 	// enable DHCP
 	sendCmd(F("AT+CWDHCP=1,1"));
-	delay(200);
 }
 
 
@@ -163,8 +312,7 @@ bool EspDrv::wifiConnect(const char* ssid, const char* passphrase)
 	LOGWARN1(F("Failed connecting to"), ssid);
 
 	// clean additional messages logged after the FAIL tag
-	delay(1000);
-	espEmptyBuf(false);
+	espDrainBuf(200, 1000);
 
 	return false;
 }
@@ -213,8 +361,7 @@ int8_t EspDrv::disconnect()
 		return WL_DISCONNECTED;
 
 	// wait and clear any additional message
-	delay(2000);
-	espEmptyBuf(false);
+	espDrainBuf(200, 2000);
 
 	return WL_DISCONNECTED;
 }
@@ -223,17 +370,13 @@ void EspDrv::config(IPAddress ip)
 {
 	LOGDEBUG(F("> config"));
 
-	// disable station DHCP
+	// disable station DHCP - sendCmd() waits for the module's OK
 	sendCmd(F("AT+CWDHCP_CUR=1,0"));
 	
-	// it seems we need to wait here...
-	delay(500);
-	
 	char buf[16];
 	sprintf_P(buf, PSTR("%d.%d.%d.%d"), ip[0], ip[1], ip[2], ip[3]);
 
 	int ret = sendCmd(F("AT+CIPSTA_CUR=\"%s\""), 2000, buf);
-	delay(500);
 
 	if (ret==TAG_OK)
 	{
@@ -247,17 +390,13 @@ void EspDrv::configAP(IPAddress ip)
 	
     sendCmd(F("AT+CWMODE_CUR=2"));
 	
-	// disable station DHCP
+	// disable station DHCP - sendCmd() waits for the module's OK
 	sendCmd(F("AT+CWDHCP_CUR=2,0"));
 	
-	// it seems we need to wait here...
-	delay(500);
-	
 	char buf[16];
 	sprintf_P(buf, PSTR("%d.%d.%d.%d"), ip[0], ip[1], ip[2], ip[3]);
 
 	int ret = sendCmd(F("AT+CIPAP_CUR=\"%s\""), 2000, buf);
-	delay(500);
 
 	if (ret==TAG_OK)
 	{
@@ -1088,6 +1227,60 @@ int EspDrv::readUntil(int timeout, const char* tag, bool findTags)
 }
 
 
+/*
+* Sends the AT command and returns without waiting for the reply - see pollCmd().
+* The additional arguments are formatted into the command using sprintf.
+*/
+void EspDrv::startCmd(const __FlashStringHelper* cmd, ...)
+{
+	char cmdBuf[CMD_BUFFER_SIZE];
+
+	va_list args;
+	va_start (args, cmd);
+	vsnprintf_P (cmdBuf, CMD_BUFFER_SIZE, (char*)cmd, args);
+	va_end (args);
+
+	espEmptyBuf();
+	ringBuf.reset();
+
+	LOGDEBUG(F("----------------------------------------------"));
+	LOGDEBUG1(F(">>"), cmdBuf);
+
+	espSerial->println(cmdBuf);
+}
+
+
+// Reads whatever has arrived since the last call, without waiting
+// Returns:
+//   the index of the tag found (as readUntil)
+//   -1 if no tag has been found yet
+int EspDrv::pollCmd(const char* tag, bool findTags)
+{
+	while (espSerial->available())
+	{
+		char c = (char)espSerial->read();
+		LOGDEBUG0(c);
+		ringBuf.push(c);
+
+		if (tag!=NULL and ringBuf.endsWith(tag))
+		{
+			return NUMESPTAGS;
+		}
+		if (findTags)
+		{
+			for(int i=0; i<NUMESPTAGS; i++)
+			{
+				if (ringBuf.endsWith(ESPTAGS[i]))
+				{
+					return i;
+				}
+			}
+		}
+	}
+	return -1;
+}
+
+
 void EspDrv::espEmptyBuf(bool warn)
 {
     char c;
@@ -1107,6 +1300,23 @@ void EspDrv::espEmptyBuf(bool warn)
 }
 
 
+// Discards characters until none has arrived for quiet ms, or timeout ms have passed
+void EspDrv::espDrainBuf(int quiet, int timeout)
+{
+	unsigned long start = millis();
+	unsigned long last = start;
+
+	while ((millis() - last < quiet) and (millis() - start < timeout))
+	{
+		if (espSerial->available())
+		{
+			espSerial->read();
+			last = millis();
+		}
+	}
+}
+
+
 // copied from Serial::timedRead
 int EspDrv::timedRead()
 {
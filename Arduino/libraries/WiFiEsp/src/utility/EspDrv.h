@@ -122,6 +122,19 @@ public:
 
     static void wifiDriverInit(Stream *espSerial);
 
+    /* Non-blocking wifiDriverInit() followed by wifiConnect()
+     *
+     * wifiDriverInitStart() sends the first AT command and returns at once.
+     * Call wifiDriverInitPoll() often until it returns WL_CONNECTED (or WL_NO_SHIELD
+     * if the module never answered); no other EspDrv call may be made before then.
+     * Each step goes on as soon as the module replies - timeouts are only fallbacks.
+     *
+     * param ssid, passphrase: kept, not copied - must stay valid until init is done.
+     * return: WL_IDLE_STATUS while busy, WL_CONNECTED or WL_NO_SHIELD
+     */
+    static void wifiDriverInitStart(Stream *espSerial, const char* ssid, const char* passphrase);
+    static uint8_t wifiDriverInitPoll();
+
 
     /* Start Wifi connection with passphrase
      *
@@ -314,6 +327,14 @@ private:
 	// the ring buffer is used to search the tags in the stream
 	static RingBuffer ringBuf;
 
+	// state of the non-blocking init
+	static uint8_t _initState;
+	static uint8_t _initStep;
+	static uint8_t _initTries;
+	static unsigned long _initMillis;
+	static const char* _initSsid;
+	static const char* _initPassphrase;
+
 
 	//static int sendCmd(const char* cmd, int timeout=1000);
 	static int sendCmd(const __FlashStringHelper* cmd, int timeout=1000);
@@ -324,7 +345,12 @@ private:
 
 	static int readUntil(int timeout, const char* tag=NULL, bool findTags=true);
 
+	static void startCmd(const __FlashStringHelper* cmd, ...);
+	static int pollCmd(const char* tag=NULL, bool findTags=true);
+	static void nextInitState(uint8_t state);
+
 	static void espEmptyBuf(bool warn=true);
+	static void espDrainBuf(int quiet, int timeout);
 
 	static int timedRead();
 
@@ -49,6 +49,8 @@
  *    2020-06-09  Dan Ogorchock  Improved HubDuino board 'Presence' logic
  *    2020-06-25  Dan Ogorchock  Added Window Shade
  *    2020-09-19  Dan Ogorchock  Added "Releasable Button" Capability (requires new Arduino IS_Button.cpp and .h code)
+ *    2026-10-16  a00889920      Parse multi-line message bodies (one "name value" event per line) sent by batching Arduinos
+ *    2026-10-16  a00889920      Accept UDP datagrams from Arduinos using st::DatagramLink - acknowledge them and ignore resends
  *	
  */
  
@@ -90,8 +92,113 @@ def parse(String description) {
         //log.debug "headerstring was null for some reason :("
     }
 
+    if (msg.payload) {
+        //UDP datagram from an Arduino using st::DatagramLink (SmartThingsEthernet::setDatagramLink)
+        return parseDatagram(new String(hubitat.helper.HexUtils.hexStringToByteArray(msg.payload)), mac)
+    }
+
     def bodyString = msg.body
 
+    if (bodyString) {
+        //several "name value" lines may arrive in one message when batching is enabled on the Arduino (SmartThings::setMaxBatchSize)
+        def results = []
+        bodyString.split("\n").each { line ->
+            def result = parseLine(line.trim(), mac)
+            if (result instanceof List) {
+                results.addAll(result)
+            }
+            else if (result) {
+                results << result
+            }
+        }
+        return results
+    }
+}
+
+//true if sequence number a is at or before b, allowing for the 16 bit sequence number wrapping around
+private seqAtOrBefore(a, b) {
+    return ((b - a) & 0xFFFF) < 0x8000
+}
+
+// datagram = "#<session>:<seq>" line, then one "name value" event per line
+private parseDatagram(String datagram, mac) {
+    def lines = datagram.split("\n")
+    def header = (lines[0] =~ /^#(\d+):(\d+)$/)
+    if (!header.matches()) {
+        log.warn "Ignoring malformed datagram from HubDuino: ${lines[0]}"
+        return
+    }
+    def session = header.group(1).toInteger()
+    def seq = header.group(2).toInteger()
+
+    if (state.udpSession != session) {
+        //the Arduino has restarted - its sequence numbers start again from 1
+        state.udpSession = session
+        state.udpCumulative = 0
+        state.udpReceived = []
+    }
+    def cumulative = state.udpCumulative
+    def received = state.udpReceived ?: []
+
+    def isNew = !seqAtOrBefore(seq, cumulative) && !received.contains(seq)
+    if (isNew) {
+        received << seq
+        if (received.size() > 16) {
+            //the Arduino gave up on a datagram - stop waiting for it
+            cumulative = (received.min { (it - cumulative) & 0xFFFF } - 1) & 0xFFFF
+        }
+        while (received.contains((cumulative + 1) & 0xFFFF)) {
+            cumulative = (cumulative + 1) & 0xFFFF
+            received.remove((Object) cumulative)
+        }
+        state.udpCumulative = cumulative
+        state.udpReceived = received
+    }
+
+    //acknowledge even a resend - the Arduino resends until it hears an acknowledgement
+    sendDatagramAck(session, cumulative, received)
+
+    if (!isNew) {
+        if (logEnable) log.debug "Ignoring resent datagram ${session}:${seq}"
+        return
+    }
+
+    def results = []
+    lines.drop(1).each { line ->
+        def result = parseLine(line.trim(), mac)
+        if (result instanceof List) {
+            results.addAll(result)
+        }
+        else if (result) {
+            results << result
+        }
+    }
+    return results
+}
+
+// ack = "ack <session> <cumulative> <first>-<last>...", naming the datagrams received beyond the cumulative one
+private sendDatagramAck(session, cumulative, received) {
+    def ack = "ack ${session} ${cumulative}"
+    def ranges = 0
+    def first = null
+    def last = null
+    received.sort { (it - cumulative) & 0xFFFF }.each { seq ->
+        if ((first != null) && (seq == ((last + 1) & 0xFFFF))) {
+            last = seq
+        }
+        else {
+            if ((first != null) && (ranges++ < 4)) ack += " ${first}-${last}"
+            first = seq
+            last = seq
+        }
+    }
+    if ((first != null) && (ranges < 4)) ack += " ${first}-${last}"
+
+    if (logEnable) log.debug "Sending datagram acknowledgement '${ack}'"
+    sendHubCommand(new hubitat.device.HubAction(ack, hubitat.device.Protocol.LAN, [type: hubitat.device.HubAction.Type.LAN_TYPE_UDPCLIENT, destinationAddress: getHostAddress(), ignoreResponse: true]))
+}
+
+private parseLine(String bodyString, mac) {
     if (bodyString) {
         if (logEnable) log.debug "msg= $bodyString"
     	def parts = bodyString.split(" ")
@@ -46,6 +46,7 @@
  *    2020-06-09  Dan Ogorchock  Improved HubDuino board 'Presence' logic
  *    2020-06-25  Dan Ogorchock  Added Window Shade
  *    2020-09-19  Dan Ogorchock  Added "Releasable Button" Capability (requires new Arduino IS_Button.cpp and .h code)
+ *    2026-10-16  a00889920      Parse multi-line messages (one "name value" event per line) sent by batching Arduinos
  *	
  */
  
@@ -79,6 +80,24 @@ def logsOff(){
 def parse(String description) {
     if (logEnable) log.debug "description= '${description}'"
 	def msg = parseThingShield(description)
+
+    if (msg) {
+        //several "name value" lines may arrive in one ZigBee message when batching is enabled on the Arduino (SmartThings::setMaxBatchSize)
+        def results = []
+        msg.split("\n").each { line ->
+            def result = parseLine(line.trim())
+            if (result instanceof List) {
+                results.addAll(result)
+            }
+            else if (result) {
+                results << result
+            }
+        }
+        return results
+    }
+}
+
+private parseLine(String msg) {
 	def parts = []
     def name = ""
     def value = ""
@@ -48,6 +48,7 @@
  *    2020-09-24  Dan Ogorchock  Modified to have child devices work better with 'New' ST App
  *    2020-12-11  Dan Ogorchock  Added Window Shade
  *    2021-01-14  Andrew Alsup   Improved support for the 'New" SmartThings Mobile App!  Thank you!
+ *    2026-10-16  a00889920      Parse multi-line message bodies (one "name value" event per line) sent by batching Arduinos
  *
  *	
  */
@@ -93,6 +94,23 @@ def parse(String description) {
 
 	def bodyString = msg.body
 
+	if (bodyString) {
+        //several "name value" lines may arrive in one message when batching is enabled on the Arduino (SmartThings::setMaxBatchSize)
+        def results = []
+        bodyString.split("\n").each { line ->
+            def result = parseLine(line.trim())
+            if (result instanceof List) {
+                results.addAll(result)
+            }
+            else if (result) {
+                results << result
+            }
+        }
+        return results
+	}
+}
+
+private parseLine(String bodyString) {
 	if (bodyString) {
         log.debug "Parsing: $bodyString"
     	def parts = bodyString.split(" ")
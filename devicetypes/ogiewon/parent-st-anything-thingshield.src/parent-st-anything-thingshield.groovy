@@ -33,6 +33,7 @@
  *    2019-10-31  Dan Ogorchock  Added Child Valve
  *    2020-05-16  Dan Ogorchock  Added support for Sound Pressure Level device
  *    2020-09-24  Dan Ogorchock  Modified to have child devices work better with 'New' ST App
+ *    2026-10-16  a00889920      Parse multi-line messages (one "name value" event per line) sent by batching Arduinos
  *	
  */
  
@@ -76,6 +77,24 @@ metadata {
 def parse(String description) {
 	//log.debug "Parsing '${description}'"
     def msg = zigbee.parse(description)?.text
+
+    if (msg) {
+        //several "name value" lines may arrive in one ZigBee message when batching is enabled on the Arduino (SmartThings::setMaxBatchSize)
+        def results = []
+        msg.split("\n").each { line ->
+            def result = parseLine(line.trim())
+            if (result instanceof List) {
+                results.addAll(result)
+            }
+            else if (result) {
+                results << result
+            }
+        }
+        return results
+    }
+}
+
+private parseLine(String msg) {
 	def parts = []
     def name = ""
     def value = ""